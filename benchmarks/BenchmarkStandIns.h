@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCHMARKSTANDINS_H
+#define BENCHMARKSTANDINS_H
+
+#include "core/connectivity/ConnectivityService.h"
+#include "core/model/ActuatorStatus.h"
+#include "core/model/Alarm.h"
+#include "core/model/ConfigurationItem.h"
+#include "core/model/Message.h"
+#include "core/model/SensorReading.h"
+#include "core/persistence/Persistence.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+namespace benchmark
+{
+/**
+ * @brief Accepts every message without sending it, counting messages and payload bytes
+ */
+class CountingConnectivityService : public ConnectivityService
+{
+public:
+    CountingConnectivityService() : m_messages{0}, m_bytes{0} {}
+
+    bool connect() override { return true; }
+    void disconnect() override {}
+
+    bool reconnect() override { return true; }
+
+    bool isConnected() override { return true; }
+
+    bool publish(std::shared_ptr<Message> message, bool /* persistent */) override
+    {
+        ++m_messages;
+        m_bytes += message->getContent().size();
+        return true;
+    }
+
+    void setUncontrolledDisonnectMessage(std::shared_ptr<Message> /* outboundMessage */,
+                                         bool /* persistent */) override
+    {
+    }
+
+    std::uint64_t getMessages() const { return m_messages; }
+
+    std::uint64_t getBytes() const { return m_bytes; }
+
+private:
+    std::atomic<std::uint64_t> m_messages;
+    std::atomic<std::uint64_t> m_bytes;
+};
+
+/**
+ * @brief Accepts and discards everything, so that only cost of the caller is measured
+ */
+class DiscardingPersistence : public Persistence
+{
+public:
+    bool putSensorReading(const std::string&, std::shared_ptr<SensorReading>) override { return true; }
+    std::vector<std::shared_ptr<SensorReading>> getSensorReadings(const std::string&, std::uint_fast64_t) override
+    {
+        return {};
+    }
+    void removeSensorReadings(const std::string&, std::uint_fast64_t) override {}
+    std::vector<std::string> getSensorReadingsKeys() override { return {}; }
+
+    bool putAlarm(const std::string&, std::shared_ptr<Alarm>) override { return true; }
+    std::vector<std::shared_ptr<Alarm>> getAlarms(const std::string&, std::uint_fast64_t) override { return {}; }
+    void removeAlarms(const std::string&, std::uint_fast64_t) override {}
+    std::vector<std::string> getAlarmsKeys() override { return {}; }
+
+    bool putActuatorStatus(const std::string&, std::shared_ptr<ActuatorStatus>) override { return true; }
+    std::shared_ptr<ActuatorStatus> getActuatorStatus(const std::string&) override { return nullptr; }
+    void removeActuatorStatus(const std::string&) override {}
+    std::vector<std::string> getActuatorStatusesKeys() override { return {}; }
+
+    bool putConfiguration(const std::string&, std::shared_ptr<std::vector<ConfigurationItem>>) override
+    {
+        return true;
+    }
+    std::shared_ptr<std::vector<ConfigurationItem>> getConfiguration(const std::string&) override { return nullptr; }
+    void removeConfiguration(const std::string&) override {}
+    std::vector<std::string> getConfigurationKeys() override { return {}; }
+
+    bool isEmpty() override { return true; }
+};
+
+/**
+ * @brief Counts down completed work items, so that benchmarks can wait for worker threads
+ */
+class Completion
+{
+public:
+    explicit Completion(long long count = 0) : m_remaining{count} {}
+
+    /**
+     * @brief Starts counting down anew, must not be called while other threads count down
+     */
+    void reset(long long count) { m_remaining = count; }
+
+    void countDown()
+    {
+        if (--m_remaining == 0)
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_done.notify_one();
+        }
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_done.wait(lock, [&] { return m_remaining <= 0; });
+    }
+
+private:
+    std::atomic<long long> m_remaining;
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+};
+}    // namespace benchmark
+}    // namespace wolkabout
+
+#endif    // BENCHMARKSTANDINS_H
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchmarkStandIns.h"
+#include "core/utilities/CommandBuffer.h"
+#include "utilities/CommandExecutor.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const long long COMMANDS_PER_PRODUCER = 1000;
+
+// each iteration producers push their commands concurrently, and ends when all of them are executed
+template <typename Push> void run(benchmark::State& state, Push push)
+{
+    const auto producersCount = state.range(0);
+
+    wolkabout::benchmark::Completion completion;
+
+    // payload mimics a typical Wolk command capture: this pointer, device key and reference
+    const std::string deviceKey = "DEVICE_KEY";
+    const std::string reference = "REF";
+
+    for (auto _ : state)
+    {
+        completion.reset(producersCount * COMMANDS_PER_PRODUCER);
+
+        std::vector<std::thread> producers;
+        for (long long i = 0; i < producersCount; ++i)
+        {
+            producers.emplace_back([&] {
+                for (long long j = 0; j < COMMANDS_PER_PRODUCER; ++j)
+                {
+                    push([&completion, deviceKey, reference] {
+                        if (!deviceKey.empty() && !reference.empty())
+                        {
+                            completion.countDown();
+                        }
+                    });
+                }
+            });
+        }
+
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        completion.wait();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * producersCount * COMMANDS_PER_PRODUCER);
+}
+
+void commandBuffer(benchmark::State& state)
+{
+    wolkabout::CommandBuffer commandBuffer;
+    run(state, [&](std::function<void()> command) {
+        commandBuffer.pushCommand(std::make_shared<std::function<void()>>(command));
+    });
+    commandBuffer.stop();
+}
+
+void commandExecutorPush(benchmark::State& state)
+{
+    wolkabout::CommandExecutor executor;
+    run(state, [&](wolkabout::Command command) { executor.push(std::move(command)); });
+}
+
+void commandExecutorTryPush(benchmark::State& state)
+{
+    wolkabout::CommandExecutor executor;
+    run(state, [&](wolkabout::Command command) {
+        while (!executor.tryPush(command))
+        {
+            std::this_thread::yield();
+        }
+    });
+}
+
+// work is done by producer and executor threads, so wall time is what matters
+const auto commandBufferRegistered = benchmark::RegisterBenchmark("CommandQueue/CommandBuffer", commandBuffer)
+                                       ->RangeMultiplier(2)
+                                       ->Range(1, 8)
+                                       ->UseRealTime();
+const auto pushRegistered = benchmark::RegisterBenchmark("CommandQueue/CommandExecutor::push", commandExecutorPush)
+                              ->RangeMultiplier(2)
+                              ->Range(1, 8)
+                              ->UseRealTime();
+const auto tryPushRegistered =
+  benchmark::RegisterBenchmark("CommandQueue/CommandExecutor::tryPush", commandExecutorTryPush)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+}    // namespace
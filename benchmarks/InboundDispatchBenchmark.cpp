@@ -0,0 +1,119 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchmarkStandIns.h"
+#include "InboundGatewayMessageHandler.h"
+#include "core/InboundMessageHandler.h"
+#include "core/model/Message.h"
+#include "core/protocol/Protocol.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+const unsigned int MESSAGES_PER_ITERATION = 1000;
+
+// subscribes to the same channels data protocol does for each device
+class DeviceChannelsProtocol : public wolkabout::Protocol
+{
+public:
+    explicit DeviceChannelsProtocol(long long devicesCount)
+    {
+        for (long long i = 0; i < devicesCount; ++i)
+        {
+            const auto channels = getInboundChannelsForDevice("DEVICE_KEY_" + std::to_string(i));
+            m_channels.insert(m_channels.end(), channels.begin(), channels.end());
+        }
+    }
+
+    std::vector<std::string> getInboundChannels() const override { return m_channels; }
+
+    std::vector<std::string> getInboundChannelsForDevice(const std::string& deviceKey) const override
+    {
+        return {"p2d/actuator_set/d/" + deviceKey + "/r/+", "p2d/actuator_get/d/" + deviceKey + "/r/+",
+                "p2d/configuration_set/d/" + deviceKey, "p2d/configuration_get/d/" + deviceKey};
+    }
+
+    std::string extractDeviceKeyFromChannel(const std::string& /* topic */) const override { return ""; }
+
+private:
+    std::vector<std::string> m_channels;
+};
+
+class CountingListener : public wolkabout::MessageListener
+{
+public:
+    CountingListener(const wolkabout::Protocol& protocol, wolkabout::benchmark::Completion& completion)
+    : m_protocol{protocol}, m_completion{completion}
+    {
+    }
+
+    void messageReceived(std::shared_ptr<wolkabout::Message> /* message */) override { m_completion.countDown(); }
+
+    const wolkabout::Protocol& getProtocol() override { return m_protocol; }
+
+private:
+    const wolkabout::Protocol& m_protocol;
+    wolkabout::benchmark::Completion& m_completion;
+};
+
+// each iteration times matching of inbound channels and handing messages over to listener on the command executor
+void dispatchInboundMessages(benchmark::State& state)
+{
+    const auto devicesCount = state.range(0);
+
+    std::vector<std::string> channels;
+    for (long long i = 0; i < devicesCount; ++i)
+    {
+        channels.push_back("p2d/actuator_set/d/DEVICE_KEY_" + std::to_string(i) + "/r/SWITCH");
+    }
+
+    const std::string payload = "{\"value\":\"true\"}";
+
+    const DeviceChannelsProtocol protocol{devicesCount};
+    wolkabout::benchmark::Completion completion;
+    const auto listener = std::make_shared<CountingListener>(protocol, completion);
+
+    wolkabout::InboundGatewayMessageHandler handler;
+    handler.addListener(listener);
+
+    for (auto _ : state)
+    {
+        completion.reset(MESSAGES_PER_ITERATION);
+
+        for (unsigned int i = 0; i < MESSAGES_PER_ITERATION; ++i)
+        {
+            handler.messageReceived(channels[i % channels.size()], payload);
+        }
+
+        completion.wait();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * MESSAGES_PER_ITERATION);
+}
+
+const auto registered =
+  benchmark::RegisterBenchmark("InboundGatewayMessageHandler/messageReceived", dispatchInboundMessages)
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1000)
+    ->UseRealTime();
+}    // namespace
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/model/SensorReading.h"
+#include "core/persistence/InMemoryPersistence.h"
+#include "core/persistence/Persistence.h"
+#include "persistence/RingBufferPersistence.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+const char* RING_BUFFER_FILE = "benchmarkPersistence.bin";
+
+const unsigned int KEYS_COUNT = 10;
+
+// each iteration puts a batch of readings under one key, and reads and removes them as publishing does
+void putGetRemoveSensorReadings(benchmark::State& state, wolkabout::Persistence& persistence)
+{
+    const auto batchSize = static_cast<std::uint_fast64_t>(state.range(0));
+
+    std::vector<std::string> keys;
+    for (unsigned int i = 0; i < KEYS_COUNT; ++i)
+    {
+        keys.push_back("DEVICE_KEY+REF" + std::to_string(i));
+    }
+
+    const auto sensorReading = std::make_shared<wolkabout::SensorReading>("23.5", "REF", 1546300800000);
+
+    unsigned int keyIndex = 0;
+    for (auto _ : state)
+    {
+        const std::string& key = keys[keyIndex++ % KEYS_COUNT];
+
+        for (std::uint_fast64_t j = 0; j < batchSize; ++j)
+        {
+            persistence.putSensorReading(key, sensorReading);
+        }
+
+        if (persistence.getSensorReadings(key, batchSize).size() != batchSize)
+        {
+            state.SkipWithError("Persistence lost readings");
+            break;
+        }
+
+        persistence.removeSensorReadings(key, batchSize);
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+
+void inMemoryPersistence(benchmark::State& state)
+{
+    wolkabout::InMemoryPersistence persistence;
+    putGetRemoveSensorReadings(state, persistence);
+}
+
+void ringBufferPersistence(benchmark::State& state)
+{
+    std::remove(RING_BUFFER_FILE);
+
+    {
+        wolkabout::RingBufferPersistence persistence{RING_BUFFER_FILE};
+        putGetRemoveSensorReadings(state, persistence);
+    }
+
+    std::remove(RING_BUFFER_FILE);
+}
+
+const auto inMemoryRegistered =
+  benchmark::RegisterBenchmark("InMemoryPersistence/sensorReadings", inMemoryPersistence)->Arg(1)->Arg(50);
+const auto ringBufferRegistered =
+  benchmark::RegisterBenchmark("RingBufferPersistence/sensorReadings", ringBufferPersistence)->Arg(1)->Arg(50);
+}    // namespace
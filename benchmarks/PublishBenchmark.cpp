@@ -0,0 +1,149 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchmarkStandIns.h"
+#include "core/persistence/InMemoryPersistence.h"
+#include "core/protocol/DataProtocol.h"
+#include "core/protocol/json/JsonProtocol.h"
+#include "protocol/json/PrecompiledJsonProtocol.h"
+#include "protocol/msgpack/MessagePackProtocol.h"
+#include "service/DataService.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+const unsigned int READINGS_PER_REFERENCE = 10;
+
+std::vector<std::string> makeNames(const std::string& prefix, long long count)
+{
+    std::vector<std::string> names;
+    for (long long i = 0; i < count; ++i)
+    {
+        names.push_back(prefix + std::to_string(i));
+    }
+
+    return names;
+}
+
+// each iteration persists readings of devices x references sensors untimed, and times publishing of all of them
+void publishSensorReadings(benchmark::State& state, wolkabout::DataProtocol& protocol,
+                           const wolkabout::SensorReadingsEnvelopeProtocol* envelopeProtocol = nullptr)
+{
+    const auto devicesCount = state.range(0);
+    const auto referencesCount = state.range(1);
+
+    const auto deviceKeys = makeNames("DEVICE_KEY_", devicesCount);
+    const auto references = makeNames("REF", referencesCount);
+
+    wolkabout::benchmark::CountingConnectivityService connectivityService;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+
+        wolkabout::InMemoryPersistence persistence;
+        wolkabout::DataService dataService{
+          protocol,
+          persistence,
+          connectivityService,
+          [](const std::string&, const std::string&, const std::string&, std::shared_ptr<wolkabout::ActuationTrace>) {},
+          [](const std::string&, const std::string&) {},
+          [](const std::string&, const std::vector<wolkabout::ConfigurationItem>&) {},
+          [](const std::string&) {}};
+
+        if (envelopeProtocol)
+        {
+            dataService.setSensorReadingsEnvelopes(*envelopeProtocol, true);
+        }
+
+        for (unsigned int j = 0; j < READINGS_PER_REFERENCE; ++j)
+        {
+            for (const auto& deviceKey : deviceKeys)
+            {
+                for (const auto& reference : references)
+                {
+                    dataService.addSensorReading(deviceKey, reference, wolkabout::ReadingValue{20.0 + j},
+                                                 1546300800000 + j);
+                }
+            }
+        }
+
+        state.ResumeTiming();
+
+        dataService.publishSensorReadings();
+
+        // drained persistence and service are destroyed untimed
+        state.PauseTiming();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * devicesCount * referencesCount *
+                            READINGS_PER_REFERENCE);
+    state.SetBytesProcessed(static_cast<std::int64_t>(connectivityService.getBytes()));
+}
+
+void publishJsonSensorReadings(benchmark::State& state)
+{
+    wolkabout::JsonProtocol protocol;
+    publishSensorReadings(state, protocol);
+}
+
+void publishPrecompiledJsonSensorReadings(benchmark::State& state)
+{
+    wolkabout::PrecompiledJsonProtocol protocol;
+    for (const auto& deviceKey : makeNames("DEVICE_KEY_", state.range(0)))
+    {
+        protocol.addSensors(deviceKey, makeNames("REF", state.range(1)));
+    }
+
+    publishSensorReadings(state, protocol);
+}
+
+void publishMessagePackSensorReadings(benchmark::State& state)
+{
+    wolkabout::MessagePackProtocol protocol;
+    publishSensorReadings(state, protocol);
+}
+
+void publishMessagePackSensorReadingsEnvelopes(benchmark::State& state)
+{
+    wolkabout::MessagePackProtocol protocol;
+    publishSensorReadings(state, protocol, &protocol);
+}
+
+void devicesAndReferences(benchmark::internal::Benchmark* family)
+{
+    family->Args({1, 1})->Args({1, 10})->Args({10, 10})->Args({100, 10});
+}
+
+const auto jsonRegistered =
+  benchmark::RegisterBenchmark("DataService/publishSensorReadings/json", publishJsonSensorReadings)
+    ->Apply(devicesAndReferences);
+const auto precompiledJsonRegistered =
+  benchmark::RegisterBenchmark("DataService/publishSensorReadings/json-precompiled",
+                               publishPrecompiledJsonSensorReadings)
+    ->Apply(devicesAndReferences);
+const auto messagePackRegistered =
+  benchmark::RegisterBenchmark("DataService/publishSensorReadings/msgpack", publishMessagePackSensorReadings)
+    ->Apply(devicesAndReferences);
+const auto envelopesRegistered = benchmark::RegisterBenchmark("DataService/publishSensorReadings/msgpack-envelopes",
+                                                              publishMessagePackSensorReadingsEnvelopes)
+                                   ->Apply(devicesAndReferences);
+}    // namespace
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BenchmarkStandIns.h"
+#include "Wolk.h"
+#include "core/model/DeviceTemplate.h"
+#include "core/model/SensorTemplate.h"
+#include "model/Device.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+const unsigned int REFERENCES_COUNT = 10;
+
+const unsigned int READINGS_PER_ITERATION = 1000;
+
+const unsigned long long int RTC = 1546300800000;
+
+// counts readings Wolk has handed over to persistence, and discards them
+class CountingPersistence : public wolkabout::benchmark::DiscardingPersistence
+{
+public:
+    explicit CountingPersistence(wolkabout::benchmark::Completion& completion) : m_completion{completion} {}
+
+    bool putSensorReading(const std::string&, std::shared_ptr<wolkabout::SensorReading>) override
+    {
+        m_completion.countDown();
+        return true;
+    }
+
+private:
+    wolkabout::benchmark::Completion& m_completion;
+};
+
+// each iteration adds readings through public Wolk API, and ends when all of them reach persistence
+template <typename Value> void addSensorReadings(benchmark::State& state, const Value& value)
+{
+    wolkabout::benchmark::Completion completion;
+
+    std::vector<std::string> references;
+    std::vector<wolkabout::SensorTemplate> sensors;
+    for (unsigned int i = 0; i < REFERENCES_COUNT; ++i)
+    {
+        references.push_back("REF" + std::to_string(i));
+        sensors.emplace_back(references.back(), references.back(), wolkabout::ReadingType::Name::TEMPERATURE,
+                             wolkabout::ReadingType::MeasurmentUnit::CELSIUS, "");
+    }
+
+    const std::string deviceKey = "DEVICE_KEY";
+
+    auto wolk =
+      wolkabout::Wolk::newBuilder()
+        .actuationHandler([](const std::string&, const std::string&, const std::string&) {})
+        .actuatorStatusProvider([](const std::string&, const std::string&) {
+            return wolkabout::ActuatorStatus("", wolkabout::ActuatorStatus::State::READY);
+        })
+        .deviceStatusProvider([](const std::string&) { return wolkabout::DeviceStatus::Status::CONNECTED; })
+        .withPersistence(std::unique_ptr<wolkabout::Persistence>(new CountingPersistence(completion)))
+        .build();
+
+    wolk->addDevice(wolkabout::Device{"DEVICE_NAME", deviceKey, wolkabout::DeviceTemplate{{}, sensors, {}, {}, ""}});
+
+    // device is added on the command executor, wait for it untimed
+    completion.reset(1);
+    wolk->addSensorReading(deviceKey, references[0], value, RTC);
+    completion.wait();
+
+    for (auto _ : state)
+    {
+        completion.reset(READINGS_PER_ITERATION);
+
+        for (unsigned int i = 0; i < READINGS_PER_ITERATION; ++i)
+        {
+            wolk->addSensorReading(deviceKey, references[i % REFERENCES_COUNT], value, RTC + i);
+        }
+
+        completion.wait();
+    }
+
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * READINGS_PER_ITERATION);
+}
+
+void addStringReadings(benchmark::State& state)
+{
+    addSensorReadings(state, std::string{"23.5"});
+}
+
+void addStringsReadings(benchmark::State& state)
+{
+    addSensorReadings(state, std::vector<std::string>{"1.5", "2.5", "3.5"});
+}
+
+void addBoolReadings(benchmark::State& state)
+{
+    addSensorReadings(state, true);
+}
+
+void addIntegerReadings(benchmark::State& state)
+{
+    addSensorReadings(state, -1234567);
+}
+
+void addDoubleReadings(benchmark::State& state)
+{
+    addSensorReadings(state, 23.456789);
+}
+
+void addDoublesReadings(benchmark::State& state)
+{
+    addSensorReadings(state, std::vector<double>{1.5, 2.5, 3.5});
+}
+
+// readings are handled on the command executor, so wall time is what matters
+const auto stringRegistered =
+  benchmark::RegisterBenchmark("Wolk/addSensorReading/string", addStringReadings)->UseRealTime();
+const auto stringsRegistered =
+  benchmark::RegisterBenchmark("Wolk/addSensorReading/strings", addStringsReadings)->UseRealTime();
+const auto boolRegistered = benchmark::RegisterBenchmark("Wolk/addSensorReading/bool", addBoolReadings)->UseRealTime();
+const auto integerRegistered =
+  benchmark::RegisterBenchmark("Wolk/addSensorReading/integer", addIntegerReadings)->UseRealTime();
+const auto doubleRegistered =
+  benchmark::RegisterBenchmark("Wolk/addSensorReading/double", addDoubleReadings)->UseRealTime();
+const auto doublesRegistered =
+  benchmark::RegisterBenchmark("Wolk/addSensorReading/doubles", addDoublesReadings)->UseRealTime();
+}    // namespace
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ASYNCACTUATORSTATUSPROVIDER_H
+#define ASYNCACTUATORSTATUSPROVIDER_H
+
+#include "core/model/ActuatorStatus.h"
+
+#include <functional>
+#include <string>
+
+namespace wolkabout
+{
+class AsyncActuatorStatusProvider
+{
+public:
+    /**
+     * @brief Asynchronous actuator status provider callback<br>
+     *        Starts reading of actuator status and returns without waiting for it<br>
+     *        Must be implemented as thread safe
+     * @param deviceKey Device key
+     * @param reference Actuator reference
+     * @param onStatus Should be called once with ActuatorStatus of requested actuator<br>
+     *                 Can be called from any thread, also after Wolk instance is destroyed,
+     *                 in which case it is ignored<br>
+     *                 Calls after the first one are ignored
+     *                 If it is never called, statuses of other actuators read along with it
+     *                 are published with the next publish of actuator statuses
+     */
+    virtual void getActuatorStatus(const std::string& deviceKey, const std::string& reference,
+                                   std::function<void(ActuatorStatus)> onStatus) = 0;
+
+    virtual ~AsyncActuatorStatusProvider() = default;
+};
+}    // namespace wolkabout
+
+#endif    // ASYNCACTUATORSTATUSPROVIDER_H
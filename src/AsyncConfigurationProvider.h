@@ -0,0 +1,48 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ASYNCCONFIGURATIONPROVIDER_H
+#define ASYNCCONFIGURATIONPROVIDER_H
+
+#include "core/model/ConfigurationItem.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+class AsyncConfigurationProvider
+{
+public:
+    /**
+     * @brief Asynchronous device configuration provider callback<br>
+     *        Starts reading of device configuration and returns without waiting for it<br>
+     *        Must be implemented as thread safe
+     * @param deviceKey Device key
+     * @param onConfiguration Should be called once with device configuration<br>
+     *                        Can be called from any thread, also after Wolk instance is destroyed,
+     *                        in which case it is ignored<br>
+     *                        Calls after the first one are ignored
+     */
+    virtual void getConfiguration(const std::string& deviceKey,
+                                  std::function<void(std::vector<ConfigurationItem>)> onConfiguration) = 0;
+
+    virtual ~AsyncConfigurationProvider() = default;
+};
+}    // namespace wolkabout
+
+#endif    // ASYNCCONFIGURATIONPROVIDER_H
@@ -19,43 +19,66 @@
 #include "core/model/Message.h"
 #include "core/protocol/Protocol.h"
 #include "core/utilities/Logger.h"
-#include "core/utilities/StringUtils.h"
 
-#include <algorithm>
+#include <chrono>
+#include <utility>
 
 namespace wolkabout
 {
-InboundGatewayMessageHandler::InboundGatewayMessageHandler() : m_commandBuffer{new CommandBuffer()} {}
+InboundGatewayMessageHandler::InboundGatewayMessageHandler()
+: m_commandExecutor{new CommandExecutor()}
+, m_channelHandlersTrie{new ChannelHandlersTrie()}
+, m_messagesReceived{nullptr}
+, m_messagesUnhandled{nullptr}
+, m_dispatchLatency{nullptr}
+{
+}
 
 InboundGatewayMessageHandler::~InboundGatewayMessageHandler()
 {
-    m_commandBuffer->stop();
+    m_commandExecutor->stop();
 }
 
 void InboundGatewayMessageHandler::messageReceived(const std::string& channel, const std::string& payload)
 {
     LOG(DEBUG) << "Message received on channel: '" << channel << "' : '" << payload << "'";
 
-    std::lock_guard<std::mutex> lg{m_lock};
+    if (m_messagesReceived)
+    {
+        m_messagesReceived->increment();
+    }
 
-    auto it = std::find_if(m_channelHandlers.begin(), m_channelHandlers.end(),
-                           [&](const std::pair<std::string, std::weak_ptr<MessageListener>>& kvp) {
-                               return StringUtils::mqttTopicMatch(kvp.first, channel);
-                           });
+    const auto channelHandlers = std::atomic_load(&m_channelHandlersTrie);
 
-    if (it != m_channelHandlers.end())
+    if (const auto listener = channelHandlers->match(channel))
     {
-        auto channelHandler = it->second;
-        addToCommandBuffer([=] {
+        // the only copy of payload, command and handler share the message
+        auto message = std::make_shared<Message>(payload, channel);
+        auto channelHandler = *listener;
+
+        const auto dispatchLatency = m_dispatchLatency;
+        const auto received = std::chrono::steady_clock::now();
+
+        addToCommandBuffer([channelHandler, message, dispatchLatency, received] {
+            if (dispatchLatency)
+            {
+                dispatchLatency->recordSince(received);
+            }
+
             if (auto handler = channelHandler.lock())
             {
-                handler->messageReceived(std::make_shared<Message>(payload, channel));
+                handler->messageReceived(message);
             }
         });
     }
     else
     {
         LOG(WARN) << "Handler for device channel not found: " << channel;
+
+        if (m_messagesUnhandled)
+        {
+            m_messagesUnhandled->increment();
+        }
     }
 }
 
@@ -77,10 +100,32 @@ void InboundGatewayMessageHandler::addListener(std::weak_ptr<MessageListener> li
             m_subscriptionList.push_back(channel);
         }
     }
+
+    std::shared_ptr<ChannelHandlersTrie> channelHandlers{new ChannelHandlersTrie()};
+    for (const auto& channelHandler : m_channelHandlers)
+    {
+        channelHandlers->insert(channelHandler.first, channelHandler.second);
+    }
+
+    std::atomic_store(&m_channelHandlersTrie, std::shared_ptr<const ChannelHandlersTrie>{std::move(channelHandlers)});
+}
+
+void InboundGatewayMessageHandler::setMetrics(MetricsRegistry& metrics)
+{
+    m_messagesReceived = &metrics.counter("inbound.messages.received");
+    m_messagesUnhandled = &metrics.counter("inbound.messages.unhandled");
+    m_dispatchLatency = &metrics.histogram("inbound.dispatch_latency_us");
+}
+
+std::size_t InboundGatewayMessageHandler::getQueuedMessagesCount() const
+{
+    return m_commandExecutor->size();
 }
 
-void InboundGatewayMessageHandler::addToCommandBuffer(std::function<void()> command)
+void InboundGatewayMessageHandler::addToCommandBuffer(Command command)
 {
-    m_commandBuffer->pushCommand(std::make_shared<std::function<void()>>(command));
+    // messages are received on connectivity callback thread, which must never wait, publish acknowledgements
+    // that listeners may be waiting on are delivered on it
+    m_commandExecutor->pushUnbounded(std::move(command));
 }
 }    // namespace wolkabout
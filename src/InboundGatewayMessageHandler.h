@@ -18,8 +18,11 @@
 #define INBOUNDGATEWAYMESSAGEHANDLER_H
 
 #include "core/InboundMessageHandler.h"
-#include "core/utilities/CommandBuffer.h"
+#include "utilities/CommandExecutor.h"
+#include "utilities/MetricsRegistry.h"
+#include "utilities/TopicTrie.h"
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -40,16 +43,36 @@ public:
 
     void addListener(std::weak_ptr<MessageListener> listener) override;
 
+    /**
+     * @brief Enables metrics of received messages, and of time they wait for their listener<br>
+     *        Must be called before messages are received
+     */
+    void setMetrics(MetricsRegistry& metrics);
+
+    /**
+     * @brief Number of received messages waiting for their listener
+     */
+    std::size_t getQueuedMessagesCount() const;
+
 private:
-    void addToCommandBuffer(std::function<void()> command);
+    typedef TopicTrie<std::weak_ptr<MessageListener>> ChannelHandlersTrie;
+
+    void addToCommandBuffer(Command command);
 
-    std::unique_ptr<CommandBuffer> m_commandBuffer;
+    std::unique_ptr<CommandExecutor> m_commandExecutor;
 
     std::vector<std::string> m_subscriptionList;
 
     std::map<std::string, std::weak_ptr<MessageListener>> m_channelHandlers;
 
+    // rebuilt from m_channelHandlers on each change, and swapped atomically so dispatch does not lock
+    std::shared_ptr<const ChannelHandlersTrie> m_channelHandlersTrie;
+
     mutable std::mutex m_lock;
+
+    Counter* m_messagesReceived;
+    Counter* m_messagesUnhandled;
+    LatencyHistogram* m_dispatchLatency;
 };
 }    // namespace wolkabout
 
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACESINK_H
+#define TRACESINK_H
+
+#include "model/ActuationTrace.h"
+
+namespace wolkabout
+{
+class TraceSink
+{
+public:
+    virtual ~TraceSink() = default;
+
+    /**
+     * @brief Receives finished trace
+     *
+     * Called from Wolk command thread, so this call needs to return as quickly as possible
+     *
+     * @param trace Finished trace
+     */
+    virtual void consume(const ActuationTrace& trace) = 0;
+};
+}    // namespace wolkabout
+
+#endif    // TRACESINK_H
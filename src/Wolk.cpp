@@ -30,6 +30,7 @@
 #include "core/utilities/Logger.h"
 #include "core/utilities/StringUtils.h"
 #include "model/Device.h"
+#include "protocol/json/PrecompiledJsonProtocol.h"
 #include "service/DataService.h"
 #include "service/DeviceRegistrationService.h"
 #include "service/DeviceStatusService.h"
@@ -43,126 +44,282 @@
 #include <utility>
 
 #define INSTANTIATE_ADD_SENSOR_READING_FOR(x)                                                                    \
-    template void Wolk::addSensorReading<x>(const std::string& deviceKey, const std::string& reference, x value, \
+    template bool Wolk::addSensorReading<x>(const std::string& deviceKey, const std::string& reference, x value, \
                                             unsigned long long rtc);                                             \
-    template void Wolk::addSensorReading<x>(const std::string& deviceKey, const std::string& reference,          \
+    template bool Wolk::addSensorReading<x>(const std::string& deviceKey, const std::string& reference,          \
                                             std::initializer_list<x> value, unsigned long long int rtc);         \
-    template void Wolk::addSensorReading<x>(const std::string& deviceKey, const std::string& reference,          \
+    template bool Wolk::addSensorReading<x>(const std::string& deviceKey, const std::string& reference,          \
                                             const std::vector<x> values, unsigned long long int rtc)
 
 namespace wolkabout
 {
+const constexpr unsigned int Wolk::OVERLOAD_POLL_INTERVAL_MS;
+const constexpr unsigned int Wolk::INITIAL_RECONNECT_DELAY_MS;
+const constexpr unsigned int Wolk::MAX_RECONNECT_DELAY_MS;
+
 WolkBuilder Wolk::newBuilder()
 {
     return WolkBuilder();
 }
 
-template <>
-void Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference, std::string value,
-                            unsigned long long rtc)
+template <typename T>
+bool Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference, T value, unsigned long long rtc)
 {
-    addToCommandBuffer([=]() -> void {
-        if (!deviceExists(deviceKey))
+    return addSensorReadingValue(deviceKey, reference, ReadingValue(value), rtc);
+}
+
+template <typename T>
+bool Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference, std::initializer_list<T> values,
+                            unsigned long long int rtc)
+{
+    return addSensorReadingValues(deviceKey, reference, std::vector<ReadingValue>(values.begin(), values.end()), rtc);
+}
+
+template <typename T>
+bool Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference, const std::vector<T> values,
+                            unsigned long long int rtc)
+{
+    return addSensorReadingValues(deviceKey, reference, std::vector<ReadingValue>(values.begin(), values.end()), rtc);
+}
+
+INSTANTIATE_ADD_SENSOR_READING_FOR(std::string);
+INSTANTIATE_ADD_SENSOR_READING_FOR(const char*);
+INSTANTIATE_ADD_SENSOR_READING_FOR(char*);
+INSTANTIATE_ADD_SENSOR_READING_FOR(bool);
+INSTANTIATE_ADD_SENSOR_READING_FOR(float);
+INSTANTIATE_ADD_SENSOR_READING_FOR(double);
+INSTANTIATE_ADD_SENSOR_READING_FOR(signed int);
+INSTANTIATE_ADD_SENSOR_READING_FOR(signed long int);
+INSTANTIATE_ADD_SENSOR_READING_FOR(signed long long int);
+INSTANTIATE_ADD_SENSOR_READING_FOR(unsigned int);
+INSTANTIATE_ADD_SENSOR_READING_FOR(unsigned long int);
+INSTANTIATE_ADD_SENSOR_READING_FOR(unsigned long long int);
+
+struct Wolk::SensorReadingCommand
+{
+    Wolk* wolk;
+    std::string deviceKey;
+    std::string reference;
+    ReadingValue value;
+    unsigned long long int rtc;
+    bool dropOldest;
+
+    void operator()()
+    {
+        if (!wolk->deviceExists(deviceKey))
         {
             LOG(ERROR) << "Device does not exist: " << deviceKey;
             return;
         }
 
-        if (!sensorDefinedForDevice(deviceKey, reference))
+        if (!wolk->sensorDefinedForDevice(deviceKey, reference))
         {
             LOG(ERROR) << "Sensor does not exist for device: " << deviceKey << ", " << reference;
             return;
         }
 
-        m_dataService->addSensorReading(deviceKey, reference, value, rtc != 0 ? rtc : Wolk::currentRtc());
-    });
-}
+        if (dropOldest)
+        {
+            wolk->m_dataService->dropOldestSensorReading(deviceKey, reference);
+        }
 
-template <typename T>
-void Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference, T value, unsigned long long rtc)
-{
-    addSensorReading(deviceKey, reference, StringUtils::toString(value), rtc);
-}
+        wolk->m_dataService->addSensorReading(deviceKey, reference, value, rtc != 0 ? rtc : Wolk::currentRtc());
+    }
+};
 
-template <>
-void Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference,
-                            const std::vector<std::string> values, unsigned long long int rtc)
+bool Wolk::addSensorReadingValue(const std::string& deviceKey, const std::string& reference, ReadingValue value,
+                                 unsigned long long int rtc)
 {
-    if (values.empty())
+    const auto admission = admitSensorReading(deviceKey, reference);
+    if (admission == Admission::REJECT)
     {
-        return;
+        return false;
     }
 
-    addToCommandBuffer([=]() -> void {
-        if (!deviceExists(deviceKey))
+    const bool dropOldest = admission == Admission::ACCEPT_DROPPING_OLDEST;
+
+    static_assert(Command::fitsInline<SensorReadingCommand>(), "Sensor reading command must not allocate");
+    addToCommandBuffer(SensorReadingCommand{this, deviceKey, reference, std::move(value), rtc, dropOldest});
+
+    return true;
+}
+
+struct Wolk::SensorReadingValuesCommand
+{
+    Wolk* wolk;
+    std::string deviceKey;
+    std::string reference;
+    std::shared_ptr<std::vector<ReadingValue>> values;
+    unsigned long long int rtc;
+    bool dropOldest;
+
+    void operator()()
+    {
+        if (!wolk->deviceExists(deviceKey))
         {
             LOG(ERROR) << "Device does not exist: " << deviceKey;
             return;
         }
 
-        if (!sensorDefinedForDevice(deviceKey, reference))
+        if (!wolk->sensorDefinedForDevice(deviceKey, reference))
         {
             LOG(ERROR) << "Sensor does not exist for device: " << deviceKey << ", " << reference;
             return;
         }
 
-        m_dataService->addSensorReading(deviceKey, reference, values, rtc != 0 ? rtc : Wolk::currentRtc());
-    });
-}
+        if (dropOldest)
+        {
+            wolk->m_dataService->dropOldestSensorReading(deviceKey, reference);
+        }
 
-template <typename T>
-void Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference, std::initializer_list<T> values,
-                            unsigned long long int rtc)
+        wolk->m_dataService->addSensorReading(deviceKey, reference, *values, rtc != 0 ? rtc : Wolk::currentRtc());
+    }
+};
+
+bool Wolk::addSensorReadingValues(const std::string& deviceKey, const std::string& reference,
+                                  std::vector<ReadingValue> values, unsigned long long int rtc)
 {
-    addSensorReading(deviceKey, reference, std::vector<T>(values), rtc);
+    if (values.empty())
+    {
+        return true;
+    }
+
+    const auto admission = admitSensorReading(deviceKey, reference);
+    if (admission == Admission::REJECT)
+    {
+        return false;
+    }
+
+    const bool dropOldest = admission == Admission::ACCEPT_DROPPING_OLDEST;
+    auto readingValues = std::make_shared<std::vector<ReadingValue>>(std::move(values));
+
+    static_assert(Command::fitsInline<SensorReadingValuesCommand>(), "Sensor reading command must not allocate");
+    addToCommandBuffer(
+      SensorReadingValuesCommand{this, deviceKey, reference, std::move(readingValues), rtc, dropOldest});
+
+    return true;
 }
 
-template <typename T>
-void Wolk::addSensorReading(const std::string& deviceKey, const std::string& reference, const std::vector<T> values,
-                            unsigned long long int rtc)
+struct Wolk::SensorReadingBatchCommand
 {
-    std::vector<std::string> stringifiedValues(values.size());
-    std::transform(values.cbegin(), values.cend(), stringifiedValues.begin(),
-                   [&](const T& value) -> std::string { return StringUtils::toString(value); });
+    Wolk* wolk;
+    std::string deviceKey;
+    std::shared_ptr<SensorReadingBatch> batch;
+    bool dropOldest;
 
-    addSensorReading(deviceKey, reference, stringifiedValues, rtc);
-}
+    void operator()()
+    {
+        auto it = wolk->m_assetIndex.find(deviceKey);
+        if (it == wolk->m_assetIndex.end())
+        {
+            LOG(ERROR) << "Device does not exist: " << deviceKey;
+            return;
+        }
 
-INSTANTIATE_ADD_SENSOR_READING_FOR(std::string);
-INSTANTIATE_ADD_SENSOR_READING_FOR(const char*);
-INSTANTIATE_ADD_SENSOR_READING_FOR(char*);
-INSTANTIATE_ADD_SENSOR_READING_FOR(bool);
-INSTANTIATE_ADD_SENSOR_READING_FOR(float);
-INSTANTIATE_ADD_SENSOR_READING_FOR(double);
-INSTANTIATE_ADD_SENSOR_READING_FOR(signed int);
-INSTANTIATE_ADD_SENSOR_READING_FOR(signed long int);
-INSTANTIATE_ADD_SENSOR_READING_FOR(signed long long int);
-INSTANTIATE_ADD_SENSOR_READING_FOR(unsigned int);
-INSTANTIATE_ADD_SENSOR_READING_FOR(unsigned long int);
-INSTANTIATE_ADD_SENSOR_READING_FOR(unsigned long long int);
+        auto& batchReadings = batch->getReadings();
+        const auto rtc = Wolk::currentRtc();
 
-void Wolk::addAlarm(const std::string& deviceKey, const std::string& reference, bool active, unsigned long long rtc)
+        auto last = std::remove_if(batchReadings.begin(), batchReadings.end(),
+                                   [&](const SensorReadingBatch::Reading& reading) {
+                                       if (!it->second.hasSensor(reading.reference))
+                                       {
+                                           LOG(ERROR) << "Sensor does not exist for device: " << deviceKey << ", "
+                                                      << reading.reference;
+                                           return true;
+                                       }
+
+                                       return false;
+                                   });
+        batchReadings.erase(last, batchReadings.end());
+
+        if (dropOldest)
+        {
+            for (const auto& reading : batchReadings)
+            {
+                wolk->m_dataService->dropOldestSensorReading(deviceKey, reading.reference);
+            }
+        }
+
+        wolk->m_dataService->addSensorReadings(deviceKey, batchReadings, rtc);
+    }
+};
+
+bool Wolk::addSensorReadings(const std::string& deviceKey, SensorReadingBatch readings)
 {
-    if (rtc == 0)
+    if (readings.empty())
     {
-        rtc = Wolk::currentRtc();
+        return true;
     }
 
-    addToCommandBuffer([=]() -> void {
-        if (!deviceExists(deviceKey))
+    bool dropOldest = false;
+    bool accepted = true;
+
+    if (overloaded())
+    {
+        auto& batchReadings = readings.getReadings();
+        auto last = std::remove_if(batchReadings.begin(), batchReadings.end(),
+                                   [&](const SensorReadingBatch::Reading& reading) {
+                                       const auto admission = admitSensorReading(deviceKey, reading.reference);
+                                       if (admission == Admission::ACCEPT_DROPPING_OLDEST)
+                                       {
+                                           dropOldest = true;
+                                       }
+
+                                       return admission == Admission::REJECT;
+                                   });
+
+        accepted = last == batchReadings.end();
+        batchReadings.erase(last, batchReadings.end());
+
+        if (batchReadings.empty())
+        {
+            return false;
+        }
+    }
+
+    auto batch = std::make_shared<SensorReadingBatch>(std::move(readings));
+
+    static_assert(Command::fitsInline<SensorReadingBatchCommand>(), "Sensor readings command must not allocate");
+    addToCommandBuffer(SensorReadingBatchCommand{this, deviceKey, std::move(batch), dropOldest});
+
+    return accepted;
+}
+
+struct Wolk::AlarmCommand
+{
+    Wolk* wolk;
+    std::string deviceKey;
+    std::string reference;
+    bool active;
+    unsigned long long int rtc;
+
+    void operator()()
+    {
+        if (!wolk->deviceExists(deviceKey))
         {
             LOG(ERROR) << "Device does not exist: " << deviceKey;
             return;
         }
 
-        if (!alarmDefinedForDevice(deviceKey, reference))
+        if (!wolk->alarmDefinedForDevice(deviceKey, reference))
         {
             LOG(ERROR) << "Alarm does not exist for device: " << deviceKey << ", " << reference;
             return;
         }
 
-        m_dataService->addAlarm(deviceKey, reference, active, rtc);
-    });
+        wolk->m_dataService->addAlarm(deviceKey, reference, active, rtc);
+    }
+};
+
+void Wolk::addAlarm(const std::string& deviceKey, const std::string& reference, bool active, unsigned long long rtc)
+{
+    if (rtc == 0)
+    {
+        rtc = Wolk::currentRtc();
+    }
+
+    static_assert(Command::fitsInline<AlarmCommand>(), "Alarm command must not allocate");
+    addToCommandBuffer(AlarmCommand{this, deviceKey, reference, active, rtc});
 }
 
 void Wolk::publishActuatorStatus(const std::string& deviceKey, const std::string& reference)
@@ -174,7 +331,7 @@ void Wolk::publishActuatorStatus(const std::string& deviceKey, const std::string
 {
     addToCommandBuffer([=] {
         m_dataService->addActuatorStatus(deviceKey, reference, value, ActuatorStatus::State::READY);
-        m_dataService->publishActuatorStatuses(deviceKey);
+        scheduleActuatorStatusesPublish();
     });
 }
 
@@ -206,37 +363,99 @@ void Wolk::addDeviceStatus(const std::string& deviceKey, DeviceStatus::Status st
 
 void Wolk::connect(bool publishRightAway)
 {
-    addToCommandBuffer([=]() -> void {
-        if (m_connectivityService->connect())
+    addToCommandBuffer([=] { tryConnect(publishRightAway); });
+}
+
+ConnectionStatistics Wolk::getConnectionStatistics() const
+{
+    return ConnectionStatistics{m_connectAttempts.value(), m_failedConnectAttempts.value(), m_connectionsLost.value(),
+                                std::chrono::milliseconds{m_reconnectDelay}};
+}
+
+MetricsSnapshot Wolk::getMetrics() const
+{
+    m_queuedCommands.set(static_cast<std::int64_t>(m_commandExecutor->size()));
+    m_queuedInboundMessages.set(static_cast<std::int64_t>(m_inboundMessageHandler->getQueuedMessagesCount()));
+    m_bufferedReadings.set(static_cast<std::int64_t>(m_dataService->getBufferedSensorReadingsCount()));
+
+    return m_metrics.snapshot();
+}
+
+void Wolk::tryConnect(bool publishRightAway)
+{
+    if (m_connected)
+    {
+        return;
+    }
+
+    m_connectAttempts.increment();
+
+    if (m_connectivityService->connect())
+    {
+        m_connected = true;
+        m_reconnectBackoff.reset();
+
+        // readings persisted while disconnected are published after fresh ones
+        m_dataService->markSensorReadingsBacklog();
+        m_dataService->markPersistedChanged();
+
+        registerDevices();
+        if (publishRightAway)
         {
-            m_connected = true;
-            registerDevices();
-            if (publishRightAway)
-            {
-                publishFirmwareVersions();
-                publishDeviceStatuses();
+            publishFirmwareVersions();
+            publishDeviceStatuses();
 
-                for (const auto& kvp : m_devices)
+            for (const auto& kvp : m_assetIndex)
+            {
+                for (const std::string& actuatorReference : kvp.second.getActuatorReferences())
                 {
-                    for (const std::string& actuatorReference : kvp.second.getActuatorReferences())
-                    {
-                        publishActuatorStatus(kvp.first, actuatorReference);
-                    }
-
-                    publishConfiguration(kvp.first);
+                    publishActuatorStatus(kvp.first, actuatorReference);
                 }
 
-                publish();
+                publishConfiguration(kvp.first);
             }
+
+            publish();
         }
-        else
-        {
-            std::this_thread::sleep_for(std::chrono::milliseconds(2000));
-            connect(publishRightAway);
-        }
+    }
+    else
+    {
+        m_failedConnectAttempts.increment();
+        scheduleReconnect(publishRightAway);
+    }
+}
+
+void Wolk::scheduleReconnect(bool publishRightAway)
+{
+    if (m_reconnectScheduled)
+    {
+        // connect was called while retry was pending
+        return;
+    }
+
+    const auto delay = m_reconnectBackoff.next();
+    m_reconnectScheduled = true;
+    m_reconnectDelay = delay.count();
+
+    LOG(INFO) << "Connecting failed, retrying in " << delay.count() << " ms";
+
+    m_reconnectTimer.start(delay, [=] {
+        // timer is restarted from the command executor, so its callback must never wait on it
+        m_commandExecutor->pushUnbounded([=] {
+            m_reconnectScheduled = false;
+            m_reconnectDelay = 0;
+            tryConnect(publishRightAway);
+        });
     });
 }
 
+void Wolk::handleConnectionLost()
+{
+    m_connectionsLost.increment();
+    m_connected = false;
+    addInboundToCommandBuffer([=] { tryConnect(true); });
+}
+
 void Wolk::disconnect()
 {
     addToCommandBuffer([=]() -> void {
@@ -247,12 +466,7 @@ void Wolk::disconnect()
 
 void Wolk::publish()
 {
-    addToCommandBuffer([=]() -> void {
-        m_dataService->publishActuatorStatuses();
-        m_dataService->publishConfiguration();
-        m_dataService->publishAlarms();
-        m_dataService->publishSensorReadings();
-    });
+    addToCommandBuffer([=]() -> void { publishBacklog(); });
 }
 
 void Wolk::publish(const std::string& deviceKey)
@@ -272,23 +486,39 @@ void Wolk::publish(const std::string& deviceKey)
 }
 
 void Wolk::addDevice(const Device& device)
+{
+    addDevices({device});
+}
+
+void Wolk::addDevices(const std::vector<Device>& devices)
 {
     addToCommandBuffer([=] {
-        const std::string deviceKey = device.getKey();
-        if (deviceExists(deviceKey))
+        std::vector<std::string> addedDeviceKeys;
+        for (const auto& device : devices)
         {
-            LOG(ERROR) << "Device with key '" << deviceKey << "' was already added";
-            return;
+            const std::string& deviceKey = device.getKey();
+            if (deviceExists(deviceKey))
+            {
+                LOG(ERROR) << "Device with key '" << deviceKey << "' was already added";
+                continue;
+            }
+
+            m_devices[deviceKey] = device;
+            m_assetIndex[deviceKey] = DeviceAssetIndex{device.getTemplate()};
+            compileSensorReadings(deviceKey, device.getTemplate().getSensors());
+            addedDeviceKeys.push_back(deviceKey);
         }
 
-        m_devices[deviceKey] = device;
+        if (addedDeviceKeys.empty())
+        {
+            return;
+        }
 
         m_deviceStatusService->devicesUpdated(getDeviceKeys());
 
         if (m_connected)
         {
-            registerDevice(device);
-            m_connectivityService->reconnect();
+            m_registrationPipeline.add(addedDeviceKeys);
         }
     });
 }
@@ -326,20 +556,276 @@ void Wolk::removeDevice(const std::string& deviceKey)
         if (it != m_devices.end())
         {
             m_devices.erase(it);
+            m_assetIndex.erase(deviceKey);
+            m_dataService->removeReadingsState(deviceKey);
+            m_metrics.removeGauge(DataService::bufferedReadingsGaugeName(deviceKey));
+
+            if (m_precompiledJsonProtocol)
+            {
+                m_precompiledJsonProtocol->removeDevice(deviceKey);
+            }
+
+            m_registrationPipeline.remove(deviceKey);
         }
     });
 }
 
-Wolk::Wolk() : m_connected{false}, m_commandBuffer{new CommandBuffer()} {}
+Wolk::Wolk()
+: m_dataEncoding{DataEncoding::JSON}
+, m_precompiledJsonProtocol{nullptr}
+, m_registrationPipeline{[this] { m_connectivityService->reconnect(); },
+                         [this](const std::string& deviceKey) {
+                             auto it = m_devices.find(deviceKey);
+                             if (it == m_devices.end())
+                             {
+                                 return false;
+                             }
+
+                             m_deviceRegistrationService->publishRegistrationRequest(it->second);
+                             return true;
+                         }}
+, m_connected{false}
+, m_reconnectBackoff{std::chrono::milliseconds{INITIAL_RECONNECT_DELAY_MS},
+                     std::chrono::milliseconds{MAX_RECONNECT_DELAY_MS}}
+, m_reconnectScheduled{false}
+, m_reconnectDelay{0}
+, m_connectAttempts{m_metrics.counter("wolk.connect.attempts")}
+, m_failedConnectAttempts{m_metrics.counter("wolk.connect.failures")}
+, m_connectionsLost{m_metrics.counter("wolk.connections.lost")}
+, m_publishBudget{PUBLISH_BACKLOG_MESSAGES_PER_PASS}
+, m_publishPriorities{PublishCategory::ALARMS, PublishCategory::ACTUATOR_STATUSES, PublishCategory::CONFIGURATIONS,
+                      PublishCategory::SENSOR_READINGS, PublishCategory::SENSOR_READINGS_BACKLOG}
+, m_publishPassScheduled{false}
+, m_backlogPublishBudget{PUBLISH_BACKLOG_MESSAGES_PER_PASS}
+, m_backlogPublishInterval{0}
+, m_backlogPublishScheduled{false}
+, m_actuatorStatusesCoalescingInterval{0}
+, m_actuatorStatusesPublishScheduled{false}
+, m_commandExecutor{new CommandExecutor()}
+, m_handlerExecutor{nullptr}
+, m_overloadPolicy{OverloadPolicy::DROP_NEWEST}
+, m_downsampleFactor{2}
+, m_rejectedReadings{m_metrics.counter("wolk.readings.rejected")}
+, m_queuedCommands{m_metrics.gauge("wolk.commands.queued")}
+, m_queuedInboundMessages{m_metrics.gauge("inbound.messages.queued")}
+, m_bufferedReadings{m_metrics.gauge("data.readings.buffered")}
+{
+}
 
 Wolk::~Wolk()
 {
-    m_commandBuffer->stop();
+    // asynchronous providers may still report results, which must not reach a destroyed instance
+    m_providerCompletions.close();
+
+    m_reconnectTimer.stop();
+    m_backlogPublishTimer.stop();
+    m_actuatorStatusesPublishTimer.stop();
+    m_aggregationTimer.stop();
+    m_metricsTimer.stop();
+    m_registrationTimeoutTimer.stop();
+
+    if (m_handlerExecutor)
+    {
+        m_handlerExecutor->stop();
+    }
+
+    m_commandExecutor->stop();
 }
 
-void Wolk::addToCommandBuffer(std::function<void()> command)
+void Wolk::addToCommandBuffer(Command command)
 {
-    m_commandBuffer->pushCommand(std::make_shared<std::function<void()>>(command));
+    m_commandExecutor->push(std::move(command));
+}
+
+void Wolk::addInboundToCommandBuffer(Command command)
+{
+    m_commandExecutor->pushUnbounded(std::move(command));
+}
+
+Wolk::Admission Wolk::admitSensorReading(const std::string& deviceKey, const std::string& reference)
+{
+    if (!overloaded())
+    {
+        return Admission::ACCEPT;
+    }
+
+    switch (m_overloadPolicy)
+    {
+    case OverloadPolicy::BLOCK:
+        // commands executed by the worker can not wait for the worker
+        while (!m_commandExecutor->isWorkerThread() && overloaded())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{OVERLOAD_POLL_INTERVAL_MS});
+        }
+
+        return Admission::ACCEPT;
+    case OverloadPolicy::DROP_OLDEST:
+        return Admission::ACCEPT_DROPPING_OLDEST;
+    case OverloadPolicy::DROP_NEWEST:
+        m_rejectedReadings.increment();
+        return Admission::REJECT;
+    case OverloadPolicy::DOWNSAMPLE:
+        if (downsample(deviceKey, reference))
+        {
+            return Admission::ACCEPT;
+        }
+
+        m_rejectedReadings.increment();
+        return Admission::REJECT;
+    }
+
+    return Admission::ACCEPT;
+}
+
+bool Wolk::overloaded()
+{
+    // both watermarks are evaluated, so that each keeps track of its own level
+    const bool commandsOverloaded = m_commandsWatermark.exceeded(m_commandExecutor->size());
+    const bool readingsOverloaded = m_readingsWatermark.exceeded(m_dataService->getBufferedSensorReadingsCount());
+
+    return commandsOverloaded || readingsOverloaded;
+}
+
+bool Wolk::downsample(const std::string& deviceKey, const std::string& reference)
+{
+    std::lock_guard<std::mutex> lock{m_downsampleMutex};
+
+    auto& counter = m_downsampleCounters[deviceKey + '\0' + reference];
+    counter = (counter + 1) % m_downsampleFactor;
+
+    return counter == 1 % m_downsampleFactor;
+}
+
+DataEncoding Wolk::getDataEncoding() const
+{
+    return m_dataEncoding;
+}
+
+void Wolk::closeAggregationWindows()
+{
+    addToCommandBuffer([=] { m_dataService->closeAggregationWindows(Wolk::currentRtc()); });
+}
+
+void Wolk::publishBacklog()
+{
+    if (m_publishPassScheduled)
+    {
+        // scheduled pass picks up newly persisted data
+        return;
+    }
+
+    m_publishBudget.reset();
+
+    if (publishByPriority(m_publishBudget))
+    {
+        schedulePublishPass();
+    }
+}
+
+bool Wolk::publishByPriority(PublishBudget& budget)
+{
+    for (const auto category : m_publishPriorities)
+    {
+        switch (category)
+        {
+        case PublishCategory::ALARMS:
+            if (m_dataService->publishAlarms(budget))
+            {
+                return true;
+            }
+            break;
+        case PublishCategory::ACTUATOR_STATUSES:
+            // only the latest status of each actuator is kept, so they are published regardless of budget
+            m_dataService->publishChangedActuatorStatuses();
+            break;
+        case PublishCategory::CONFIGURATIONS:
+            m_dataService->publishChangedConfigurations();
+            break;
+        case PublishCategory::SENSOR_READINGS:
+            if (m_dataService->publishCurrentSensorReadings(budget))
+            {
+                return true;
+            }
+            break;
+        case PublishCategory::SENSOR_READINGS_BACKLOG:
+            publishSensorReadingsBacklog();
+            break;
+        }
+    }
+
+    return false;
+}
+
+void Wolk::schedulePublishPass()
+{
+    m_publishPassScheduled = true;
+
+    // yield to commands queued in the meantime
+    addToCommandBuffer([=] {
+        m_publishPassScheduled = false;
+        publishBacklog();
+    });
+}
+
+void Wolk::publishSensorReadingsBacklog()
+{
+    if (m_backlogPublishScheduled)
+    {
+        // throttled, scheduled backlog pass continues where this one stopped
+        return;
+    }
+
+    m_backlogPublishBudget.reset();
+
+    if (m_dataService->publishSensorReadingsBacklog(m_backlogPublishBudget))
+    {
+        scheduleBacklogPublish();
+    }
+}
+
+void Wolk::scheduleBacklogPublish()
+{
+    m_backlogPublishScheduled = true;
+
+    const auto pass = [=] {
+        m_backlogPublishScheduled = false;
+        publishBacklog();
+    };
+
+    if (m_backlogPublishInterval.count() == 0)
+    {
+        // yield to commands queued in the meantime
+        addToCommandBuffer(pass);
+        return;
+    }
+
+    m_backlogPublishTimer.start(m_backlogPublishInterval, [=] { addToCommandBuffer(pass); });
+}
+
+void Wolk::scheduleActuatorStatusesPublish()
+{
+    if (m_actuatorStatusesPublishScheduled)
+    {
+        // scheduled publish picks up this status too, last value wins
+        return;
+    }
+
+    m_actuatorStatusesPublishScheduled = true;
+
+    const auto publishChanged = [=] {
+        m_actuatorStatusesPublishScheduled = false;
+        m_dataService->publishChangedActuatorStatuses();
+    };
+
+    if (m_actuatorStatusesCoalescingInterval.count() == 0)
+    {
+        // statuses added by commands queued in the meantime are published together
+        addToCommandBuffer(publishChanged);
+        return;
+    }
+
+    m_actuatorStatusesPublishTimer.start(m_actuatorStatusesCoalescingInterval,
+                                         [=] { addToCommandBuffer(publishChanged); });
 }
 
 unsigned long long Wolk::currentRtc()
@@ -348,74 +834,96 @@ unsigned long long Wolk::currentRtc()
     return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
 }
 
-void Wolk::handleActuatorSetCommand(const std::string& key, const std::string& reference, const std::string& value)
+void Wolk::handleActuatorSetCommand(const std::string& key, const std::string& reference, const std::string& value,
+                                    std::shared_ptr<ActuationTrace> trace)
 {
-    addToCommandBuffer([=] {
+    const auto queued = ActuationTracer::spanStart(trace);
+
+    addInboundToCommandBuffer([=] {
+        ActuationTracer::spanEnd(trace, TraceHop::COMMAND_QUEUE, queued);
+
         if (!deviceExists(key))
         {
             LOG(ERROR) << "Device does not exist: " << key;
+            finishActuationTrace(trace);
             return;
         }
 
         if (!actuatorDefinedForDevice(key, reference))
         {
             LOG(ERROR) << "Actuator does not exist for device: " << key << ", " << reference;
+            finishActuationTrace(trace);
             return;
         }
 
-        if (m_actuationHandler)
-        {
-            m_actuationHandler->handleActuation(key, reference, value);
-        }
-        else if (m_actuationHandlerLambda)
-        {
-            m_actuationHandlerLambda(key, reference, value);
-        }
+        const auto handlerQueued = ActuationTracer::spanStart(trace);
+
+        executeHandler(key, [=] {
+            ActuationTracer::spanEnd(trace, TraceHop::HANDLER_QUEUE, handlerQueued);
 
-        const ActuatorStatus actuatorStatus = [&] {
-            if (m_actuatorStatusProvider)
+            const auto handlerStarted = ActuationTracer::spanStart(trace);
+            if (m_actuationHandler)
             {
-                return m_actuatorStatusProvider->getActuatorStatus(key, reference);
+                m_actuationHandler->handleActuation(key, reference, value);
             }
-            else if (m_actuatorStatusProviderLambda)
+            else if (m_actuationHandlerLambda)
             {
-                return m_actuatorStatusProviderLambda(key, reference);
+                m_actuationHandlerLambda(key, reference, value);
             }
+            ActuationTracer::spanEnd(trace, TraceHop::ACTUATION_HANDLER, handlerStarted);
 
-            return ActuatorStatus("", ActuatorStatus::State::ERROR);
-        }();
+            const auto statusRequested = ActuationTracer::spanStart(trace);
+            provideActuatorStatus(key, reference, [=](ActuatorStatus actuatorStatus) {
+                ActuationTracer::spanEnd(trace, TraceHop::STATUS_PROVIDER, statusRequested);
 
-        m_dataService->addActuatorStatus(key, reference, actuatorStatus.getValue(), actuatorStatus.getState());
-        m_dataService->publishActuatorStatuses();
+                const auto resultQueued = ActuationTracer::spanStart(trace);
+                executeHandlerResult([=] {
+                    ActuationTracer::spanEnd(trace, TraceHop::RESULT_QUEUE, resultQueued);
+
+                    m_dataService->addActuatorStatus(key, reference, actuatorStatus.getValue(),
+                                                     actuatorStatus.getState(), trace);
+                    scheduleActuatorStatusesPublish();
+                });
+            });
+        });
     });
 }
 
+void Wolk::finishActuationTrace(const std::shared_ptr<ActuationTrace>& trace)
+{
+    if (m_actuationTracer)
+    {
+        m_actuationTracer->finish(trace);
+    }
+}
+
 void Wolk::handleActuatorGetCommand(const std::string& key, const std::string& reference)
 {
-    addToCommandBuffer([=] {
+    addInboundToCommandBuffer([=] {
         if (key.empty() && reference.empty())
         {
-            for (const auto& kvp : m_devices)
+            for (const auto& kvp : m_assetIndex)
             {
-                for (const std::string& actuatorReference : kvp.second.getActuatorReferences())
+                const std::string deviceKey = kvp.first;
+                const std::vector<std::string> actuatorReferences = kvp.second.getActuatorReferences();
+
+                if (actuatorReferences.empty())
                 {
-                    const ActuatorStatus actuatorStatus = [&] {
-                        if (m_actuatorStatusProvider)
-                        {
-                            return m_actuatorStatusProvider->getActuatorStatus(kvp.second.getKey(), actuatorReference);
-                        }
-                        else if (m_actuatorStatusProviderLambda)
-                        {
-                            return m_actuatorStatusProviderLambda(kvp.second.getKey(), actuatorReference);
-                        }
-
-                        return ActuatorStatus("", ActuatorStatus::State::ERROR);
-                    }();
-
-                    m_dataService->addActuatorStatus(kvp.second.getKey(), actuatorReference, actuatorStatus.getValue(),
-                                                     actuatorStatus.getState());
+                    continue;
                 }
-                m_dataService->publishActuatorStatuses();
+
+                executeHandler(deviceKey, [=] {
+                    for (const std::string& actuatorReference : actuatorReferences)
+                    {
+                        provideActuatorStatus(deviceKey, actuatorReference, [=](ActuatorStatus actuatorStatus) {
+                            executeHandlerResult([=] {
+                                m_dataService->addActuatorStatus(deviceKey, actuatorReference,
+                                                                 actuatorStatus.getValue(), actuatorStatus.getState());
+                                scheduleActuatorStatusesPublish();
+                            });
+                        });
+                    }
+                });
             }
         }
         else
@@ -431,28 +939,22 @@ void Wolk::handleActuatorGetCommand(const std::string& key, const std::string& r
                 return;
             }
 
-            const ActuatorStatus actuatorStatus = [&] {
-                if (m_actuatorStatusProvider)
-                {
-                    return m_actuatorStatusProvider->getActuatorStatus(key, reference);
-                }
-                else if (m_actuatorStatusProviderLambda)
-                {
-                    return m_actuatorStatusProviderLambda(key, reference);
-                }
-
-                return ActuatorStatus("", ActuatorStatus::State::ERROR);
-            }();
-
-            m_dataService->addActuatorStatus(key, reference, actuatorStatus.getValue(), actuatorStatus.getState());
-            m_dataService->publishActuatorStatuses();
+            executeHandler(key, [=] {
+                provideActuatorStatus(key, reference, [=](ActuatorStatus actuatorStatus) {
+                    executeHandlerResult([=] {
+                        m_dataService->addActuatorStatus(key, reference, actuatorStatus.getValue(),
+                                                         actuatorStatus.getState());
+                        scheduleActuatorStatusesPublish();
+                    });
+                });
+            });
         }
     });
 }
 
 void Wolk::handleDeviceStatusRequest(const std::string& key)
 {
-    addToCommandBuffer([=] {
+    addInboundToCommandBuffer([=] {
         if (key.empty())
         {
             publishDeviceStatuses();
@@ -464,27 +966,18 @@ void Wolk::handleDeviceStatusRequest(const std::string& key)
                 return;
             }
 
-            const DeviceStatus::Status status = [&] {
-                if (m_deviceStatusProvider)
-                {
-                    return m_deviceStatusProvider->getDeviceStatus(key);
-                }
-                else if (m_deviceStatusProviderLambda)
-                {
-                    return m_deviceStatusProviderLambda(key);
-                }
-
-                return DeviceStatus::Status::OFFLINE;
-            }();
-
-            m_deviceStatusService->publishDeviceStatusResponse(key, status);
+            executeHandler(key, [=] {
+                provideDeviceStatus(key, [=](DeviceStatus::Status status) {
+                    executeHandlerResult([=] { m_deviceStatusService->publishDeviceStatusResponse(key, status); });
+                });
+            });
         }
     });
 }
 
 void Wolk::handleConfigurationSetCommand(const std::string& key, const std::vector<ConfigurationItem>& configuration)
 {
-    addToCommandBuffer([=] {
+    addInboundToCommandBuffer([=] {
         if (!deviceExists(key))
         {
             LOG(ERROR) << "Device does not exist: " << key;
@@ -501,63 +994,132 @@ void Wolk::handleConfigurationSetCommand(const std::string& key, const std::vect
             }
         }
 
-        if (m_configurationHandler)
-        {
-            m_configurationHandler->handleConfiguration(key, configuration);
-        }
-        else if (m_configurationHandlerLambda)
-        {
-            m_configurationHandlerLambda(key, configuration);
-        }
-
-        const std::vector<ConfigurationItem> configFromDevice = [&] {
-            if (m_configurationProvider)
+        executeHandler(key, [=] {
+            if (m_configurationHandler)
             {
-                return m_configurationProvider->getConfiguration(key);
+                m_configurationHandler->handleConfiguration(key, configuration);
             }
-            else if (m_configurationProviderLambda)
+            else if (m_configurationHandlerLambda)
             {
-                return m_configurationProviderLambda(key);
+                m_configurationHandlerLambda(key, configuration);
             }
 
-            return std::vector<ConfigurationItem>{};
-        }();
-
-        m_dataService->addConfiguration(key, configFromDevice);
-        m_dataService->publishConfiguration();
+            provideConfiguration(key, [=](std::vector<ConfigurationItem> configFromDevice) {
+                executeHandlerResult([=] {
+                    m_dataService->addConfiguration(key, configFromDevice);
+                    m_dataService->publishConfiguration();
+                });
+            });
+        });
     });
 }
 
 void Wolk::handleConfigurationGetCommand(const std::string& key)
 {
-    addToCommandBuffer([=] {
+    addInboundToCommandBuffer([=] {
         if (!deviceExists(key))
         {
             LOG(ERROR) << "Device does not exist: " << key;
             return;
         }
 
-        const std::vector<ConfigurationItem> configFromDevice = [&] {
-            if (m_configurationProvider)
-            {
-                return m_configurationProvider->getConfiguration(key);
-            }
-            else if (m_configurationProviderLambda)
-            {
-                return m_configurationProviderLambda(key);
-            }
+        executeHandler(key, [=] {
+            provideConfiguration(key, [=](std::vector<ConfigurationItem> configFromDevice) {
+                executeHandlerResult([=] {
+                    m_dataService->addConfiguration(key, configFromDevice);
+                    m_dataService->publishConfiguration();
+                });
+            });
+        });
+    });
+}
 
-            return std::vector<ConfigurationItem>{};
-        }();
+void Wolk::executeHandler(const std::string& deviceKey, Command command)
+{
+    if (!m_handlerExecutor)
+    {
+        command();
+        return;
+    }
 
-        m_dataService->addConfiguration(key, configFromDevice);
-        m_dataService->publishConfiguration();
-    });
+    m_handlerExecutor->push(deviceKey, std::move(command));
 }
 
-void Wolk::registerDevice(const Device& device)
+void Wolk::executeHandlerResult(Command command)
 {
-    addToCommandBuffer([=] { m_deviceRegistrationService->publishRegistrationRequest(device); });
+    if (m_commandExecutor->isWorkerThread())
+    {
+        command();
+        return;
+    }
+
+    // results come from handler workers or asynchronous providers,
+    // which must never wait on the command executor, it may be waiting on them
+    m_commandExecutor->pushUnbounded(std::move(command));
+}
+
+void Wolk::provideActuatorStatus(const std::string& deviceKey, const std::string& reference,
+                                 std::function<void(ActuatorStatus)> onStatus)
+{
+    if (m_asyncActuatorStatusProvider)
+    {
+        m_asyncActuatorStatusProvider->getActuatorStatus(deviceKey, reference,
+                                                          m_providerCompletions.guard(std::move(onStatus)));
+    }
+    else if (m_actuatorStatusProvider)
+    {
+        onStatus(m_actuatorStatusProvider->getActuatorStatus(deviceKey, reference));
+    }
+    else if (m_actuatorStatusProviderLambda)
+    {
+        onStatus(m_actuatorStatusProviderLambda(deviceKey, reference));
+    }
+    else
+    {
+        onStatus(ActuatorStatus("", ActuatorStatus::State::ERROR));
+    }
+}
+
+void Wolk::provideConfiguration(const std::string& deviceKey,
+                                std::function<void(std::vector<ConfigurationItem>)> onConfiguration)
+{
+    if (m_asyncConfigurationProvider)
+    {
+        m_asyncConfigurationProvider->getConfiguration(deviceKey,
+                                                       m_providerCompletions.guard(std::move(onConfiguration)));
+    }
+    else if (m_configurationProvider)
+    {
+        onConfiguration(m_configurationProvider->getConfiguration(deviceKey));
+    }
+    else if (m_configurationProviderLambda)
+    {
+        onConfiguration(m_configurationProviderLambda(deviceKey));
+    }
+    else
+    {
+        onConfiguration(std::vector<ConfigurationItem>{});
+    }
+}
+
+void Wolk::provideDeviceStatus(const std::string& deviceKey, std::function<void(DeviceStatus::Status)> onStatus)
+{
+    if (m_asyncDeviceStatusProvider)
+    {
+        m_asyncDeviceStatusProvider->getDeviceStatus(deviceKey, m_providerCompletions.guard(std::move(onStatus)));
+    }
+    else if (m_deviceStatusProvider)
+    {
+        onStatus(m_deviceStatusProvider->getDeviceStatus(deviceKey));
+    }
+    else if (m_deviceStatusProviderLambda)
+    {
+        onStatus(m_deviceStatusProviderLambda(deviceKey));
+    }
+    else
+    {
+        onStatus(DeviceStatus::Status::OFFLINE);
+    }
 }
 
 void Wolk::updateDevice(std::string deviceKey, bool updateDefaultSemantics,
@@ -571,14 +1133,15 @@ void Wolk::updateDevice(std::string deviceKey, bool updateDefaultSemantics,
     });
 }
 
+void Wolk::expireRegistrations()
+{
+    addToCommandBuffer([=] { m_registrationPipeline.expire(RegistrationPipeline::Clock::now()); });
+}
+
 void Wolk::registerDevices()
 {
-    addToCommandBuffer([=] {
-        for (const auto& kvp : m_devices)
-        {
-            m_deviceRegistrationService->publishRegistrationRequest(kvp.second);
-        }
-    });
+    // responses to requests sent over previous connection may never arrive
+    addToCommandBuffer([=] { m_registrationPipeline.restart(getDeviceKeys()); });
 }
 
 void Wolk::publishFirmwareVersion(const std::string& deviceKey)
@@ -613,21 +1176,15 @@ void Wolk::publishDeviceStatuses()
     addToCommandBuffer([=] {
         for (const auto& kvp : m_devices)
         {
-            addToCommandBuffer([=] {
-                const DeviceStatus::Status status = [&] {
-                    if (m_deviceStatusProvider)
-                    {
-                        return m_deviceStatusProvider->getDeviceStatus(kvp.second.getKey());
-                    }
-                    else if (m_deviceStatusProviderLambda)
-                    {
-                        return m_deviceStatusProviderLambda(kvp.second.getKey());
-                    }
-
-                    return DeviceStatus::Status::OFFLINE;
-                }();
+            const std::string deviceKey = kvp.first;
 
-                m_deviceStatusService->publishDeviceStatusUpdate(kvp.second.getKey(), status);
+            addToCommandBuffer([=] {
+                executeHandler(deviceKey, [=] {
+                    provideDeviceStatus(deviceKey, [=](DeviceStatus::Status status) {
+                        executeHandlerResult(
+                          [=] { m_deviceStatusService->publishDeviceStatusUpdate(deviceKey, status); });
+                    });
+                });
             });
         }
     });
@@ -657,25 +1214,18 @@ bool Wolk::deviceExists(const std::string& deviceKey)
 
 bool Wolk::sensorDefinedForDevice(const std::string& deviceKey, const std::string& reference)
 {
-    auto it = m_devices.find(deviceKey);
-    if (it == m_devices.end())
-    {
-        return false;
-    }
-
-    const auto sensors = it->second.getTemplate().getSensors();
-    auto sensorIt = std::find_if(sensors.cbegin(), sensors.cend(),
-                                 [&](const SensorTemplate& Template) { return Template.getReference() == reference; });
-
-    return sensorIt != sensors.end();
+    auto it = m_assetIndex.find(deviceKey);
+    return it != m_assetIndex.end() && it->second.hasSensor(reference);
 }
 
-std::vector<std::string> Wolk::getActuatorReferences(const std::string& deviceKey)
+const std::vector<std::string>& Wolk::getActuatorReferences(const std::string& deviceKey)
 {
-    auto it = m_devices.find(deviceKey);
-    if (it == m_devices.end())
+    static const std::vector<std::string> noReferences;
+
+    auto it = m_assetIndex.find(deviceKey);
+    if (it == m_assetIndex.end())
     {
-        return {};
+        return noReferences;
     }
 
     return it->second.getActuatorReferences();
@@ -683,47 +1233,20 @@ std::vector<std::string> Wolk::getActuatorReferences(const std::string& deviceKe
 
 bool Wolk::alarmDefinedForDevice(const std::string& deviceKey, const std::string& reference)
 {
-    auto it = m_devices.find(deviceKey);
-    if (it == m_devices.end())
-    {
-        return false;
-    }
-
-    const auto alarms = it->second.getTemplate().getAlarms();
-    auto alarmIt = std::find_if(alarms.cbegin(), alarms.cend(),
-                                [&](const AlarmTemplate& Template) { return Template.getReference() == reference; });
-
-    return alarmIt != alarms.end();
+    auto it = m_assetIndex.find(deviceKey);
+    return it != m_assetIndex.end() && it->second.hasAlarm(reference);
 }
 
 bool Wolk::actuatorDefinedForDevice(const std::string& deviceKey, const std::string& reference)
 {
-    auto it = m_devices.find(deviceKey);
-    if (it == m_devices.end())
-    {
-        return false;
-    }
-
-    const auto actuators = it->second.getActuatorReferences();
-    auto actuatorIt = std::find(actuators.cbegin(), actuators.cend(), reference);
-
-    return actuatorIt != actuators.end();
+    auto it = m_assetIndex.find(deviceKey);
+    return it != m_assetIndex.end() && it->second.hasActuator(reference);
 }
 
 bool Wolk::configurationItemDefinedForDevice(const std::string& deviceKey, const std::string& reference)
 {
-    auto it = m_devices.find(deviceKey);
-    if (it == m_devices.end())
-    {
-        return false;
-    }
-
-    const auto configurations = it->second.getTemplate().getConfigurations();
-    auto configurationIt =
-      std::find_if(configurations.cbegin(), configurations.cend(),
-                   [&](const ConfigurationTemplate& Template) { return Template.getReference() == reference; });
-
-    return configurationIt != configurations.end();
+    auto it = m_assetIndex.find(deviceKey);
+    return it != m_assetIndex.end() && it->second.hasConfigurationItem(reference);
 }
 
 bool Wolk::validateAssetsToUpdate(const Device& device, const std::vector<ConfigurationTemplate>& configurations,
@@ -774,15 +1297,35 @@ bool Wolk::validateAssetsToUpdate(const Device& device, const std::vector<Config
     return true;
 }
 
+void Wolk::compileSensorReadings(const std::string& deviceKey, const std::vector<SensorTemplate>& sensors)
+{
+    if (!m_precompiledJsonProtocol)
+    {
+        return;
+    }
+
+    std::vector<std::string> references;
+    references.reserve(sensors.size());
+    for (const auto& sensor : sensors)
+    {
+        references.push_back(sensor.getReference());
+    }
+
+    m_precompiledJsonProtocol->addSensors(deviceKey, references);
+}
+
 void Wolk::storeAssetsToDevice(Device& device, const std::vector<ConfigurationTemplate>& configurations,
                                const std::vector<SensorTemplate>& sensors, const std::vector<AlarmTemplate>& alarms,
                                const std::vector<ActuatorTemplate>& actuators)
 {
+    auto& assetIndex = m_assetIndex[device.getKey()];
+
     for (const auto& conf : configurations)
     {
         if (!device.getTemplate().hasConfigurationTemplateWithReference(conf.getReference()))
         {
             device.getTemplate().addConfiguration(conf);
+            assetIndex.addConfigurationItem(conf.getReference());
         }
     }
 
@@ -791,6 +1334,8 @@ void Wolk::storeAssetsToDevice(Device& device, const std::vector<ConfigurationTe
         if (!device.getTemplate().hasSensorTemplateWithReference(sensor.getReference()))
         {
             device.getTemplate().addSensor(sensor);
+            assetIndex.addSensor(sensor.getReference());
+            compileSensorReadings(device.getKey(), {sensor});
         }
     }
 
@@ -799,6 +1344,7 @@ void Wolk::storeAssetsToDevice(Device& device, const std::vector<ConfigurationTe
         if (!device.getTemplate().hasAlarmTemplateWithReference(alarm.getReference()))
         {
             device.getTemplate().addAlarm(alarm);
+            assetIndex.addAlarm(alarm.getReference());
         }
     }
 
@@ -807,6 +1353,7 @@ void Wolk::storeAssetsToDevice(Device& device, const std::vector<ConfigurationTe
         if (!device.getTemplate().hasActuatorTemplateWithReference(actuator.getReference()))
         {
             device.getTemplate().addActuator(actuator);
+            assetIndex.addActuator(actuator.getReference());
         }
     }
 }
@@ -815,7 +1362,9 @@ void Wolk::handleRegistrationResponse(const std::string& deviceKey, PlatformResu
 {
     LOG(INFO) << "Registration response for device '" << deviceKey << "' received: " << static_cast<int>(result);
 
-    addToCommandBuffer([=] {
+    addInboundToCommandBuffer([=] {
+        m_registrationPipeline.responseReceived(deviceKey);
+
         if (!deviceExists(deviceKey))
         {
             LOG(ERROR) << "Device does not exist: " << deviceKey;
@@ -843,7 +1392,7 @@ void Wolk::handleUpdateResponse(const std::string& deviceKey, PlatformResult::Co
 {
     LOG(INFO) << "Update response for device '" << deviceKey << "' received: " << static_cast<int>(result);
 
-    addToCommandBuffer([=] {
+    addInboundToCommandBuffer([=] {
         if (!deviceExists(deviceKey))
         {
             LOG(ERROR) << "Device does not exist: " << deviceKey;
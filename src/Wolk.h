@@ -19,19 +19,42 @@
 
 #include "ActuationHandlerPerDevice.h"
 #include "ActuatorStatusProviderPerDevice.h"
+#include "AsyncActuatorStatusProvider.h"
+#include "AsyncConfigurationProvider.h"
+#include "AsyncDeviceStatusProvider.h"
 #include "ConfigurationHandlerPerDevice.h"
 #include "ConfigurationProviderPerDevice.h"
 #include "WolkBuilder.h"
 #include "core/model/ActuatorStatus.h"
 #include "core/model/DeviceStatus.h"
 #include "core/model/PlatformResult.h"
-#include "core/utilities/CommandBuffer.h"
+#include "core/utilities/Timer.h"
+#include "model/ConnectionStatistics.h"
 #include "model/Device.h"
-
+#include "model/DeviceAssetIndex.h"
+#include "model/MetricsSnapshot.h"
+#include "model/OverloadPolicy.h"
+#include "model/PublishBudget.h"
+#include "model/PublishCategory.h"
+#include "model/ReadingValue.h"
+#include "model/SensorReadingBatch.h"
+#include "protocol/DataEncoding.h"
+#include "service/RegistrationPipeline.h"
+#include "utilities/ActuationTracer.h"
+#include "utilities/CommandExecutor.h"
+#include "utilities/CompletionGuard.h"
+#include "utilities/ExponentialBackoff.h"
+#include "utilities/MetricsRegistry.h"
+#include "utilities/ShardedCommandExecutor.h"
+#include "utilities/Watermark.h"
+
+#include <chrono>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace wolkabout
@@ -47,6 +70,7 @@ class InboundGatewayMessageHandler;
 class InboundMessageHandler;
 class JsonDFUProtocol;
 class PlatformStatusProtocol;
+class PrecompiledJsonProtocol;
 
 class Wolk
 {
@@ -85,9 +109,10 @@ public:
      *               - const char*<br>
      * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
      *            If omitted current POSIX time is adopted
+     * @return false if reading was rejected by overload policy, see wolkabout::WolkBuilder::withOverloadPolicy
      */
     template <typename T>
-    void addSensorReading(const std::string& deviceKey, const std::string& reference, T value,
+    bool addSensorReading(const std::string& deviceKey, const std::string& reference, T value,
                           unsigned long long int rtc = 0);
 
     /**
@@ -110,9 +135,10 @@ public:
      *               - const char*<br>
      * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
      *            If omitted current POSIX time is adopted
+     * @return false if reading was rejected by overload policy, see wolkabout::WolkBuilder::withOverloadPolicy
      */
     template <typename T>
-    void addSensorReading(const std::string& deviceKey, const std::string& reference, std::initializer_list<T> values,
+    bool addSensorReading(const std::string& deviceKey, const std::string& reference, std::initializer_list<T> values,
                           unsigned long long int rtc = 0);
 
     /**
@@ -135,11 +161,24 @@ public:
      *               - const char*<br>
      * @param rtc Reading POSIX time - Number of seconds since 01/01/1970<br>
      *            If omitted current POSIX time is adopted
+     * @return false if reading was rejected by overload policy, see wolkabout::WolkBuilder::withOverloadPolicy
      */
     template <typename T>
-    void addSensorReading(const std::string& deviceKey, const std::string& reference, const std::vector<T> values,
+    bool addSensorReading(const std::string& deviceKey, const std::string& reference, const std::vector<T> values,
                           unsigned long long int rtc = 0);
 
+    /**
+     * @brief Publishes batch of sensor readings of a single device to WolkAbout IoT Cloud<br>
+     *        Batch is validated and persisted as a single command, which is considerably cheaper
+     *        than adding the readings one by one.<br>
+     *        Readings for sensors not defined for the device are discarded.<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @param deviceKey key of the device that holds the sensors
+     * @param readings wolkabout::SensorReadingBatch containing readings
+     * @return false if any reading was rejected by overload policy, see wolkabout::WolkBuilder::withOverloadPolicy
+     */
+    bool addSensorReadings(const std::string& deviceKey, SensorReadingBatch readings);
+
     /**
      * @brief Publishes alarm to WolkAbout IoT Cloud<br>
      *        This method is thread safe, and can be called from multiple thread
@@ -201,6 +240,21 @@ public:
      */
     void disconnect();
 
+    /**
+     * @brief Counts connection attempts, and reports delay of scheduled reconnect attempt<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @return Snapshot of connection statistics
+     */
+    ConnectionStatistics getConnectionStatistics() const;
+
+    /**
+     * @brief Reads counters, gauges and latency histograms of connection, command queues, buffered and published
+     *        data, inbound messages and firmware installations<br>
+     *        This method is thread safe, and can be called from multiple thread simultaneously
+     * @return Snapshot of metrics, by metric name
+     */
+    MetricsSnapshot getMetrics() const;
+
     /**
      * @brief publish Publishes data
      */
@@ -224,6 +278,15 @@ public:
      */
     void addDevice(const Device& device);
 
+    /**
+     * @brief addDevices Registers devices on WolkAbout IoT platform<br>
+     *        Subscribes to channels of all devices at once, and registers them through
+     *        registration pipeline limited by wolkabout::WolkBuilder::withRegistrationsInFlight<br>
+     *        Outcome of each registration is reported to registration response handler
+     * @param devices
+     */
+    void addDevices(const std::vector<Device>& devices);
+
     /**
      * @brief addAssetsToDevice Updates device with assets on WolkAbout IoT platform
      *
@@ -239,23 +302,70 @@ public:
      */
     void removeDevice(const std::string& deviceKey);
 
+    /**
+     * @brief getDataEncoding Encoding of data exchanged with gateway
+     * @return wolkabout::DataEncoding::CUSTOM if protocol was set with WolkBuilder::withDataProtocol
+     */
+    DataEncoding getDataEncoding() const;
+
 private:
     class ConnectivityFacade;
 
+    // intake commands are named types, so that their inline storage in Command is checked at compile time
+    struct SensorReadingCommand;
+    struct SensorReadingValuesCommand;
+    struct SensorReadingBatchCommand;
+    struct AlarmCommand;
+
     Wolk();
 
-    void addToCommandBuffer(std::function<void()> command);
+    void addToCommandBuffer(Command command);
+
+    // for commands from inbound messages and connection callbacks, which must never wait on the command executor,
+    // it may be waiting on a publish that needs the thread they come from
+    void addInboundToCommandBuffer(Command command);
+
+    enum class Admission
+    {
+        ACCEPT,
+        ACCEPT_DROPPING_OLDEST,
+        REJECT
+    };
+
+    bool addSensorReadingValue(const std::string& deviceKey, const std::string& reference, ReadingValue value,
+                               unsigned long long int rtc);
+    bool addSensorReadingValues(const std::string& deviceKey, const std::string& reference,
+                                std::vector<ReadingValue> values, unsigned long long int rtc);
+
+    Admission admitSensorReading(const std::string& deviceKey, const std::string& reference);
+    bool overloaded();
+    bool downsample(const std::string& deviceKey, const std::string& reference);
 
     static unsigned long long int currentRtc();
 
-    void handleActuatorSetCommand(const std::string& key, const std::string& reference, const std::string& value);
+    void tryConnect(bool publishRightAway);
+    void scheduleReconnect(bool publishRightAway);
+    void handleConnectionLost();
+
+    void handleActuatorSetCommand(const std::string& key, const std::string& reference, const std::string& value,
+                                  std::shared_ptr<ActuationTrace> trace);
+    void finishActuationTrace(const std::shared_ptr<ActuationTrace>& trace);
     void handleActuatorGetCommand(const std::string& key, const std::string& reference);
     void handleDeviceStatusRequest(const std::string& key);
     void handleConfigurationSetCommand(const std::string& key, const std::vector<ConfigurationItem>& configuration);
     void handleConfigurationGetCommand(const std::string& key);
 
+    void executeHandler(const std::string& deviceKey, Command command);
+    void executeHandlerResult(Command command);
+
+    void provideActuatorStatus(const std::string& deviceKey, const std::string& reference,
+                               std::function<void(ActuatorStatus)> onStatus);
+    void provideConfiguration(const std::string& deviceKey,
+                              std::function<void(std::vector<ConfigurationItem>)> onConfiguration);
+    void provideDeviceStatus(const std::string& deviceKey, std::function<void(DeviceStatus::Status)> onStatus);
+
     void registerDevices();
-    void registerDevice(const Device& device);
+    void expireRegistrations();
     void updateDevice(std::string deviceKey, bool updateDefaultSemantics,
                       std::vector<ConfigurationTemplate> configurations = {}, std::vector<SensorTemplate> sensors = {},
                       std::vector<AlarmTemplate> alarms = {}, std::vector<ActuatorTemplate> actuators = {});
@@ -265,10 +375,20 @@ private:
 
     void publishDeviceStatuses();
 
+    void closeAggregationWindows();
+
+    void publishBacklog();
+    bool publishByPriority(PublishBudget& budget);
+    void schedulePublishPass();
+    void publishSensorReadingsBacklog();
+    void scheduleBacklogPublish();
+
+    void scheduleActuatorStatusesPublish();
+
     std::vector<std::string> getDeviceKeys();
     bool deviceExists(const std::string& deviceKey);
     bool sensorDefinedForDevice(const std::string& deviceKey, const std::string& reference);
-    std::vector<std::string> getActuatorReferences(const std::string& deviceKey);
+    const std::vector<std::string>& getActuatorReferences(const std::string& deviceKey);
     bool alarmDefinedForDevice(const std::string& deviceKey, const std::string& reference);
     bool actuatorDefinedForDevice(const std::string& deviceKey, const std::string& reference);
     bool configurationItemDefinedForDevice(const std::string& deviceKey, const std::string& reference);
@@ -276,6 +396,7 @@ private:
     bool validateAssetsToUpdate(const Device& device, const std::vector<ConfigurationTemplate>& configurations,
                                 const std::vector<SensorTemplate>& sensors, const std::vector<AlarmTemplate>& alarms,
                                 const std::vector<ActuatorTemplate>& actuators) const;
+    void compileSensorReadings(const std::string& deviceKey, const std::vector<SensorTemplate>& sensors);
     void storeAssetsToDevice(Device& device, const std::vector<ConfigurationTemplate>& configurations,
                              const std::vector<SensorTemplate>& sensors, const std::vector<AlarmTemplate>& alarms,
                              const std::vector<ActuatorTemplate>& actuators);
@@ -283,11 +404,18 @@ private:
     void handleRegistrationResponse(const std::string& deviceKey, PlatformResult::Code result);
     void handleUpdateResponse(const std::string& deviceKey, PlatformResult::Code result);
 
+    // outlive services which update them
+    MetricsRegistry m_metrics;
+    std::unique_ptr<ActuationTracer> m_actuationTracer;
+
     std::unique_ptr<ConnectivityService> m_connectivityService;
 
     std::function<void(const std::string&, PlatformResult::Code)> m_registrationResponseHandler;
 
     std::unique_ptr<DataProtocol> m_dataProtocol;
+    DataEncoding m_dataEncoding;
+    // data protocol, when it compiles sensor reading templates of added devices
+    PrecompiledJsonProtocol* m_precompiledJsonProtocol;
     std::unique_ptr<StatusProtocol> m_statusProtocol;
     std::unique_ptr<RegistrationProtocol> m_registrationProtocol;
     std::unique_ptr<JsonDFUProtocol> m_firmwareUpdateProtocol;
@@ -304,9 +432,11 @@ private:
 
     std::function<ActuatorStatus(const std::string&, const std::string&)> m_actuatorStatusProviderLambda;
     std::shared_ptr<ActuatorStatusProviderPerDevice> m_actuatorStatusProvider;
+    std::shared_ptr<AsyncActuatorStatusProvider> m_asyncActuatorStatusProvider;
 
     std::function<DeviceStatus::Status(const std::string&)> m_deviceStatusProviderLambda;
     std::shared_ptr<DeviceStatusProvider> m_deviceStatusProvider;
+    std::shared_ptr<AsyncDeviceStatusProvider> m_asyncDeviceStatusProvider;
 
     std::function<void(const std::string&, const std::vector<ConfigurationItem>& configuration)>
       m_configurationHandlerLambda;
@@ -314,6 +444,10 @@ private:
 
     std::function<std::vector<ConfigurationItem>(const std::string&)> m_configurationProviderLambda;
     std::shared_ptr<ConfigurationProviderPerDevice> m_configurationProvider;
+    std::shared_ptr<AsyncConfigurationProvider> m_asyncConfigurationProvider;
+
+    // results of asynchronous providers are reported through callbacks guarded by it
+    CompletionGuard m_providerCompletions;
 
     std::shared_ptr<DataService> m_dataService;
     std::shared_ptr<DeviceStatusService> m_deviceStatusService;
@@ -323,9 +457,65 @@ private:
 
     std::map<std::string, Device> m_devices;
 
+    RegistrationPipeline m_registrationPipeline;
+    Timer m_registrationTimeoutTimer;
+    std::unordered_map<std::string, DeviceAssetIndex> m_assetIndex;
+
     std::atomic_bool m_connected;
 
-    std::unique_ptr<CommandBuffer> m_commandBuffer;
+    // reconnect state is accessed only on the command executor, counters from any thread
+    ExponentialBackoff m_reconnectBackoff;
+    bool m_reconnectScheduled;
+    std::atomic<std::chrono::milliseconds::rep> m_reconnectDelay;
+    Timer m_reconnectTimer;
+
+    Counter& m_connectAttempts;
+    Counter& m_failedConnectAttempts;
+    Counter& m_connectionsLost;
+
+    PublishBudget m_publishBudget;
+    std::vector<PublishCategory> m_publishPriorities;
+    bool m_publishPassScheduled;
+
+    // backlog has its own budget and rate, so it does not hold back other categories
+    PublishBudget m_backlogPublishBudget;
+    std::chrono::milliseconds m_backlogPublishInterval;
+    bool m_backlogPublishScheduled;
+    Timer m_backlogPublishTimer;
+
+    std::chrono::milliseconds m_actuatorStatusesCoalescingInterval;
+    bool m_actuatorStatusesPublishScheduled;
+    Timer m_actuatorStatusesPublishTimer;
+
+    // closes aggregation windows of sensors that stopped sending readings
+    Timer m_aggregationTimer;
+
+    std::unique_ptr<CommandExecutor> m_commandExecutor;
+
+    // runs user handlers and providers, when not set they run on the command executor
+    std::unique_ptr<ShardedCommandExecutor> m_handlerExecutor;
+
+    OverloadPolicy m_overloadPolicy;
+    unsigned int m_downsampleFactor;
+    Watermark m_commandsWatermark;
+    Watermark m_readingsWatermark;
+
+    std::mutex m_downsampleMutex;
+    std::unordered_map<std::string, unsigned int> m_downsampleCounters;
+
+    Counter& m_rejectedReadings;
+
+    // queue depths are sampled when metrics are read
+    Gauge& m_queuedCommands;
+    Gauge& m_queuedInboundMessages;
+    Gauge& m_bufferedReadings;
+
+    Timer m_metricsTimer;
+
+    static const constexpr unsigned int PUBLISH_BACKLOG_MESSAGES_PER_PASS = 100;
+    static const constexpr unsigned int OVERLOAD_POLL_INTERVAL_MS = 10;
+    static const constexpr unsigned int INITIAL_RECONNECT_DELAY_MS = 2000;
+    static const constexpr unsigned int MAX_RECONNECT_DELAY_MS = 60000;
 
     class ConnectivityFacade : public ConnectivityServiceListener
     {
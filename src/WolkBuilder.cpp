@@ -26,7 +26,6 @@
 #include "core/persistence/InMemoryPersistence.h"
 #include "core/persistence/Persistence.h"
 #include "core/protocol/json/JsonDFUProtocol.h"
-#include "core/protocol/json/JsonProtocol.h"
 #include "core/protocol/json/JsonRegistrationProtocol.h"
 #include "core/protocol/json/JsonStatusProtocol.h"
 #include "model/Device.h"
@@ -34,8 +33,13 @@
 #include "service/DeviceRegistrationService.h"
 #include "service/DeviceStatusService.h"
 #include "service/FirmwareUpdateService.h"
+#include "protocol/SensorReadingsEnvelopeProtocol.h"
 #include "protocol/json/JsonPlatformStatusProtocol.h"
+#include "protocol/json/PrecompiledJsonProtocol.h"
+#include "protocol/msgpack/MessagePackProtocol.h"
+#include "utilities/ActuationTracer.h"
 
+#include <algorithm>
 #include <functional>
 #include <stdexcept>
 #include <string>
@@ -43,6 +47,9 @@
 
 namespace wolkabout
 {
+const constexpr unsigned int WolkBuilder::DEFAULT_REGISTRATION_RESPONSE_TIMEOUT_MS;
+const constexpr unsigned int WolkBuilder::REGISTRATION_DEADLINE_CHECKS;
+
 WolkBuilder& WolkBuilder::host(const std::string& host)
 {
     m_host = host;
@@ -69,6 +76,7 @@ WolkBuilder& WolkBuilder::actuatorStatusProvider(
 {
     m_actuatorStatusProviderLambda = std::move(actuatorStatusProvider);
     m_actuatorStatusProvider.reset();
+    m_asyncActuatorStatusProvider.reset();
     return *this;
 }
 
@@ -77,6 +85,15 @@ WolkBuilder& WolkBuilder::actuatorStatusProvider(
 {
     m_actuatorStatusProvider = std::move(actuatorStatusProvider);
     m_actuatorStatusProviderLambda = nullptr;
+    m_asyncActuatorStatusProvider.reset();
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::actuatorStatusProvider(std::shared_ptr<AsyncActuatorStatusProvider> actuatorStatusProvider)
+{
+    m_asyncActuatorStatusProvider = std::move(actuatorStatusProvider);
+    m_actuatorStatusProvider.reset();
+    m_actuatorStatusProviderLambda = nullptr;
     return *this;
 }
 
@@ -100,6 +117,7 @@ WolkBuilder& WolkBuilder::configurationProvider(
 {
     m_configurationProviderLambda = std::move(configurationProvider);
     m_configurationProvider.reset();
+    m_asyncConfigurationProvider.reset();
     return *this;
 }
 
@@ -107,6 +125,15 @@ WolkBuilder& WolkBuilder::configurationProvider(std::shared_ptr<ConfigurationPro
 {
     m_configurationProvider = std::move(configurationProvider);
     m_configurationProviderLambda = nullptr;
+    m_asyncConfigurationProvider.reset();
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::configurationProvider(std::shared_ptr<AsyncConfigurationProvider> configurationProvider)
+{
+    m_asyncConfigurationProvider = std::move(configurationProvider);
+    m_configurationProvider.reset();
+    m_configurationProviderLambda = nullptr;
     return *this;
 }
 
@@ -115,6 +142,7 @@ WolkBuilder& WolkBuilder::deviceStatusProvider(
 {
     m_deviceStatusProviderLambda = std::move(deviceStatusProvider);
     m_deviceStatusProvider.reset();
+    m_asyncDeviceStatusProvider.reset();
     return *this;
 }
 
@@ -122,6 +150,15 @@ WolkBuilder& WolkBuilder::deviceStatusProvider(std::shared_ptr<DeviceStatusProvi
 {
     m_deviceStatusProvider = std::move(deviceStatusProvider);
     m_deviceStatusProviderLambda = nullptr;
+    m_asyncDeviceStatusProvider.reset();
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::deviceStatusProvider(std::shared_ptr<AsyncDeviceStatusProvider> deviceStatusProvider)
+{
+    m_asyncDeviceStatusProvider = std::move(deviceStatusProvider);
+    m_deviceStatusProvider.reset();
+    m_deviceStatusProviderLambda = nullptr;
     return *this;
 }
 
@@ -131,6 +168,179 @@ WolkBuilder& WolkBuilder::withPersistence(std::unique_ptr<Persistence> persisten
     return *this;
 }
 
+WolkBuilder& WolkBuilder::withDataProtocol(std::unique_ptr<DataProtocol> protocol)
+{
+    m_dataProtocol = std::move(protocol);
+    m_dataEncoding = DataEncoding::CUSTOM;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withDataEncoding(DataEncoding encoding)
+{
+    if (encoding == DataEncoding::CUSTOM)
+    {
+        throw std::logic_error("Custom data encoding requires protocol, use withDataProtocol.");
+    }
+
+    m_dataProtocol.reset();
+    m_dataEncoding = encoding;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPublishBatchLimits(unsigned int maxItems, std::size_t maxBytes)
+{
+    if (maxItems == 0)
+    {
+        throw std::logic_error("Publish batch must contain at least one item.");
+    }
+
+    m_publishBatchItemsCount = maxItems;
+    m_publishBatchMaxBytes = maxBytes;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withSensorReadingsEnvelopes(bool acrossDevices)
+{
+    m_sensorReadingsEnvelopes = true;
+    m_sensorReadingsEnvelopesAcrossDevices = acrossDevices;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPublishBudget(unsigned int maxMessages, std::size_t maxBytes,
+                                            std::chrono::milliseconds maxDuration)
+{
+    m_publishBudget = PublishBudget{maxMessages, maxBytes, maxDuration};
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withBacklogPublishRate(unsigned int messagesPerSecond)
+{
+    m_backlogPublishRate = messagesPerSecond;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withPublishPriorities(std::vector<PublishCategory> priorities)
+{
+    for (auto it = priorities.begin(); it != priorities.end(); ++it)
+    {
+        if (std::find(priorities.begin(), it, *it) != it)
+        {
+            throw std::logic_error("Publish category must not be listed more than once.");
+        }
+    }
+
+    m_publishPriorities = std::move(priorities);
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withActuatorStatusCoalescing(std::chrono::milliseconds interval)
+{
+    m_actuatorStatusesCoalescingInterval = interval;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReconnectBackoff(std::chrono::milliseconds initialDelay,
+                                               std::chrono::milliseconds maxDelay)
+{
+    if (initialDelay.count() <= 0 || maxDelay < initialDelay)
+    {
+        throw std::logic_error("Reconnect delays must be positive, and max delay must not be below initial delay.");
+    }
+
+    m_initialReconnectDelay = initialDelay;
+    m_maxReconnectDelay = maxDelay;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReadingsWatermarks(std::size_t high, std::size_t low)
+{
+    if (high == 0 || low >= high)
+    {
+        throw std::logic_error("Low watermark must be below high watermark.");
+    }
+
+    m_readingsHighWatermark = high;
+    m_readingsLowWatermark = low;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withCommandsWatermarks(std::size_t high, std::size_t low)
+{
+    if (high == 0 || low >= high)
+    {
+        throw std::logic_error("Low watermark must be below high watermark.");
+    }
+
+    m_commandsHighWatermark = high;
+    m_commandsLowWatermark = low;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withOverloadPolicy(OverloadPolicy policy, unsigned int downsampleFactor)
+{
+    if (downsampleFactor == 0)
+    {
+        throw std::logic_error("Downsample factor must be greater than 0.");
+    }
+
+    m_overloadPolicy = policy;
+    m_downsampleFactor = downsampleFactor;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReadingFilter(const std::string& reference, const ReadingFilter& filter)
+{
+    m_readingFilters[reference] = filter;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withReadingAggregation(const std::string& reference,
+                                                 const ReadingAggregation& aggregation)
+{
+    m_readingAggregations.erase(reference);
+    m_readingAggregations.emplace(reference, aggregation);
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withHandlerWorkers(unsigned int workers)
+{
+    m_handlerWorkers = workers;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withRegistrationsInFlight(unsigned int registrations,
+                                                    std::chrono::milliseconds responseTimeout)
+{
+    if (responseTimeout.count() <= 0)
+    {
+        throw std::logic_error("Registration response timeout must be positive.");
+    }
+
+    m_registrationsInFlight = registrations;
+    m_registrationResponseTimeout = responseTimeout;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withMetricsCallback(std::function<void(const MetricsSnapshot&)> callback,
+                                              std::chrono::milliseconds interval)
+{
+    if (interval.count() <= 0)
+    {
+        throw std::logic_error("Metrics interval must be positive.");
+    }
+
+    m_metricsCallback = std::move(callback);
+    m_metricsInterval = interval;
+    return *this;
+}
+
+WolkBuilder& WolkBuilder::withActuationTracing(std::shared_ptr<TraceSink> sink, unsigned int sampleEvery)
+{
+    m_traceSink = std::move(sink);
+    m_traceSampleEvery = sampleEvery;
+    return *this;
+}
+
 WolkBuilder& WolkBuilder::withFirmwareUpdate(std::shared_ptr<FirmwareInstaller> installer,
                                              std::shared_ptr<FirmwareVersionProvider> provider)
 {
@@ -167,23 +377,30 @@ std::unique_ptr<Wolk> WolkBuilder::build()
         throw std::logic_error("Actuation handler not set.");
     }
 
-    if (!m_actuatorStatusProviderLambda && !m_actuatorStatusProvider)
+    if (!m_actuatorStatusProviderLambda && !m_actuatorStatusProvider && !m_asyncActuatorStatusProvider)
     {
         throw std::logic_error("Actuator status provider not set.");
     }
 
-    if (!m_deviceStatusProviderLambda && !m_deviceStatusProvider)
+    if (!m_deviceStatusProviderLambda && !m_deviceStatusProvider && !m_asyncDeviceStatusProvider)
     {
         throw std::logic_error("Device status provider not set.");
     }
 
     if ((m_configurationHandlerLambda == nullptr && m_configurationProviderLambda != nullptr) ||
-        (m_configurationHandlerLambda != nullptr && m_configurationProviderLambda == nullptr))
+        (m_configurationHandlerLambda != nullptr && m_configurationProviderLambda == nullptr &&
+         !m_asyncConfigurationProvider))
+    {
+        throw std::logic_error("Both ConfigurationProvider and ConfigurationHandler must be set.");
+    }
+
+    if ((m_configurationHandler && !m_configurationProvider && !m_asyncConfigurationProvider) ||
+        (!m_configurationHandler && m_configurationProvider))
     {
         throw std::logic_error("Both ConfigurationProvider and ConfigurationHandler must be set.");
     }
 
-    if ((m_configurationHandler && !m_configurationProvider) || (!m_configurationHandler && m_configurationProvider))
+    if (m_asyncConfigurationProvider && !m_configurationHandler && !m_configurationHandlerLambda)
     {
         throw std::logic_error("Both ConfigurationProvider and ConfigurationHandler must be set.");
     }
@@ -193,9 +410,41 @@ std::unique_ptr<Wolk> WolkBuilder::build()
         throw std::logic_error("Both FirmwareInstaller and FirmwareVersionProvider must be set.");
     }
 
+    if (m_dataEncoding == DataEncoding::CUSTOM && !m_dataProtocol)
+    {
+        throw std::logic_error("Data protocol not set.");
+    }
+
+    if (m_sensorReadingsEnvelopes &&
+        (m_dataProtocol ? !dynamic_cast<SensorReadingsEnvelopeProtocol*>(m_dataProtocol.get()) :
+                          m_dataEncoding != DataEncoding::MESSAGE_PACK))
+    {
+        throw std::logic_error("Data protocol does not support sensor readings envelopes.");
+    }
+
+    if (m_backlogPublishRate != 0 && m_publishBudget.getMaxMessages() == 0)
+    {
+        throw std::logic_error("Backlog publish rate requires publish budget with message limit.");
+    }
+
     auto wolk = std::unique_ptr<Wolk>(new Wolk());
 
-    wolk->m_dataProtocol.reset(new JsonProtocol());
+    if (m_dataProtocol)
+    {
+        wolk->m_dataProtocol = std::move(m_dataProtocol);
+    }
+    else if (m_dataEncoding == DataEncoding::MESSAGE_PACK)
+    {
+        wolk->m_dataProtocol.reset(new MessagePackProtocol());
+    }
+    else
+    {
+        wolk->m_precompiledJsonProtocol = new PrecompiledJsonProtocol();
+        wolk->m_dataProtocol.reset(wolk->m_precompiledJsonProtocol);
+    }
+
+    wolk->m_dataEncoding = m_dataEncoding;
+
     wolk->m_statusProtocol.reset(new JsonStatusProtocol(false));
     wolk->m_registrationProtocol.reset(new JsonRegistrationProtocol(false));
     wolk->m_firmwareUpdateProtocol.reset(new JsonDFUProtocol());
@@ -205,13 +454,11 @@ std::unique_ptr<Wolk> WolkBuilder::build()
     wolk->m_connectivityService.reset(new MqttConnectivityService(std::make_shared<PahoMqttClient>(), "", "", m_host));
 
     wolk->m_inboundMessageHandler.reset(new InboundGatewayMessageHandler());
+    wolk->m_inboundMessageHandler->setMetrics(wolk->m_metrics);
 
-    wolk->m_connectivityManager = std::make_shared<Wolk::ConnectivityFacade>(*wolk->m_inboundMessageHandler,
-                                                                             [&]
-                                                                             {
-                                                                                 wolk->m_connected = false;
-                                                                                 wolk->connect();
-                                                                             });
+    const auto wolkPointer = wolk.get();
+    wolk->m_connectivityManager = std::make_shared<Wolk::ConnectivityFacade>(
+      *wolk->m_inboundMessageHandler, [wolkPointer] { wolkPointer->handleConnectionLost(); });
 
     wolk->m_connectivityService->setListener(wolk->m_connectivityManager);
 
@@ -220,15 +467,50 @@ std::unique_ptr<Wolk> WolkBuilder::build()
 
     wolk->m_actuatorStatusProvider = m_actuatorStatusProvider;
     wolk->m_actuatorStatusProviderLambda = m_actuatorStatusProviderLambda;
+    wolk->m_asyncActuatorStatusProvider = m_asyncActuatorStatusProvider;
 
     wolk->m_configurationHandler = m_configurationHandler;
     wolk->m_configurationHandlerLambda = m_configurationHandlerLambda;
 
     wolk->m_configurationProvider = m_configurationProvider;
     wolk->m_configurationProviderLambda = m_configurationProviderLambda;
+    wolk->m_asyncConfigurationProvider = m_asyncConfigurationProvider;
 
     wolk->m_deviceStatusProvider = m_deviceStatusProvider;
     wolk->m_deviceStatusProviderLambda = m_deviceStatusProviderLambda;
+    wolk->m_asyncDeviceStatusProvider = m_asyncDeviceStatusProvider;
+
+    wolk->m_publishBudget = m_publishBudget;
+    wolk->m_backlogPublishBudget = m_publishBudget;
+    if (m_backlogPublishRate != 0)
+    {
+        wolk->m_backlogPublishInterval = std::chrono::milliseconds{
+          std::max(1ull, 1000ull * m_publishBudget.getMaxMessages() / m_backlogPublishRate)};
+    }
+
+    for (const auto category : wolk->m_publishPriorities)
+    {
+        if (std::find(m_publishPriorities.begin(), m_publishPriorities.end(), category) == m_publishPriorities.end())
+        {
+            m_publishPriorities.push_back(category);
+        }
+    }
+    wolk->m_publishPriorities = m_publishPriorities;
+
+    wolk->m_actuatorStatusesCoalescingInterval = m_actuatorStatusesCoalescingInterval;
+    wolk->m_reconnectBackoff = ExponentialBackoff{m_initialReconnectDelay, m_maxReconnectDelay};
+
+    wolk->m_readingsWatermark.setLevels(m_readingsHighWatermark, m_readingsLowWatermark);
+    wolk->m_commandsWatermark.setLevels(m_commandsHighWatermark, m_commandsLowWatermark);
+    wolk->m_overloadPolicy = m_overloadPolicy;
+    wolk->m_downsampleFactor = m_downsampleFactor;
+
+    wolk->m_registrationPipeline.setLimits(m_registrationsInFlight, m_registrationResponseTimeout);
+
+    if (m_handlerWorkers != 0)
+    {
+        wolk->m_handlerExecutor.reset(new ShardedCommandExecutor(m_handlerWorkers));
+    }
 
     if (m_registrationResponseHandler)
         wolk->m_registrationResponseHandler = m_registrationResponseHandler;
@@ -237,13 +519,45 @@ std::unique_ptr<Wolk> WolkBuilder::build()
 
     wolk->m_dataService = std::make_shared<DataService>(
       *wolk->m_dataProtocol, *wolk->m_persistence, *wolk->m_connectivityService,
-      [rawPointer](const std::string& key, const std::string& reference, const std::string& value)
-      { rawPointer->handleActuatorSetCommand(key, reference, value); },
+      [rawPointer](const std::string& key, const std::string& reference, const std::string& value,
+                   std::shared_ptr<ActuationTrace> trace)
+      { rawPointer->handleActuatorSetCommand(key, reference, value, std::move(trace)); },
       [rawPointer](const std::string& key, const std::string& reference)
       { rawPointer->handleActuatorGetCommand(key, reference); },
       [rawPointer](const std::string& key, const std::vector<ConfigurationItem>& configuration)
       { rawPointer->handleConfigurationSetCommand(key, configuration); },
-      [rawPointer](const std::string& key) { rawPointer->handleConfigurationGetCommand(key); });
+      [rawPointer](const std::string& key) { rawPointer->handleConfigurationGetCommand(key); },
+      m_publishBatchItemsCount, m_publishBatchMaxBytes);
+    wolk->m_dataService->setMetrics(wolk->m_metrics);
+
+    if (m_sensorReadingsEnvelopes)
+    {
+        wolk->m_dataService->setSensorReadingsEnvelopes(
+          dynamic_cast<SensorReadingsEnvelopeProtocol&>(*wolk->m_dataProtocol), m_sensorReadingsEnvelopesAcrossDevices);
+    }
+
+    if (m_traceSink)
+    {
+        wolk->m_actuationTracer.reset(new ActuationTracer(m_traceSink, m_traceSampleEvery));
+        wolk->m_dataService->setTracer(*wolk->m_actuationTracer);
+    }
+
+    for (const auto& kvp : m_readingFilters)
+    {
+        wolk->m_dataService->setReadingFilter(kvp.first, kvp.second);
+    }
+
+    if (!m_readingAggregations.empty())
+    {
+        auto closeInterval = m_readingAggregations.begin()->second.getHop();
+        for (const auto& kvp : m_readingAggregations)
+        {
+            wolk->m_dataService->setReadingAggregation(kvp.first, kvp.second);
+            closeInterval = std::min(closeInterval, kvp.second.getHop());
+        }
+
+        wolk->m_aggregationTimer.run(closeInterval, [rawPointer] { rawPointer->closeAggregationWindows(); });
+    }
 
     wolk->m_deviceStatusService = std::make_shared<DeviceStatusService>(
       *wolk->m_statusProtocol, *wolk->m_connectivityService,
@@ -262,6 +576,7 @@ std::unique_ptr<Wolk> WolkBuilder::build()
         wolk->m_firmwareUpdateService =
           std::make_shared<FirmwareUpdateService>(*wolk->m_firmwareUpdateProtocol, m_firmwareInstaller,
                                                   m_firmwareVersionProvider, *wolk->m_connectivityService);
+        wolk->m_firmwareUpdateService->setMetrics(wolk->m_metrics);
 
         wolk->m_inboundMessageHandler->addListener(wolk->m_firmwareUpdateService);
     }
@@ -288,6 +603,21 @@ std::unique_ptr<Wolk> WolkBuilder::build()
 
     wolk->m_connectivityService->setListener(wolk->m_connectivityManager);
 
+    if (m_registrationsInFlight != 0)
+    {
+        // deadlines are checked a few times per timeout, so a slot is not held much longer than the timeout
+        wolk->m_registrationTimeoutTimer.run(
+          std::max(std::chrono::milliseconds{1}, m_registrationResponseTimeout / REGISTRATION_DEADLINE_CHECKS),
+          [rawPointer] { rawPointer->expireRegistrations(); });
+    }
+
+    if (m_metricsCallback)
+    {
+        const auto metricsCallback = m_metricsCallback;
+        wolk->m_metricsTimer.run(m_metricsInterval,
+                                 [rawPointer, metricsCallback] { metricsCallback(rawPointer->getMetrics()); });
+    }
+
     return wolk;
 }
 
@@ -309,6 +639,30 @@ WolkBuilder::WolkBuilder()
 , m_deviceStatusProviderLambda{nullptr}
 , m_deviceStatusProvider{nullptr}
 , m_persistence{new InMemoryPersistence()}
+, m_dataProtocol{nullptr}
+, m_dataEncoding{DataEncoding::JSON}
+, m_publishBatchItemsCount{DataService::PUBLISH_BATCH_ITEMS_COUNT}
+, m_publishBatchMaxBytes{0}
+, m_sensorReadingsEnvelopes{false}
+, m_sensorReadingsEnvelopesAcrossDevices{false}
+, m_publishBudget{Wolk::PUBLISH_BACKLOG_MESSAGES_PER_PASS}
+, m_backlogPublishRate{0}
+, m_actuatorStatusesCoalescingInterval{0}
+, m_initialReconnectDelay{Wolk::INITIAL_RECONNECT_DELAY_MS}
+, m_maxReconnectDelay{Wolk::MAX_RECONNECT_DELAY_MS}
+, m_readingsHighWatermark{0}
+, m_readingsLowWatermark{0}
+, m_commandsHighWatermark{0}
+, m_commandsLowWatermark{0}
+, m_overloadPolicy{OverloadPolicy::DROP_NEWEST}
+, m_downsampleFactor{2}
+, m_handlerWorkers{0}
+, m_registrationsInFlight{0}
+, m_registrationResponseTimeout{DEFAULT_REGISTRATION_RESPONSE_TIMEOUT_MS}
+, m_metricsCallback{nullptr}
+, m_metricsInterval{0}
+, m_traceSink{nullptr}
+, m_traceSampleEvery{1}
 , m_firmwareInstaller{nullptr}
 , m_firmwareVersionProvider{nullptr}
 {
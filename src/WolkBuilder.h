@@ -19,30 +19,45 @@
 
 #include "ActuationHandlerPerDevice.h"
 #include "ActuatorStatusProviderPerDevice.h"
+#include "AsyncActuatorStatusProvider.h"
+#include "AsyncConfigurationProvider.h"
+#include "AsyncDeviceStatusProvider.h"
 #include "ConfigurationHandlerPerDevice.h"
 #include "ConfigurationProviderPerDevice.h"
 #include "DeviceStatusProvider.h"
 #include "FirmwareInstaller.h"
 #include "FirmwareVersionProvider.h"
+#include "TraceSink.h"
 #include "api/PlatformStatusListener.h"
 #include "core/connectivity/ConnectivityService.h"
 #include "core/model/ActuatorStatus.h"
 #include "core/model/DeviceStatus.h"
 #include "core/model/PlatformResult.h"
 #include "core/persistence/Persistence.h"
+#include "core/protocol/DataProtocol.h"
 #include "core/protocol/FirmwareUpdateProtocol.h"
 #include "model/Device.h"
+#include "model/MetricsSnapshot.h"
+#include "model/OverloadPolicy.h"
+#include "model/PublishBudget.h"
+#include "model/PublishCategory.h"
+#include "model/ReadingAggregation.h"
+#include "model/ReadingFilter.h"
+#include "protocol/DataEncoding.h"
 #include "service/PlatformStatusService.h"
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace wolkabout
 {
 class Wolk;
-class DataProtocol;
 class StatusProtocol;
 class RegistrationProtocol;
 
@@ -104,6 +119,16 @@ public:
      */
     WolkBuilder& actuatorStatusProvider(std::shared_ptr<ActuatorStatusProviderPerDevice> actuatorStatusProvider);
 
+    /**
+     * @brief Sets asynchronous actuation status provider<br>
+     *        Statuses are published as they are reported, so reads of many actuators can be in progress at once
+     * @param actuatorStatusProvider Implementation that reports ActuatorStatus
+     * by reference of requested actuator
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     */
+    WolkBuilder& actuatorStatusProvider(std::shared_ptr<AsyncActuatorStatusProvider> actuatorStatusProvider);
+
     /**
      * @brief Sets device configuration handler
      * @param configurationHandler Lambda that handles setting of configuration
@@ -135,6 +160,14 @@ public:
      */
     WolkBuilder& configurationProvider(std::shared_ptr<ConfigurationProviderPerDevice> configurationProvider);
 
+    /**
+     * @brief Sets asynchronous device configuration provider<br>
+     *        Configurations are published as they are reported
+     * @param configurationProvider Instance of wolkabout::AsyncConfigurationProvider that reports device configuration
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides fluent interface)
+     */
+    WolkBuilder& configurationProvider(std::shared_ptr<AsyncConfigurationProvider> configurationProvider);
+
     /**
      * @brief Sets device status provider
      * @param deviceStatusProvider Callable that provides DeviceStatus by device
@@ -154,6 +187,16 @@ public:
      */
     WolkBuilder& deviceStatusProvider(std::shared_ptr<DeviceStatusProvider> deviceStatusProvider);
 
+    /**
+     * @brief Sets asynchronous device status provider<br>
+     *        Statuses are published as they are reported
+     * @param deviceStatusProvider Implementation that reports DeviceStatus
+     * by device key
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     */
+    WolkBuilder& deviceStatusProvider(std::shared_ptr<AsyncDeviceStatusProvider> deviceStatusProvider);
+
     /**
      * @brief Sets underlying persistence mechanism to be used<br>
      *        Sample in-memory persistence is used as default
@@ -171,6 +214,224 @@ public:
      */
     WolkBuilder& withDataProtocol(std::unique_ptr<DataProtocol> protocol);
 
+    /**
+     * @brief withDataEncoding Selects one of provided data protocols<br>
+     *        JSON is used by default, MessagePack produces smaller payloads on the same channels
+     * @param encoding wolkabout::DataEncoding::JSON or wolkabout::DataEncoding::MESSAGE_PACK
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if encoding is wolkabout::DataEncoding::CUSTOM
+     */
+    WolkBuilder& withDataEncoding(DataEncoding encoding);
+
+    /**
+     * @brief withPublishBatchLimits Bounds the size of messages in which persisted sensor readings and alarms
+     *        are published<br>
+     *        Batch is shrunk until it fits the byte limit, single item is always published as is
+     * @param maxItems Maximum number of items published in a single message
+     * @param maxBytes Maximum size of a single message (topic and payload) in bytes, 0 for unlimited
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if maxItems is 0
+     */
+    WolkBuilder& withPublishBatchLimits(unsigned int maxItems, std::size_t maxBytes = 0);
+
+    /**
+     * @brief withSensorReadingsEnvelopes Publishes persisted readings of many sensors in a single message,
+     *        bounded by limits set with withPublishBatchLimits, instead of a message per sensor<br>
+     *        Envelopes are published on their own channel, and require gateway which accepts them
+     * @param acrossDevices Whether readings of different devices are packed into the same envelope
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error on build if data protocol does not make envelopes,
+     *         of provided protocols only wolkabout::DataEncoding::MESSAGE_PACK does
+     */
+    WolkBuilder& withSensorReadingsEnvelopes(bool acrossDevices = false);
+
+    /**
+     * @brief withPublishBudget Limits amount of persisted alarms and sensor readings published in a single pass<br>
+     *        Remaining data is published in following passes, interleaved with other commands
+     *        (actuations, configuration, status requests)<br>
+     *        Zero value of any limit means that limit is not applied, by default pass is limited to 100 messages
+     * @param maxMessages Maximum number of messages published in a single pass
+     * @param maxBytes Maximum number of payload bytes published in a single pass
+     * @param maxDuration Maximum duration of a single pass
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     */
+    WolkBuilder& withPublishBudget(unsigned int maxMessages, std::size_t maxBytes = 0,
+                                   std::chrono::milliseconds maxDuration = std::chrono::milliseconds{0});
+
+    /**
+     * @brief withBacklogPublishRate Throttles publishing of sensor readings backlog<br>
+     *        Backlog is published with a budget of its own, set by withPublishBudget, in passes spaced
+     *        so that on average messagesPerSecond messages are published. Other categories are not throttled
+     * @param messagesPerSecond Target publish rate, 0 to publish passes back to back
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error on build if rate is set, and publish budget has no message limit
+     */
+    WolkBuilder& withBacklogPublishRate(unsigned int messagesPerSecond);
+
+    /**
+     * @brief withPublishPriorities Sets order in which persisted data is published after connection is
+     *        established, and on wolkabout::Wolk::publish<br>
+     *        Categories that are not listed follow the listed ones, in default order: alarms, actuator statuses,
+     *        configurations, sensor readings, sensor readings backlog. Backlog is published only once
+     *        categories before it are drained, at rate set by withBacklogPublishRate
+     * @param priorities Categories ordered from highest to lowest priority
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if category is listed more than once
+     */
+    WolkBuilder& withPublishPriorities(std::vector<PublishCategory> priorities);
+
+    /**
+     * @brief withActuatorStatusCoalescing Delays publishing of actuator statuses, so that statuses reported
+     *        in the meantime are published together, and only the latest status of each actuator is published<br>
+     *        By default statuses are published as soon as commands queued before them are executed
+     * @param interval Time for which statuses are collected before they are published
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     */
+    WolkBuilder& withActuatorStatusCoalescing(std::chrono::milliseconds interval);
+
+    /**
+     * @brief withReconnectBackoff Sets delays between failed connection attempts<br>
+     *        Delay doubles after each failed attempt up to maxDelay, and is randomized to between
+     *        half and full value. By default it starts at 2 seconds, up to 1 minute
+     * @param initialDelay Delay after first failed attempt
+     * @param maxDelay Longest delay
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if initialDelay is not positive, or maxDelay is below initialDelay
+     */
+    WolkBuilder& withReconnectBackoff(std::chrono::milliseconds initialDelay, std::chrono::milliseconds maxDelay);
+
+    /**
+     * @brief withReadingsWatermarks Limits number of persisted sensor readings awaiting publish<br>
+     *        When high watermark is reached overload policy applies to added readings,
+     *        until number of buffered readings drops to low watermark
+     * @param high Number of buffered readings at which overload policy starts to apply
+     * @param low Number of buffered readings at which overload policy stops to apply
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if high is 0, or low is not below high
+     */
+    WolkBuilder& withReadingsWatermarks(std::size_t high, std::size_t low);
+
+    /**
+     * @brief withCommandsWatermarks Limits number of commands (readings, alarms, inbound messages...)
+     *        awaiting execution<br>
+     *        When high watermark is reached overload policy applies to added readings,
+     *        until number of queued commands drops to low watermark
+     * @param high Number of queued commands at which overload policy starts to apply
+     * @param low Number of queued commands at which overload policy stops to apply
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if high is 0, or low is not below high
+     */
+    WolkBuilder& withCommandsWatermarks(std::size_t high, std::size_t low);
+
+    /**
+     * @brief withOverloadPolicy Defines how sensor readings are handled while a watermark is exceeded<br>
+     *        wolkabout::OverloadPolicy::DROP_NEWEST is used by default<br>
+     *        Wolk::addSensorReading returns false for rejected readings, so that producers can throttle
+     * @param policy wolkabout::OverloadPolicy
+     * @param downsampleFactor For wolkabout::OverloadPolicy::DOWNSAMPLE one of every downsampleFactor readings
+     *                         of each sensor is accepted
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if downsampleFactor is 0
+     */
+    WolkBuilder& withOverloadPolicy(OverloadPolicy policy, unsigned int downsampleFactor = 2);
+
+    /**
+     * @brief withReadingFilter Filters readings of sensors with given reference before they are persisted,
+     *        so that only readings that carry new information are published<br>
+     *        Applies to sensor of every device created from sensor template with given reference
+     * @param reference Sensor template reference
+     * @param filter wolkabout::ReadingFilter, replaces filter previously set for reference
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     */
+    WolkBuilder& withReadingFilter(const std::string& reference, const ReadingFilter& filter);
+
+    /**
+     * @brief withReadingAggregation Aggregates numeric readings of sensors with given reference in windows,
+     *        and persists only minimum, maximum, mean, count and last value of each window when it closes<br>
+     *        Applies to sensor of every device created from sensor template with given reference<br>
+     *        Readings of aggregated sensors are not filtered
+     * @param reference Sensor template reference
+     * @param aggregation wolkabout::ReadingAggregation, replaces aggregation previously set for reference
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error on build if aggregation window is not a multiple of its hop
+     */
+    WolkBuilder& withReadingAggregation(const std::string& reference, const ReadingAggregation& aggregation);
+
+    /**
+     * @brief withHandlerWorkers Runs actuation and configuration handlers, and actuator status,
+     *        configuration and device status providers on a pool of worker threads<br>
+     *        Commands for the same device are handled by the same worker in order of arrival,
+     *        while different devices are handled in parallel, so handlers and providers must be thread safe.<br>
+     *        By default handlers and providers run one at a time, together with all other commands
+     * @param workers Number of worker threads, 0 to run handlers together with other commands
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     */
+    WolkBuilder& withHandlerWorkers(unsigned int workers);
+
+    /**
+     * @brief withRegistrationsInFlight Limits number of device registration requests awaiting response<br>
+     *        Further requests are published as responses arrive, so that registration of many devices
+     *        does not flood the platform. By default all requests are published at once<br>
+     *        Request that gets no response within timeout frees its slot, and is published again later
+     * @param registrations Maximum number of requests awaiting response, 0 for no limit
+     * @param responseTimeout Time to wait for registration response
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if responseTimeout is not positive
+     */
+    WolkBuilder& withRegistrationsInFlight(
+      unsigned int registrations,
+      std::chrono::milliseconds responseTimeout = std::chrono::milliseconds{DEFAULT_REGISTRATION_RESPONSE_TIMEOUT_MS});
+
+    /**
+     * @brief withMetricsCallback Periodically reports metrics, same as returned by Wolk::getMetrics<br>
+     *        Callback is invoked on a timer thread, and should return promptly
+     * @param callback Receives snapshot of metrics
+     * @param interval Time between snapshots
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     *
+     * @throws std::logic_error if interval is not positive
+     */
+    WolkBuilder& withMetricsCallback(std::function<void(const MetricsSnapshot&)> callback,
+                                     std::chrono::milliseconds interval);
+
+    /**
+     * @brief withActuationTracing Traces actuations, from receiving actuator set command to publishing
+     *        resulting actuator status, timing each stage of handling in between<br>
+     *        See wolkabout::InMemoryTraceSink and wolkabout::ChromeTraceSink
+     * @param sink Receives finished traces
+     * @param sampleEvery Only every n-th actuation is traced
+     * @return Reference to current wolkabout::WolkBuilder instance (Provides
+     * fluent interface)
+     */
+    WolkBuilder& withActuationTracing(std::shared_ptr<TraceSink> sink, unsigned int sampleEvery = 1);
+
     /**
      * @brief withFirmwareUpdate Enables firmware update for devices
      * @param installer Instance of wolkabout::FirmwareInstaller used to install firmware
@@ -231,6 +492,7 @@ private:
 
     std::function<ActuatorStatus(const std::string&, const std::string&)> m_actuatorStatusProviderLambda;
     std::shared_ptr<ActuatorStatusProviderPerDevice> m_actuatorStatusProvider;
+    std::shared_ptr<AsyncActuatorStatusProvider> m_asyncActuatorStatusProvider;
 
     std::function<void(const std::string&, const std::vector<ConfigurationItem>& configuration)>
       m_configurationHandlerLambda;
@@ -238,12 +500,53 @@ private:
 
     std::function<std::vector<ConfigurationItem>(const std::string&)> m_configurationProviderLambda;
     std::shared_ptr<ConfigurationProviderPerDevice> m_configurationProvider;
+    std::shared_ptr<AsyncConfigurationProvider> m_asyncConfigurationProvider;
 
     std::function<DeviceStatus::Status(const std::string&)> m_deviceStatusProviderLambda;
     std::shared_ptr<DeviceStatusProvider> m_deviceStatusProvider;
+    std::shared_ptr<AsyncDeviceStatusProvider> m_asyncDeviceStatusProvider;
 
     std::unique_ptr<Persistence> m_persistence;
 
+    std::unique_ptr<DataProtocol> m_dataProtocol;
+    DataEncoding m_dataEncoding;
+
+    unsigned int m_publishBatchItemsCount;
+    std::size_t m_publishBatchMaxBytes;
+
+    bool m_sensorReadingsEnvelopes;
+    bool m_sensorReadingsEnvelopesAcrossDevices;
+
+    PublishBudget m_publishBudget;
+    unsigned int m_backlogPublishRate;
+    std::vector<PublishCategory> m_publishPriorities;
+
+    std::chrono::milliseconds m_actuatorStatusesCoalescingInterval;
+
+    std::chrono::milliseconds m_initialReconnectDelay;
+    std::chrono::milliseconds m_maxReconnectDelay;
+
+    std::size_t m_readingsHighWatermark;
+    std::size_t m_readingsLowWatermark;
+    std::size_t m_commandsHighWatermark;
+    std::size_t m_commandsLowWatermark;
+    OverloadPolicy m_overloadPolicy;
+    unsigned int m_downsampleFactor;
+
+    std::map<std::string, ReadingFilter> m_readingFilters;
+    std::map<std::string, ReadingAggregation> m_readingAggregations;
+
+    unsigned int m_handlerWorkers;
+
+    unsigned int m_registrationsInFlight;
+    std::chrono::milliseconds m_registrationResponseTimeout;
+
+    std::function<void(const MetricsSnapshot&)> m_metricsCallback;
+    std::chrono::milliseconds m_metricsInterval;
+
+    std::shared_ptr<TraceSink> m_traceSink;
+    unsigned int m_traceSampleEvery;
+
     std::shared_ptr<FirmwareInstaller> m_firmwareInstaller;
     std::shared_ptr<FirmwareVersionProvider> m_firmwareVersionProvider;
 
@@ -251,6 +554,8 @@ private:
     PlatformStatusCallback m_platformStatusCallback;
 
     static const constexpr char* MESSAGE_BUS_HOST = "tcp://localhost:1883";
+    static const constexpr unsigned int DEFAULT_REGISTRATION_RESPONSE_TIMEOUT_MS = 30000;
+    static const constexpr unsigned int REGISTRATION_DEADLINE_CHECKS = 4;
 };
 }    // namespace wolkabout
 
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ACTUATIONTRACE_H
+#define ACTUATIONTRACE_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Stages of handling an actuation, in order in which they occur
+ */
+enum class TraceHop
+{
+    // parsing actuator set message and handing command over to Wolk
+    INBOUND_RECEIVE,
+
+    // waiting in Wolk command queue
+    COMMAND_QUEUE,
+
+    // waiting for handler worker, empty when handlers are not invoked on workers
+    HANDLER_QUEUE,
+
+    // user actuation handler
+    ACTUATION_HANDLER,
+
+    // from requesting actuator status until provider reports it
+    STATUS_PROVIDER,
+
+    // waiting in Wolk command queue with reported status
+    RESULT_QUEUE,
+
+    // from persisting actuator status until it is published, including coalescing interval
+    PUBLISH
+};
+
+struct TraceSpan
+{
+    TraceHop hop;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+};
+
+/**
+ * @brief Timeline of a single actuation, from actuator set command to publish of resulting actuator status.<br>
+ *        Trace that ends before PUBLISH span belongs to a command that was dropped, or whose status
+ *        was superseded by a later one before it was published.
+ */
+struct ActuationTrace
+{
+    unsigned long long int id;
+
+    std::string deviceKey;
+    std::string reference;
+    std::string value;
+
+    std::vector<TraceSpan> spans;
+};
+}    // namespace wolkabout
+
+#endif    // ACTUATIONTRACE_H
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CONNECTIONSTATISTICS_H
+#define CONNECTIONSTATISTICS_H
+
+#include <chrono>
+
+namespace wolkabout
+{
+/**
+ * @brief Snapshot of connection attempts made since wolkabout::Wolk was created
+ */
+struct ConnectionStatistics
+{
+    unsigned long long int connectAttempts;
+    unsigned long long int failedConnectAttempts;
+    unsigned long long int connectionsLost;
+
+    // delay of scheduled reconnect attempt, 0 if none is scheduled
+    std::chrono::milliseconds reconnectDelay;
+};
+}    // namespace wolkabout
+
+#endif    // CONNECTIONSTATISTICS_H
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/DeviceAssetIndex.h"
+
+#include "core/model/DeviceTemplate.h"
+
+namespace wolkabout
+{
+DeviceAssetIndex::DeviceAssetIndex(const DeviceTemplate& deviceTemplate)
+{
+    for (const auto& sensor : deviceTemplate.getSensors())
+    {
+        addSensor(sensor.getReference());
+    }
+
+    for (const auto& alarm : deviceTemplate.getAlarms())
+    {
+        addAlarm(alarm.getReference());
+    }
+
+    for (const auto& actuator : deviceTemplate.getActuators())
+    {
+        addActuator(actuator.getReference());
+    }
+
+    for (const auto& configurationItem : deviceTemplate.getConfigurations())
+    {
+        addConfigurationItem(configurationItem.getReference());
+    }
+}
+
+void DeviceAssetIndex::addSensor(const std::string& reference)
+{
+    m_sensors.insert(reference);
+}
+
+void DeviceAssetIndex::addAlarm(const std::string& reference)
+{
+    m_alarms.insert(reference);
+}
+
+void DeviceAssetIndex::addActuator(const std::string& reference)
+{
+    if (m_actuators.insert(reference).second)
+    {
+        m_actuatorReferences.push_back(reference);
+    }
+}
+
+void DeviceAssetIndex::addConfigurationItem(const std::string& reference)
+{
+    m_configurationItems.insert(reference);
+}
+
+bool DeviceAssetIndex::hasSensor(const std::string& reference) const
+{
+    return m_sensors.find(reference) != m_sensors.end();
+}
+
+bool DeviceAssetIndex::hasAlarm(const std::string& reference) const
+{
+    return m_alarms.find(reference) != m_alarms.end();
+}
+
+bool DeviceAssetIndex::hasActuator(const std::string& reference) const
+{
+    return m_actuators.find(reference) != m_actuators.end();
+}
+
+bool DeviceAssetIndex::hasConfigurationItem(const std::string& reference) const
+{
+    return m_configurationItems.find(reference) != m_configurationItems.end();
+}
+
+const std::vector<std::string>& DeviceAssetIndex::getActuatorReferences() const
+{
+    return m_actuatorReferences;
+}
+}    // namespace wolkabout
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICEASSETINDEX_H
+#define DEVICEASSETINDEX_H
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace wolkabout
+{
+class DeviceTemplate;
+
+/**
+ * @brief Lookup table of asset references defined in device template.<br>
+ *        Used to validate readings, alarms, actuations and configuration without
+ *        copying and scanning the template on every call.
+ */
+class DeviceAssetIndex
+{
+public:
+    DeviceAssetIndex() = default;
+
+    explicit DeviceAssetIndex(const DeviceTemplate& deviceTemplate);
+
+    void addSensor(const std::string& reference);
+    void addAlarm(const std::string& reference);
+    void addActuator(const std::string& reference);
+    void addConfigurationItem(const std::string& reference);
+
+    bool hasSensor(const std::string& reference) const;
+    bool hasAlarm(const std::string& reference) const;
+    bool hasActuator(const std::string& reference) const;
+    bool hasConfigurationItem(const std::string& reference) const;
+
+    const std::vector<std::string>& getActuatorReferences() const;
+
+private:
+    std::unordered_set<std::string> m_sensors;
+    std::unordered_set<std::string> m_alarms;
+    std::unordered_set<std::string> m_actuators;
+    std::unordered_set<std::string> m_configurationItems;
+
+    // kept in template order, as actuator statuses are published by iterating over them
+    std::vector<std::string> m_actuatorReferences;
+};
+}    // namespace wolkabout
+
+#endif    // DEVICEASSETINDEX_H
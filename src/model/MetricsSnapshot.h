@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef METRICSSNAPSHOT_H
+#define METRICSSNAPSHOT_H
+
+#include <map>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Summary of a latency histogram, values are in microseconds.<br>
+ *        Percentiles are upper bounds of histogram buckets, within about 6% of the recorded value.
+ */
+struct HistogramSnapshot
+{
+    unsigned long long int count;
+    unsigned long long int min;
+    unsigned long long int max;
+    double mean;
+
+    unsigned long long int p50;
+    unsigned long long int p90;
+    unsigned long long int p99;
+    unsigned long long int p999;
+};
+
+/**
+ * @brief Values of all metrics at the time snapshot was taken, by metric name
+ */
+struct MetricsSnapshot
+{
+    std::map<std::string, unsigned long long int> counters;
+    std::map<std::string, long long int> gauges;
+    std::map<std::string, HistogramSnapshot> histograms;
+};
+}    // namespace wolkabout
+
+#endif    // METRICSSNAPSHOT_H
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OVERLOADPOLICY_H
+#define OVERLOADPOLICY_H
+
+namespace wolkabout
+{
+/**
+ * @brief Handling of sensor readings added while buffered readings or queued commands are above high watermark.<br>
+ *        Policy applies until both drop to their low watermarks.
+ */
+enum class OverloadPolicy
+{
+    // caller waits until load drops to low watermark
+    BLOCK,
+
+    // reading is accepted, and the oldest buffered reading of the same sensor is discarded
+    DROP_OLDEST,
+
+    // reading is rejected
+    DROP_NEWEST,
+
+    // only every n-th reading of each sensor is accepted, others are rejected
+    DOWNSAMPLE
+};
+}    // namespace wolkabout
+
+#endif    // OVERLOADPOLICY_H
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/PersistenceKeyIndex.h"
+
+#include <cassert>
+#include <utility>
+
+namespace wolkabout
+{
+const constexpr char PersistenceKeyIndex::ESCAPE;
+
+PersistenceKeyIndex::PersistenceKeyIndex(std::string delimiter) : m_delimiter{std::move(delimiter)} {}
+
+const std::string& PersistenceKeyIndex::getKey(const std::string& deviceKey, const std::string& reference)
+{
+    auto deviceIt = m_devices.find(deviceKey);
+    if (deviceIt != m_devices.end())
+    {
+        auto keyIt = deviceIt->second.byReference.find(reference);
+        if (keyIt != deviceIt->second.byReference.end())
+        {
+            return keyIt->second;
+        }
+    }
+
+    std::string key;
+    key.reserve(deviceKey.size() + m_delimiter.size() + reference.size());
+    appendEscaped(key, deviceKey);
+    key += m_delimiter;
+    appendEscaped(key, reference);
+
+    // escaped key splits back only into this device key and reference, so it is never owned by another pair
+    const std::string* insertedKey = insertKey(deviceKey, reference, key);
+    assert(insertedKey);
+
+    return *insertedKey;
+}
+
+bool PersistenceKeyIndex::addKey(const std::string& key)
+{
+    if (m_owners.find(key) != m_owners.end())
+    {
+        return true;
+    }
+
+    const auto pos = findDelimiter(key);
+    if (pos == std::string::npos || pos == 0 || pos + m_delimiter.size() == key.size())
+    {
+        return false;
+    }
+
+    return insertKey(unescape(key, 0, pos), unescape(key, pos + m_delimiter.size(), key.size()), key) != nullptr;
+}
+
+const std::string* PersistenceKeyIndex::getDeviceKey(const std::string& key) const
+{
+    auto it = m_owners.find(key);
+    return it != m_owners.end() ? &it->second.deviceKey : nullptr;
+}
+
+const std::string* PersistenceKeyIndex::findKey(const std::string& key) const
+{
+    auto ownerIt = m_owners.find(key);
+    if (ownerIt == m_owners.end())
+    {
+        return nullptr;
+    }
+
+    const auto& byReference = m_devices.find(ownerIt->second.deviceKey)->second.byReference;
+    auto keyIt = byReference.find(ownerIt->second.reference);
+    return keyIt != byReference.end() ? &keyIt->second : nullptr;
+}
+
+const std::vector<std::string>& PersistenceKeyIndex::getKeys(const std::string& deviceKey) const
+{
+    static const std::vector<std::string> noKeys;
+
+    auto it = m_devices.find(deviceKey);
+    return it != m_devices.end() ? it->second.keys : noKeys;
+}
+
+const std::string* PersistenceKeyIndex::insertKey(const std::string& deviceKey, const std::string& reference,
+                                                  const std::string& key)
+{
+    auto& deviceKeys = m_devices[deviceKey];
+    if (deviceKeys.byReference.find(reference) != deviceKeys.byReference.end())
+    {
+        // device asset already has its key, readings of both would be mixed
+        return nullptr;
+    }
+
+    if (!m_owners.emplace(key, KeyOwner{deviceKey, reference}).second)
+    {
+        return nullptr;
+    }
+
+    deviceKeys.keys.push_back(key);
+    return &deviceKeys.byReference.emplace(reference, key).first->second;
+}
+
+void PersistenceKeyIndex::appendEscaped(std::string& key, const std::string& part) const
+{
+    for (std::size_t i = 0; i < part.size();)
+    {
+        if (part[i] == ESCAPE)
+        {
+            key += ESCAPE;
+            key += ESCAPE;
+            ++i;
+        }
+        else if (part.compare(i, m_delimiter.size(), m_delimiter) == 0)
+        {
+            key += ESCAPE;
+            key += m_delimiter;
+            i += m_delimiter.size();
+        }
+        else
+        {
+            key += part[i++];
+        }
+    }
+}
+
+std::string PersistenceKeyIndex::unescape(const std::string& key, std::size_t begin, std::size_t end) const
+{
+    std::string part;
+    part.reserve(end - begin);
+
+    for (std::size_t i = begin; i < end;)
+    {
+        if (key[i] == ESCAPE && i + 1 < end)
+        {
+            const std::size_t escapedSize = key.compare(i + 1, m_delimiter.size(), m_delimiter) == 0 ?
+                                              m_delimiter.size() :
+                                              1;
+            part.append(key, i + 1, escapedSize);
+            i += 1 + escapedSize;
+        }
+        else
+        {
+            part += key[i++];
+        }
+    }
+
+    return part;
+}
+
+std::size_t PersistenceKeyIndex::findDelimiter(const std::string& key) const
+{
+    for (std::size_t i = 0; i < key.size();)
+    {
+        if (key[i] == ESCAPE)
+        {
+            i += key.compare(i + 1, m_delimiter.size(), m_delimiter) == 0 ? 1 + m_delimiter.size() : 2;
+        }
+        else if (key.compare(i, m_delimiter.size(), m_delimiter) == 0)
+        {
+            return i;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return std::string::npos;
+}
+}    // namespace wolkabout
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PERSISTENCEKEYINDEX_H
+#define PERSISTENCEKEYINDEX_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Interned persistence keys, grouped per device.<br>
+ *        Key of a device and reference is built once, after which it is found by lookup,
+ *        and device key of a persistence key is resolved without parsing.<br>
+ *        Delimiter and escape character within device key and reference are escaped with a backslash,
+ *        so that distinct device and reference pairs never share a key. Keys of device keys and references
+ *        without them are the same as unescaped ones.
+ */
+class PersistenceKeyIndex
+{
+public:
+    explicit PersistenceKeyIndex(std::string delimiter);
+
+    /**
+     * @brief Returns persistence key of device asset, creating it on first use
+     * @param deviceKey Device key
+     * @param reference Asset reference
+     * @return Persistence key, valid for lifetime of index
+     */
+    const std::string& getKey(const std::string& deviceKey, const std::string& reference);
+
+    /**
+     * @brief Adds persistence key created outside of index, ie. found in persistence on startup<br>
+     *        Key is split at first delimiter that is not escaped
+     * @param key Persistence key
+     * @return false if key can not be split into device key and reference, or if its device key and reference
+     *         already have another key
+     */
+    bool addKey(const std::string& key);
+
+    /**
+     * @brief Resolves device key of persistence key
+     * @param key Persistence key
+     * @return Pointer to device key, nullptr if key is not in index
+     */
+    const std::string* getDeviceKey(const std::string& key) const;
+
+    /**
+     * @brief Finds interned persistence key equal to given one
+     * @param key Persistence key
+     * @return Pointer to key returned by getKey, nullptr if key is not in index
+     */
+    const std::string* findKey(const std::string& key) const;
+
+    /**
+     * @brief Returns persistence keys of device, in order in which they were created
+     * @param deviceKey Device key
+     * @return Persistence keys
+     */
+    const std::vector<std::string>& getKeys(const std::string& deviceKey) const;
+
+private:
+    struct DeviceKeys
+    {
+        std::unordered_map<std::string, std::string> byReference;
+        std::vector<std::string> keys;
+    };
+
+    // device key and reference a persistence key was created for
+    struct KeyOwner
+    {
+        std::string deviceKey;
+        std::string reference;
+    };
+
+    const std::string* insertKey(const std::string& deviceKey, const std::string& reference, const std::string& key);
+
+    void appendEscaped(std::string& key, const std::string& part) const;
+    std::string unescape(const std::string& key, std::size_t begin, std::size_t end) const;
+
+    // position of delimiter that is not escaped, npos if there is none
+    std::size_t findDelimiter(const std::string& key) const;
+
+    const std::string m_delimiter;
+
+    std::unordered_map<std::string, DeviceKeys> m_devices;
+    std::unordered_map<std::string, KeyOwner> m_owners;
+
+    static const constexpr char ESCAPE = '\\';
+};
+}    // namespace wolkabout
+
+#endif    // PERSISTENCEKEYINDEX_H
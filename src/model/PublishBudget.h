@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PUBLISHBUDGET_H
+#define PUBLISHBUDGET_H
+
+#include <chrono>
+#include <cstddef>
+
+namespace wolkabout
+{
+/**
+ * @brief Limits amount of persisted data published in a single pass.<br>
+ *        Zero value of any limit means that limit is not applied.
+ */
+class PublishBudget
+{
+public:
+    PublishBudget(unsigned int maxMessages = 0, std::size_t maxBytes = 0,
+                  std::chrono::milliseconds maxDuration = std::chrono::milliseconds{0})
+    : m_maxMessages{maxMessages}
+    , m_maxBytes{maxBytes}
+    , m_maxDuration{maxDuration}
+    , m_messages{0}
+    , m_bytes{0}
+    , m_started{std::chrono::steady_clock::now()}
+    {
+    }
+
+    /**
+     * @brief Restarts budget, clearing consumed messages, bytes and time
+     */
+    void reset()
+    {
+        m_messages = 0;
+        m_bytes = 0;
+        m_started = std::chrono::steady_clock::now();
+    }
+
+    void consume(std::size_t messageSize)
+    {
+        ++m_messages;
+        m_bytes += messageSize;
+    }
+
+    bool exhausted() const
+    {
+        if (m_maxMessages != 0 && m_messages >= m_maxMessages)
+        {
+            return true;
+        }
+
+        if (m_maxBytes != 0 && m_bytes >= m_maxBytes)
+        {
+            return true;
+        }
+
+        return m_maxDuration.count() != 0 && std::chrono::steady_clock::now() - m_started >= m_maxDuration;
+    }
+
+    bool unlimited() const { return m_maxMessages == 0 && m_maxBytes == 0 && m_maxDuration.count() == 0; }
+
+    unsigned int getMaxMessages() const { return m_maxMessages; }
+
+    unsigned int getConsumedMessages() const { return m_messages; }
+
+private:
+    unsigned int m_maxMessages;
+    std::size_t m_maxBytes;
+    std::chrono::milliseconds m_maxDuration;
+
+    unsigned int m_messages;
+    std::size_t m_bytes;
+    std::chrono::steady_clock::time_point m_started;
+};
+}    // namespace wolkabout
+
+#endif    // PUBLISHBUDGET_H
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PUBLISHCATEGORY_H
+#define PUBLISHCATEGORY_H
+
+namespace wolkabout
+{
+/**
+ * @brief Kinds of persisted data published when connection is established, or on wolkabout::Wolk::publish.<br>
+ *        Categories are published in configured priority order.
+ */
+enum class PublishCategory
+{
+    ALARMS,
+
+    ACTUATOR_STATUSES,
+
+    CONFIGURATIONS,
+
+    // readings of sensors that had no readings persisted when connection was established
+    SENSOR_READINGS,
+
+    // readings persisted while connection was down, published once all other categories are drained
+    SENSOR_READINGS_BACKLOG
+};
+}    // namespace wolkabout
+
+#endif    // PUBLISHCATEGORY_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef READINGAGGREGATION_H
+#define READINGAGGREGATION_H
+
+#include <chrono>
+
+namespace wolkabout
+{
+/**
+ * @brief Describes windows in which numeric readings of a sensor are aggregated
+ *        into minimum, maximum, mean, count and last value.<br>
+ *        Windows are aligned to POSIX time, and reading is assigned to windows by its rtc.
+ */
+class ReadingAggregation
+{
+public:
+    enum class Output
+    {
+        /**
+         * @brief Single multi-value reading on sensor reference, with values min, max, mean, count and last<br>
+         *        For multi-value sensors each statistic except count lists values of all components
+         */
+        MULTI_VALUE,
+
+        /**
+         * @brief One reading per statistic, on sensor reference with suffixes
+         *        _MIN, _MAX, _MEAN, _COUNT and _LAST, which must be defined in device template
+         */
+        READINGS
+    };
+
+    /**
+     * @brief Tumbling windows, each reading belongs to exactly one window
+     * @param window Window length
+     * @param output How aggregates are reported
+     */
+    explicit ReadingAggregation(std::chrono::milliseconds window, Output output = Output::MULTI_VALUE)
+    : ReadingAggregation(window, window, output)
+    {
+    }
+
+    /**
+     * @brief Sliding windows, a new window starts every hop, so each reading belongs to window / hop windows
+     * @param window Window length, must be a multiple of hop
+     * @param hop Time between starts of consecutive windows
+     * @param output How aggregates are reported
+     */
+    ReadingAggregation(std::chrono::milliseconds window, std::chrono::milliseconds hop,
+                       Output output = Output::MULTI_VALUE)
+    : m_window{window}, m_hop{hop}, m_output{output}
+    {
+    }
+
+    std::chrono::milliseconds getWindow() const { return m_window; }
+
+    std::chrono::milliseconds getHop() const { return m_hop; }
+
+    Output getOutput() const { return m_output; }
+
+private:
+    std::chrono::milliseconds m_window;
+    std::chrono::milliseconds m_hop;
+    Output m_output;
+};
+}    // namespace wolkabout
+
+#endif    // READINGAGGREGATION_H
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef READINGFILTER_H
+#define READINGFILTER_H
+
+#include <chrono>
+
+namespace wolkabout
+{
+/**
+ * @brief Decides which readings of a sensor are worth persisting and publishing.<br>
+ *        Readings are compared to the last reported reading of the same device and reference,
+ *        and elapsed time is measured by reading rtc.<br>
+ *        Default filter reports every reading.
+ */
+class ReadingFilter
+{
+public:
+    ReadingFilter()
+    : m_changeOnly{false}
+    , m_absoluteDeadband{0}
+    , m_percentageDeadband{0}
+    , m_maxSilence{0}
+    , m_minInterval{0}
+    {
+    }
+
+    /**
+     * @brief Reports reading only if its value differs from last reported value
+     */
+    ReadingFilter& onChange()
+    {
+        m_changeOnly = true;
+        return *this;
+    }
+
+    /**
+     * @brief Reports numeric reading only if it differs from last reported value by more than deadband<br>
+     *        When both absolute and percentage deadband are set, reading must exceed both
+     * @param deadband Allowed difference in units of the sensor
+     */
+    ReadingFilter& absoluteDeadband(double deadband)
+    {
+        m_changeOnly = true;
+        m_absoluteDeadband = deadband;
+        return *this;
+    }
+
+    /**
+     * @brief Reports numeric reading only if it differs from last reported value by more than deadband<br>
+     *        When both absolute and percentage deadband are set, reading must exceed both
+     * @param percent Allowed difference in percents of last reported value
+     */
+    ReadingFilter& percentageDeadband(double percent)
+    {
+        m_changeOnly = true;
+        m_percentageDeadband = percent;
+        return *this;
+    }
+
+    /**
+     * @brief Reports unchanged reading if nothing was reported for given time<br>
+     *        Silence is checked when reading is added, there is no timer
+     * @param maxSilence Longest time without a reported reading
+     */
+    ReadingFilter& heartbeat(std::chrono::milliseconds maxSilence)
+    {
+        m_maxSilence = maxSilence;
+        return *this;
+    }
+
+    /**
+     * @brief Discards readings that come sooner than given time after last reported reading
+     * @param interval Shortest time between reported readings
+     */
+    ReadingFilter& minInterval(std::chrono::milliseconds interval)
+    {
+        m_minInterval = interval;
+        return *this;
+    }
+
+    bool isChangeOnly() const { return m_changeOnly; }
+
+    double getAbsoluteDeadband() const { return m_absoluteDeadband; }
+
+    double getPercentageDeadband() const { return m_percentageDeadband; }
+
+    std::chrono::milliseconds getMaxSilence() const { return m_maxSilence; }
+
+    std::chrono::milliseconds getMinInterval() const { return m_minInterval; }
+
+private:
+    bool m_changeOnly;
+    double m_absoluteDeadband;
+    double m_percentageDeadband;
+    std::chrono::milliseconds m_maxSilence;
+    std::chrono::milliseconds m_minInterval;
+};
+}    // namespace wolkabout
+
+#endif    // READINGFILTER_H
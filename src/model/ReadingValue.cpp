@@ -0,0 +1,154 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/ReadingValue.h"
+
+#include "core/utilities/StringUtils.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+ReadingValue::ReadingValue() : m_type{Type::NONE}, m_unsigned{0} {}
+
+ReadingValue::ReadingValue(bool value) : m_type{Type::BOOLEAN}, m_boolean{value} {}
+
+ReadingValue::ReadingValue(float value) : m_type{Type::FLOAT}, m_float{value} {}
+
+ReadingValue::ReadingValue(double value) : m_type{Type::DOUBLE}, m_double{value} {}
+
+ReadingValue::ReadingValue(signed int value) : m_type{Type::SIGNED}, m_signed{value} {}
+
+ReadingValue::ReadingValue(signed long int value) : m_type{Type::SIGNED}, m_signed{value} {}
+
+ReadingValue::ReadingValue(signed long long int value) : m_type{Type::SIGNED}, m_signed{value} {}
+
+ReadingValue::ReadingValue(unsigned int value) : m_type{Type::UNSIGNED}, m_unsigned{value} {}
+
+ReadingValue::ReadingValue(unsigned long int value) : m_type{Type::UNSIGNED}, m_unsigned{value} {}
+
+ReadingValue::ReadingValue(unsigned long long int value) : m_type{Type::UNSIGNED}, m_unsigned{value} {}
+
+ReadingValue::ReadingValue(std::string value) : m_type{Type::STRING}, m_string{new std::string(std::move(value))} {}
+
+ReadingValue::ReadingValue(const char* value) : m_type{Type::STRING}, m_string{new std::string(value)} {}
+
+ReadingValue::ReadingValue(const ReadingValue& other) : m_type{other.m_type}, m_unsigned{other.m_unsigned}
+{
+    if (m_type == Type::STRING)
+    {
+        m_string = new std::string(*other.m_string);
+    }
+}
+
+ReadingValue::ReadingValue(ReadingValue&& other) noexcept : m_type{other.m_type}, m_unsigned{other.m_unsigned}
+{
+    // moved-from string value is left as NONE, so it does not release the string it no longer owns
+    other.m_type = Type::NONE;
+}
+
+ReadingValue& ReadingValue::operator=(const ReadingValue& other)
+{
+    if (this != &other)
+    {
+        ReadingValue copy{other};
+        *this = std::move(copy);
+    }
+
+    return *this;
+}
+
+ReadingValue& ReadingValue::operator=(ReadingValue&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+
+        m_type = other.m_type;
+        m_unsigned = other.m_unsigned;
+
+        other.m_type = Type::NONE;
+    }
+
+    return *this;
+}
+
+ReadingValue::~ReadingValue()
+{
+    release();
+}
+
+void ReadingValue::release()
+{
+    if (m_type == Type::STRING)
+    {
+        delete m_string;
+    }
+}
+
+ReadingValue::Type ReadingValue::getType() const
+{
+    return m_type;
+}
+
+bool ReadingValue::isNumeric() const
+{
+    return m_type != Type::STRING && m_type != Type::BOOLEAN && m_type != Type::NONE;
+}
+
+double ReadingValue::toDouble() const
+{
+    switch (m_type)
+    {
+    case Type::BOOLEAN:
+        return m_boolean ? 1.0 : 0.0;
+    case Type::SIGNED:
+        return static_cast<double>(m_signed);
+    case Type::UNSIGNED:
+        return static_cast<double>(m_unsigned);
+    case Type::FLOAT:
+        return static_cast<double>(m_float);
+    case Type::DOUBLE:
+        return m_double;
+    case Type::STRING:
+    case Type::NONE:
+    default:
+        return 0.0;
+    }
+}
+
+std::string ReadingValue::toString() const
+{
+    switch (m_type)
+    {
+    case Type::BOOLEAN:
+        return StringUtils::toString(m_boolean);
+    case Type::SIGNED:
+        return StringUtils::toString(m_signed);
+    case Type::UNSIGNED:
+        return StringUtils::toString(m_unsigned);
+    case Type::FLOAT:
+        return StringUtils::toString(m_float);
+    case Type::DOUBLE:
+        return StringUtils::toString(m_double);
+    case Type::STRING:
+        return *m_string;
+    case Type::NONE:
+    default:
+        return "";
+    }
+}
+}    // namespace wolkabout
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef READINGVALUE_H
+#define READINGVALUE_H
+
+#include <cstdint>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Sensor value kept in its native type until it is formatted for persistence.<br>
+ *        Numeric and boolean values are stored inline, without heap allocation.<br>
+ *        String values are stored out of line, so they do not enlarge every other value.
+ */
+class ReadingValue
+{
+public:
+    enum class Type : std::uint8_t
+    {
+        NONE,
+        BOOLEAN,
+        SIGNED,
+        UNSIGNED,
+        FLOAT,
+        DOUBLE,
+        STRING
+    };
+
+    /**
+     * @brief Constructs value of type NONE, used where reading carries no single value, such as multi-value readings
+     */
+    ReadingValue();
+
+    ReadingValue(bool value);
+    ReadingValue(float value);
+    ReadingValue(double value);
+    ReadingValue(signed int value);
+    ReadingValue(signed long int value);
+    ReadingValue(signed long long int value);
+    ReadingValue(unsigned int value);
+    ReadingValue(unsigned long int value);
+    ReadingValue(unsigned long long int value);
+    ReadingValue(std::string value);
+    ReadingValue(const char* value);
+
+    ReadingValue(const ReadingValue& other);
+    ReadingValue(ReadingValue&& other) noexcept;
+
+    ReadingValue& operator=(const ReadingValue& other);
+    ReadingValue& operator=(ReadingValue&& other) noexcept;
+
+    ~ReadingValue();
+
+    Type getType() const;
+
+    bool isNumeric() const;
+
+    /**
+     * @brief Numeric representation of the value
+     * @return Value as double, 1 or 0 for booleans, 0 for strings and NONE
+     */
+    double toDouble() const;
+
+    /**
+     * @brief Formats value the same way wolkabout::StringUtils::toString does for its native type
+     * @return Value as string, empty for NONE
+     */
+    std::string toString() const;
+
+private:
+    void release();
+
+    Type m_type;
+
+    union {
+        bool m_boolean;
+        signed long long int m_signed;
+        unsigned long long int m_unsigned;
+        float m_float;
+        double m_double;
+        std::string* m_string;
+    };
+};
+}    // namespace wolkabout
+
+#endif    // READINGVALUE_H
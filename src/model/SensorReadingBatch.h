@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSORREADINGBATCH_H
+#define SENSORREADINGBATCH_H
+
+#include "model/ReadingValue.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Collects sensor readings of a single device, so they can be passed to
+ *        wolkabout::Wolk::addSensorReadings and validated and persisted as one command.
+ */
+class SensorReadingBatch
+{
+public:
+    struct Reading
+    {
+        std::string reference;
+        ReadingValue value;
+        std::vector<ReadingValue> values;
+        unsigned long long int rtc;
+
+        bool isMultiValue() const { return !values.empty(); }
+    };
+
+    SensorReadingBatch() = default;
+
+    /**
+     * @brief Reserves space for expected number of readings
+     * @param count Expected number of readings
+     */
+    explicit SensorReadingBatch(std::size_t count) { m_readings.reserve(count); }
+
+    /**
+     * @brief Adds sensor reading to batch
+     * @param reference Sensor reference
+     * @param value Sensor value, supports the same types as wolkabout::Wolk::addSensorReading
+     * @param rtc Reading POSIX time in milliseconds<br>
+     *            If omitted time at which batch is processed is adopted
+     * @return Reference to current wolkabout::SensorReadingBatch instance (Provides fluent interface)
+     */
+    template <typename T> SensorReadingBatch& add(const std::string& reference, T value, unsigned long long int rtc = 0)
+    {
+        m_readings.push_back(Reading{reference, ReadingValue(value), {}, rtc});
+        return *this;
+    }
+
+    /**
+     * @brief Adds multi-value sensor reading to batch
+     * @param reference Sensor reference
+     * @param values Multi-value sensor values
+     * @param rtc Reading POSIX time in milliseconds<br>
+     *            If omitted time at which batch is processed is adopted
+     * @return Reference to current wolkabout::SensorReadingBatch instance (Provides fluent interface)
+     */
+    template <typename T>
+    SensorReadingBatch& add(const std::string& reference, std::initializer_list<T> values,
+                            unsigned long long int rtc = 0)
+    {
+        return add(reference, std::vector<T>(values), rtc);
+    }
+
+    /**
+     * @brief Adds multi-value sensor reading to batch
+     * @param reference Sensor reference
+     * @param values Multi-value sensor values
+     * @param rtc Reading POSIX time in milliseconds<br>
+     *            If omitted time at which batch is processed is adopted
+     * @return Reference to current wolkabout::SensorReadingBatch instance (Provides fluent interface)
+     */
+    template <typename T>
+    SensorReadingBatch& add(const std::string& reference, const std::vector<T>& values, unsigned long long int rtc = 0)
+    {
+        if (values.empty())
+        {
+            return *this;
+        }
+
+        m_readings.push_back(
+          Reading{reference, ReadingValue(), std::vector<ReadingValue>(values.begin(), values.end()), rtc});
+        return *this;
+    }
+
+    const std::vector<Reading>& getReadings() const { return m_readings; }
+    std::vector<Reading>& getReadings() { return m_readings; }
+
+    std::size_t size() const { return m_readings.size(); }
+    bool empty() const { return m_readings.empty(); }
+
+private:
+    std::vector<Reading> m_readings;
+};
+}    // namespace wolkabout
+
+#endif    // SENSORREADINGBATCH_H
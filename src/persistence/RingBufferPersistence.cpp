@@ -0,0 +1,646 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "persistence/RingBufferPersistence.h"
+
+#include "core/model/ActuatorStatus.h"
+#include "core/model/Alarm.h"
+#include "core/model/SensorReading.h"
+#include "core/utilities/Logger.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+const std::uint32_t FILE_MAGIC = 0x57474d52;
+const std::uint32_t FILE_VERSION = 1;
+const std::uint32_t RECORD_MAGIC = 0x52454344;
+
+const std::uint64_t FILE_HEADER_SIZE = 64;
+const std::uint64_t RECORD_ALIGNMENT = 16;
+
+std::uint64_t align(std::uint64_t size)
+{
+    return (size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+
+template <typename T> void writeValue(std::string& buffer, T value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeValue(std::string& buffer, const std::string& value)
+{
+    writeValue(buffer, static_cast<std::uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+class PayloadReader
+{
+public:
+    explicit PayloadReader(const std::string& payload) : m_payload{payload}, m_position{0}, m_valid{true} {}
+
+    template <typename T> T read()
+    {
+        T value{};
+        if (!ensure(sizeof(T)))
+        {
+            return value;
+        }
+
+        std::memcpy(&value, m_payload.data() + m_position, sizeof(T));
+        m_position += sizeof(T);
+        return value;
+    }
+
+    std::string readString()
+    {
+        const auto size = read<std::uint32_t>();
+        if (!ensure(size))
+        {
+            return "";
+        }
+
+        std::string value = m_payload.substr(m_position, size);
+        m_position += size;
+        return value;
+    }
+
+    bool valid() const { return m_valid; }
+
+private:
+    bool ensure(std::size_t size)
+    {
+        m_valid = m_valid && m_payload.size() - m_position >= size;
+        return m_valid;
+    }
+
+    const std::string& m_payload;
+    std::size_t m_position;
+    bool m_valid;
+};
+
+std::string serialize(const wolkabout::SensorReading& sensorReading)
+{
+    std::string payload;
+    writeValue(payload, static_cast<std::uint64_t>(sensorReading.getRtc()));
+    writeValue(payload, sensorReading.getReference());
+
+    const auto& values = sensorReading.getValues();
+    writeValue(payload, static_cast<std::uint32_t>(values.size()));
+    for (const auto& value : values)
+    {
+        writeValue(payload, value);
+    }
+
+    return payload;
+}
+
+std::shared_ptr<wolkabout::SensorReading> deserializeSensorReading(const std::string& payload)
+{
+    PayloadReader reader{payload};
+    const auto rtc = reader.read<std::uint64_t>();
+    const auto reference = reader.readString();
+
+    const auto count = reader.read<std::uint32_t>();
+    std::vector<std::string> values;
+    for (std::uint32_t i = 0; i < count && reader.valid(); ++i)
+    {
+        values.push_back(reader.readString());
+    }
+
+    if (!reader.valid())
+    {
+        return nullptr;
+    }
+
+    if (values.size() == 1)
+    {
+        return std::make_shared<wolkabout::SensorReading>(values.front(), reference, rtc);
+    }
+
+    return std::make_shared<wolkabout::SensorReading>(values, reference, rtc);
+}
+
+std::string serialize(const wolkabout::Alarm& alarm)
+{
+    std::string payload;
+    writeValue(payload, static_cast<std::uint64_t>(alarm.getRtc()));
+    writeValue(payload, alarm.getReference());
+    writeValue(payload, static_cast<std::uint8_t>(alarm.getActive() ? 1 : 0));
+
+    return payload;
+}
+
+std::shared_ptr<wolkabout::Alarm> deserializeAlarm(const std::string& payload)
+{
+    PayloadReader reader{payload};
+    const auto rtc = reader.read<std::uint64_t>();
+    const auto reference = reader.readString();
+    const auto active = reader.read<std::uint8_t>();
+
+    if (!reader.valid())
+    {
+        return nullptr;
+    }
+
+    return std::make_shared<wolkabout::Alarm>(active != 0, reference, rtc);
+}
+}    // namespace
+
+namespace wolkabout
+{
+const constexpr std::uint64_t RingBufferPersistence::DEFAULT_CAPACITY;
+
+RingBufferPersistence::RingBufferPersistence(const std::string& filePath, std::uint64_t capacity,
+                                             Durability durability)
+: m_fileDescriptor{-1}
+, m_mapping{nullptr}
+, m_capacity{capacity / RECORD_ALIGNMENT * RECORD_ALIGNMENT}
+, m_durability{durability}
+, m_pageSize{static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE))}
+, m_head{0}
+, m_tail{0}
+{
+    if (m_capacity < RECORD_ALIGNMENT * 4)
+    {
+        throw std::runtime_error("Ring buffer capacity too small: " + std::to_string(capacity));
+    }
+
+    mapFile(filePath);
+    recover();
+}
+
+RingBufferPersistence::~RingBufferPersistence()
+{
+    if (m_mapping != nullptr)
+    {
+        msync(m_mapping, static_cast<std::size_t>(FILE_HEADER_SIZE + m_capacity), MS_SYNC);
+        munmap(m_mapping, static_cast<std::size_t>(FILE_HEADER_SIZE + m_capacity));
+    }
+
+    if (m_fileDescriptor != -1)
+    {
+        close(m_fileDescriptor);
+    }
+}
+
+bool RingBufferPersistence::putSensorReading(const std::string& key, std::shared_ptr<SensorReading> sensorReading)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    return append(RecordKind::SENSOR_READING, key, serialize(*sensorReading));
+}
+
+std::vector<std::shared_ptr<SensorReading>> RingBufferPersistence::getSensorReadings(const std::string& key,
+                                                                                      std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    std::vector<std::shared_ptr<SensorReading>> sensorReadings;
+    for (const auto& payload : readPayloads(RecordKind::SENSOR_READING, key, count))
+    {
+        if (auto sensorReading = deserializeSensorReading(payload))
+        {
+            sensorReadings.push_back(sensorReading);
+        }
+    }
+
+    return sensorReadings;
+}
+
+void RingBufferPersistence::removeSensorReadings(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    removeRecords(RecordKind::SENSOR_READING, key, count);
+}
+
+std::vector<std::string> RingBufferPersistence::getSensorReadingsKeys()
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    std::vector<std::string> keys;
+    for (const auto& kvp : m_sensorReadingsIndex)
+    {
+        keys.push_back(kvp.first);
+    }
+
+    return keys;
+}
+
+bool RingBufferPersistence::putAlarm(const std::string& key, std::shared_ptr<Alarm> alarm)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    return append(RecordKind::ALARM, key, serialize(*alarm));
+}
+
+std::vector<std::shared_ptr<Alarm>> RingBufferPersistence::getAlarms(const std::string& key,
+                                                                      std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    std::vector<std::shared_ptr<Alarm>> alarms;
+    for (const auto& payload : readPayloads(RecordKind::ALARM, key, count))
+    {
+        if (auto alarm = deserializeAlarm(payload))
+        {
+            alarms.push_back(alarm);
+        }
+    }
+
+    return alarms;
+}
+
+void RingBufferPersistence::removeAlarms(const std::string& key, std::uint_fast64_t count)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    removeRecords(RecordKind::ALARM, key, count);
+}
+
+std::vector<std::string> RingBufferPersistence::getAlarmsKeys()
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    std::vector<std::string> keys;
+    for (const auto& kvp : m_alarmsIndex)
+    {
+        keys.push_back(kvp.first);
+    }
+
+    return keys;
+}
+
+bool RingBufferPersistence::putActuatorStatus(const std::string& key, std::shared_ptr<ActuatorStatus> actuatorStatus)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    m_actuatorStatuses[key] = actuatorStatus;
+    return true;
+}
+
+std::shared_ptr<ActuatorStatus> RingBufferPersistence::getActuatorStatus(const std::string& key)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    auto it = m_actuatorStatuses.find(key);
+    return it != m_actuatorStatuses.end() ? it->second : nullptr;
+}
+
+void RingBufferPersistence::removeActuatorStatus(const std::string& key)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    m_actuatorStatuses.erase(key);
+}
+
+std::vector<std::string> RingBufferPersistence::getActuatorStatusesKeys()
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    std::vector<std::string> keys;
+    for (const auto& kvp : m_actuatorStatuses)
+    {
+        keys.push_back(kvp.first);
+    }
+
+    return keys;
+}
+
+bool RingBufferPersistence::putConfiguration(const std::string& key,
+                                             std::shared_ptr<std::vector<ConfigurationItem>> configuration)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    m_configurations[key] = configuration;
+    return true;
+}
+
+std::shared_ptr<std::vector<ConfigurationItem>> RingBufferPersistence::getConfiguration(const std::string& key)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    auto it = m_configurations.find(key);
+    return it != m_configurations.end() ? it->second : nullptr;
+}
+
+void RingBufferPersistence::removeConfiguration(const std::string& key)
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    m_configurations.erase(key);
+}
+
+std::vector<std::string> RingBufferPersistence::getConfigurationKeys()
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+
+    std::vector<std::string> keys;
+    for (const auto& kvp : m_configurations)
+    {
+        keys.push_back(kvp.first);
+    }
+
+    return keys;
+}
+
+bool RingBufferPersistence::isEmpty()
+{
+    std::lock_guard<std::mutex> guard{m_mutex};
+    return m_sensorReadingsIndex.empty() && m_alarmsIndex.empty() && m_actuatorStatuses.empty() &&
+           m_configurations.empty();
+}
+
+void RingBufferPersistence::mapFile(const std::string& filePath)
+{
+    m_fileDescriptor = open(filePath.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fileDescriptor == -1)
+    {
+        throw std::runtime_error("Unable to open ring buffer file: " + filePath);
+    }
+
+    const auto size = FILE_HEADER_SIZE + m_capacity;
+
+    struct stat fileStat;
+    if (fstat(m_fileDescriptor, &fileStat) != 0 || (static_cast<std::uint64_t>(fileStat.st_size) != size &&
+                                                    ftruncate(m_fileDescriptor, static_cast<off_t>(size)) != 0))
+    {
+        close(m_fileDescriptor);
+        throw std::runtime_error("Unable to resize ring buffer file: " + filePath);
+    }
+
+    void* mapping =
+      mmap(nullptr, static_cast<std::size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, m_fileDescriptor, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close(m_fileDescriptor);
+        throw std::runtime_error("Unable to map ring buffer file: " + filePath);
+    }
+
+    m_mapping = static_cast<char*>(mapping);
+}
+
+void RingBufferPersistence::recover()
+{
+    FileHeader header;
+    std::memcpy(&header, m_mapping, sizeof(FileHeader));
+
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.capacity != m_capacity ||
+        header.head > header.tail || header.tail - header.head > m_capacity)
+    {
+        LOG(INFO) << "Initializing ring buffer persistence";
+
+        header = FileHeader{FILE_MAGIC, FILE_VERSION, m_capacity, 0, 0};
+        std::memcpy(m_mapping, &header, sizeof(FileHeader));
+        msync(m_mapping, static_cast<std::size_t>(FILE_HEADER_SIZE), MS_SYNC);
+        return;
+    }
+
+    m_head = header.head;
+    m_tail = header.head;
+
+    // offsets are stored only after record is written, so a torn write can only be found past the stored tail
+    while (m_tail < header.tail)
+    {
+        const auto record = recordHeaderAt(m_tail);
+        if (record.magic != RECORD_MAGIC || record.length == 0 || record.length > header.tail - m_tail)
+        {
+            LOG(WARN) << "Ring buffer persistence truncated at corrupted record";
+            break;
+        }
+
+        if (record.kind != RecordKind::PADDING && record.state == RecordState::LIVE)
+        {
+            const std::string key{recordAt(m_tail) + sizeof(RecordHeader), record.keyLength};
+            index(record.kind)[key].push_back(m_tail);
+        }
+
+        m_tail += record.length;
+    }
+
+    advanceHead();
+    storeOffsets();
+
+    LOG(INFO) << "Recovered " << m_sensorReadingsIndex.size() << " sensor reading keys and " << m_alarmsIndex.size()
+              << " alarm keys from ring buffer persistence";
+}
+
+bool RingBufferPersistence::append(RecordKind kind, const std::string& key, const std::string& payload)
+{
+    const auto length = align(sizeof(RecordHeader) + key.size() + payload.size());
+    if (key.size() > std::numeric_limits<std::uint16_t>::max() || length > m_capacity / 2)
+    {
+        LOG(ERROR) << "Record too large for ring buffer persistence: " << key;
+        return false;
+    }
+
+    const auto remaining = m_capacity - m_tail % m_capacity;
+    const auto padding = remaining < length ? remaining : 0;
+
+    if (m_capacity - (m_tail - m_head) < padding + length)
+    {
+        while (m_capacity - (m_tail - m_head) < padding + length)
+        {
+            dropOldest();
+        }
+
+        // freed space must not be overwritten before recovery stops reading it
+        storeOffsets();
+    }
+
+    const auto begin = m_tail;
+
+    if (padding != 0)
+    {
+        const RecordHeader paddingRecord{RECORD_MAGIC, RecordKind::PADDING, RecordState::REMOVED, 0, 0,
+                                         static_cast<std::uint32_t>(padding)};
+        std::memcpy(recordAt(m_tail), &paddingRecord, sizeof(RecordHeader));
+        m_tail += padding;
+    }
+
+    char* destination = recordAt(m_tail);
+    std::memcpy(destination + sizeof(RecordHeader), key.data(), key.size());
+    std::memcpy(destination + sizeof(RecordHeader) + key.size(), payload.data(), payload.size());
+
+    // header goes last, so a record is never observed without its contents
+    const RecordHeader record{RECORD_MAGIC,
+                              kind,
+                              RecordState::LIVE,
+                              static_cast<std::uint16_t>(key.size()),
+                              static_cast<std::uint32_t>(payload.size()),
+                              static_cast<std::uint32_t>(length)};
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(destination, &record, sizeof(RecordHeader));
+
+    index(kind)[key].push_back(m_tail);
+    m_tail += length;
+
+    // record must reach the disk before offsets that include it, which the kernel may write back first
+    if (m_durability == Durability::POWER_LOSS)
+    {
+        syncRecords(begin, m_tail);
+    }
+
+    storeOffsets();
+    return true;
+}
+
+std::vector<std::string> RingBufferPersistence::readPayloads(RecordKind kind, const std::string& key,
+                                                             std::uint_fast64_t count)
+{
+    std::vector<std::string> payloads;
+
+    auto& recordIndex = index(kind);
+    auto it = recordIndex.find(key);
+    if (it == recordIndex.end())
+    {
+        return payloads;
+    }
+
+    const auto& offsets = it->second;
+    const auto size = std::min<std::uint64_t>(count, offsets.size());
+    payloads.reserve(static_cast<std::size_t>(size));
+
+    for (std::uint64_t i = 0; i < size; ++i)
+    {
+        const auto offset = offsets[static_cast<std::size_t>(i)];
+        const auto record = recordHeaderAt(offset);
+        payloads.emplace_back(recordAt(offset) + sizeof(RecordHeader) + record.keyLength, record.payloadLength);
+    }
+
+    return payloads;
+}
+
+void RingBufferPersistence::removeRecords(RecordKind kind, const std::string& key, std::uint_fast64_t count)
+{
+    auto& recordIndex = index(kind);
+    auto it = recordIndex.find(key);
+    if (it == recordIndex.end())
+    {
+        return;
+    }
+
+    auto& offsets = it->second;
+    for (std::uint_fast64_t i = 0; i < count && !offsets.empty(); ++i)
+    {
+        auto record = recordHeaderAt(offsets.front());
+        record.state = RecordState::REMOVED;
+        std::memcpy(recordAt(offsets.front()), &record, sizeof(RecordHeader));
+
+        offsets.pop_front();
+    }
+
+    if (offsets.empty())
+    {
+        recordIndex.erase(it);
+    }
+
+    advanceHead();
+    storeOffsets();
+}
+
+void RingBufferPersistence::dropOldest()
+{
+    const auto head = m_head;
+    const auto record = recordHeaderAt(head);
+
+    if (record.kind != RecordKind::PADDING && record.state == RecordState::LIVE)
+    {
+        const std::string key{recordAt(head) + sizeof(RecordHeader), record.keyLength};
+        LOG(WARN) << "Ring buffer persistence full, dropping oldest record of: " << key;
+
+        // records of a key are indexed in append order, so the oldest record in buffer is first for its key
+        removeRecords(record.kind, key, 1);
+    }
+
+    if (m_head == head)
+    {
+        m_head += record.length;
+        advanceHead();
+    }
+}
+
+void RingBufferPersistence::advanceHead()
+{
+    while (m_head < m_tail)
+    {
+        const auto record = recordHeaderAt(m_head);
+        if (record.state == RecordState::LIVE)
+        {
+            break;
+        }
+
+        m_head += record.length;
+    }
+}
+
+void RingBufferPersistence::storeOffsets()
+{
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(m_mapping + offsetof(FileHeader, head), &m_head, sizeof(m_head));
+    std::memcpy(m_mapping + offsetof(FileHeader, tail), &m_tail, sizeof(m_tail));
+
+    if (m_durability == Durability::POWER_LOSS)
+    {
+        syncRange(m_mapping, FILE_HEADER_SIZE);
+    }
+}
+
+void RingBufferPersistence::syncRecords(std::uint64_t begin, std::uint64_t end) const
+{
+    // range wraps at most once, as padding fills the end of buffer before a record is written at its start
+    const auto position = begin % m_capacity;
+    const auto untilEnd = std::min(end - begin, m_capacity - position);
+
+    syncRange(recordAt(begin), untilEnd);
+    if (untilEnd < end - begin)
+    {
+        syncRange(recordAt(0), end - begin - untilEnd);
+    }
+}
+
+void RingBufferPersistence::syncRange(const char* begin, std::uint64_t length) const
+{
+    const auto offset = static_cast<std::uint64_t>(begin - m_mapping);
+    const auto pageOffset = offset / m_pageSize * m_pageSize;
+
+    if (msync(m_mapping + pageOffset, static_cast<std::size_t>(offset - pageOffset + length), MS_SYNC) != 0)
+    {
+        LOG(ERROR) << "Unable to sync ring buffer persistence";
+    }
+}
+
+RingBufferPersistence::RecordIndex& RingBufferPersistence::index(RecordKind kind)
+{
+    return kind == RecordKind::ALARM ? m_alarmsIndex : m_sensorReadingsIndex;
+}
+
+RingBufferPersistence::RecordHeader RingBufferPersistence::recordHeaderAt(std::uint64_t offset) const
+{
+    RecordHeader record;
+    std::memcpy(&record, recordAt(offset), sizeof(RecordHeader));
+    return record;
+}
+
+char* RingBufferPersistence::recordAt(std::uint64_t offset) const
+{
+    return m_mapping + FILE_HEADER_SIZE + offset % m_capacity;
+}
+}    // namespace wolkabout
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RINGBUFFERPERSISTENCE_H
+#define RINGBUFFERPERSISTENCE_H
+
+#include "core/persistence/Persistence.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Persistence that stores sensor readings and alarms in a memory-mapped file of fixed size.<br>
+ *        Records are appended to a ring buffer, and when it is full the oldest records are dropped.<br>
+ *        Records left in the file by a previous instance are recovered on construction.<br>
+ *        Actuator statuses and configurations hold only the latest value per key, and are kept in memory.<br>
+ *        By default records survive a crash of the process, but not a power loss or a crash of the system,
+ *        as the kernel writes pages of the file back in no particular order, unless Durability::POWER_LOSS is set.
+ */
+class RingBufferPersistence : public Persistence
+{
+public:
+    enum class Durability
+    {
+        /**
+         * Records and offsets are written to the mapping only, and reach the disk when the kernel writes them
+         * back, or when persistence is destroyed
+         */
+        PROCESS_CRASH,
+
+        /**
+         * Each appended record is synced to disk before offsets that include it, and offsets are synced
+         * whenever they change. Every put and remove waits for the disk
+         */
+        POWER_LOSS
+    };
+
+    /**
+     * @brief Opens ring buffer file, creating it if it does not exist
+     * @param filePath Path to ring buffer file
+     * @param capacity Maximum size of persisted records in bytes<br>
+     *                 Existing file created with different capacity is cleared
+     * @param durability Failures after which persisted records are recovered
+     * @throws std::runtime_error if file can not be opened, resized or mapped
+     */
+    explicit RingBufferPersistence(const std::string& filePath, std::uint64_t capacity = DEFAULT_CAPACITY,
+                                   Durability durability = Durability::PROCESS_CRASH);
+    ~RingBufferPersistence() override;
+
+    RingBufferPersistence(const RingBufferPersistence&) = delete;
+    RingBufferPersistence& operator=(const RingBufferPersistence&) = delete;
+
+    bool putSensorReading(const std::string& key, std::shared_ptr<SensorReading> sensorReading) override;
+    std::vector<std::shared_ptr<SensorReading>> getSensorReadings(const std::string& key,
+                                                                  std::uint_fast64_t count) override;
+    void removeSensorReadings(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getSensorReadingsKeys() override;
+
+    bool putAlarm(const std::string& key, std::shared_ptr<Alarm> alarm) override;
+    std::vector<std::shared_ptr<Alarm>> getAlarms(const std::string& key, std::uint_fast64_t count) override;
+    void removeAlarms(const std::string& key, std::uint_fast64_t count) override;
+    std::vector<std::string> getAlarmsKeys() override;
+
+    bool putActuatorStatus(const std::string& key, std::shared_ptr<ActuatorStatus> actuatorStatus) override;
+    std::shared_ptr<ActuatorStatus> getActuatorStatus(const std::string& key) override;
+    void removeActuatorStatus(const std::string& key) override;
+    std::vector<std::string> getActuatorStatusesKeys() override;
+
+    bool putConfiguration(const std::string& key,
+                          std::shared_ptr<std::vector<ConfigurationItem>> configuration) override;
+    std::shared_ptr<std::vector<ConfigurationItem>> getConfiguration(const std::string& key) override;
+    void removeConfiguration(const std::string& key) override;
+    std::vector<std::string> getConfigurationKeys() override;
+
+    bool isEmpty() override;
+
+    static const constexpr std::uint64_t DEFAULT_CAPACITY = 16 * 1024 * 1024;
+
+private:
+    enum class RecordKind : std::uint8_t
+    {
+        PADDING,
+        SENSOR_READING,
+        ALARM
+    };
+
+    enum class RecordState : std::uint8_t
+    {
+        LIVE,
+        REMOVED
+    };
+
+    struct FileHeader
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t capacity;
+        std::uint64_t head;
+        std::uint64_t tail;
+    };
+
+    struct RecordHeader
+    {
+        std::uint32_t magic;
+        RecordKind kind;
+        RecordState state;
+        std::uint16_t keyLength;
+        std::uint32_t payloadLength;
+        std::uint32_t length;
+    };
+
+    typedef std::map<std::string, std::deque<std::uint64_t>> RecordIndex;
+
+    void mapFile(const std::string& filePath);
+    void recover();
+
+    bool append(RecordKind kind, const std::string& key, const std::string& payload);
+    std::vector<std::string> readPayloads(RecordKind kind, const std::string& key, std::uint_fast64_t count);
+    void removeRecords(RecordKind kind, const std::string& key, std::uint_fast64_t count);
+
+    void dropOldest();
+    void advanceHead();
+    void storeOffsets();
+    void syncRecords(std::uint64_t begin, std::uint64_t end) const;
+    void syncRange(const char* begin, std::uint64_t length) const;
+
+    RecordIndex& index(RecordKind kind);
+
+    RecordHeader recordHeaderAt(std::uint64_t offset) const;
+    char* recordAt(std::uint64_t offset) const;
+
+    int m_fileDescriptor;
+    char* m_mapping;
+    std::uint64_t m_capacity;
+
+    const Durability m_durability;
+    const std::uint64_t m_pageSize;
+
+    std::uint64_t m_head;
+    std::uint64_t m_tail;
+
+    RecordIndex m_sensorReadingsIndex;
+    RecordIndex m_alarmsIndex;
+
+    std::map<std::string, std::shared_ptr<ActuatorStatus>> m_actuatorStatuses;
+    std::map<std::string, std::shared_ptr<std::vector<ConfigurationItem>>> m_configurations;
+
+    std::mutex m_mutex;
+};
+}    // namespace wolkabout
+
+#endif    // RINGBUFFERPERSISTENCE_H
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSORREADINGSENVELOPEPROTOCOL_H
+#define SENSORREADINGSENVELOPEPROTOCOL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+class Message;
+class SensorReading;
+
+/**
+ * @brief Persisted readings of a single sensor of a device
+ */
+struct SensorReadingsGroup
+{
+    std::string deviceKey;
+    std::vector<std::shared_ptr<SensorReading>> sensorReadings;
+};
+
+/**
+ * @brief Extension of data protocol which packs readings of many sensors, of one or more devices,
+ *        into a single message
+ */
+class SensorReadingsEnvelopeProtocol
+{
+public:
+    virtual ~SensorReadingsEnvelopeProtocol() = default;
+
+    /**
+     * @brief Makes message carrying all given groups
+     * @param groups Groups of readings, none of them empty
+     * @return Message, or nullptr if groups are empty
+     */
+    virtual std::unique_ptr<Message> makeEnvelope(const std::vector<SensorReadingsGroup>& groups) const = 0;
+};
+}    // namespace wolkabout
+
+#endif    // SENSORREADINGSENVELOPEPROTOCOL_H
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/json/PrecompiledJsonProtocol.h"
+
+#include "core/model/ActuatorGetCommand.h"
+#include "core/model/ActuatorSetCommand.h"
+#include "core/model/ConfigurationSetCommand.h"
+#include "core/model/Message.h"
+#include "core/model/SensorReading.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+// reading is written as {"data":"<value>","utc":<rtc>}, or {"data":"<value>"} when it has no rtc
+const char READING_PREFIX[] = "{\"data\":\"";
+const char RTC_INFIX[] = "\",\"utc\":";
+const char READING_SUFFIX[] = "}";
+const char READING_WITHOUT_RTC_SUFFIX[] = "\"}";
+
+const std::size_t MAX_UNSIGNED_DIGITS = 20;
+
+// excluding terminating null characters and value
+const std::size_t MAX_READING_OVERHEAD =
+  sizeof(READING_PREFIX) + sizeof(RTC_INFIX) + MAX_UNSIGNED_DIGITS + sizeof(READING_SUFFIX) - 3;
+
+bool needsEscaping(char c)
+{
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+}    // namespace
+
+namespace wolkabout
+{
+std::vector<std::string> PrecompiledJsonProtocol::getInboundChannels() const
+{
+    return m_jsonProtocol.getInboundChannels();
+}
+
+std::vector<std::string> PrecompiledJsonProtocol::getInboundChannelsForDevice(const std::string& deviceKey) const
+{
+    return m_jsonProtocol.getInboundChannelsForDevice(deviceKey);
+}
+
+std::string PrecompiledJsonProtocol::extractDeviceKeyFromChannel(const std::string& topic) const
+{
+    return m_jsonProtocol.extractDeviceKeyFromChannel(topic);
+}
+
+std::string PrecompiledJsonProtocol::extractReferenceFromChannel(const std::string& topic) const
+{
+    return m_jsonProtocol.extractReferenceFromChannel(topic);
+}
+
+bool PrecompiledJsonProtocol::isActuatorSetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isActuatorSetMessage(message);
+}
+
+bool PrecompiledJsonProtocol::isActuatorGetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isActuatorGetMessage(message);
+}
+
+bool PrecompiledJsonProtocol::isConfigurationSetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isConfigurationSetMessage(message);
+}
+
+bool PrecompiledJsonProtocol::isConfigurationGetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isConfigurationGetMessage(message);
+}
+
+std::unique_ptr<ActuatorGetCommand> PrecompiledJsonProtocol::makeActuatorGetCommand(const Message& message) const
+{
+    return m_jsonProtocol.makeActuatorGetCommand(message);
+}
+
+std::unique_ptr<ActuatorSetCommand> PrecompiledJsonProtocol::makeActuatorSetCommand(const Message& message) const
+{
+    return m_jsonProtocol.makeActuatorSetCommand(message);
+}
+
+std::unique_ptr<ConfigurationSetCommand> PrecompiledJsonProtocol::makeConfigurationSetCommand(
+  const Message& message) const
+{
+    return m_jsonProtocol.makeConfigurationSetCommand(message);
+}
+
+std::unique_ptr<Message> PrecompiledJsonProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const
+{
+    if (sensorReadings.empty())
+    {
+        return nullptr;
+    }
+
+    const auto readingTemplate = findReadingTemplate(deviceKey, sensorReadings.front()->getReference());
+    if (!readingTemplate)
+    {
+        return m_jsonProtocol.makeMessage(deviceKey, sensorReadings);
+    }
+
+    // payload is reserved at its upper bound, escaped values included, and moved into message,
+    // so it is allocated once and never copied
+    std::size_t payloadSize = 2 + sensorReadings.size() * (MAX_READING_OVERHEAD + 1);
+    for (const auto& sensorReading : sensorReadings)
+    {
+        const auto& values = sensorReading->getValues();
+        if (values.size() != 1)
+        {
+            return m_jsonProtocol.makeMessage(deviceKey, sensorReadings);
+        }
+
+        payloadSize += escapedSize(values.front());
+    }
+
+    std::string payload;
+    payload.reserve(payloadSize);
+
+    payload += '[';
+    for (const auto& sensorReading : sensorReadings)
+    {
+        if (payload.size() != 1)
+        {
+            payload += ',';
+        }
+
+        payload.append(READING_PREFIX, sizeof(READING_PREFIX) - 1);
+        appendValue(payload, sensorReading->getValues().front());
+
+        if (sensorReading->getRtc() == 0)
+        {
+            payload.append(READING_WITHOUT_RTC_SUFFIX, sizeof(READING_WITHOUT_RTC_SUFFIX) - 1);
+            continue;
+        }
+
+        payload.append(RTC_INFIX, sizeof(RTC_INFIX) - 1);
+        appendUnsigned(payload, sensorReading->getRtc());
+        payload.append(READING_SUFFIX, sizeof(READING_SUFFIX) - 1);
+    }
+    payload += ']';
+
+    return std::unique_ptr<Message>(new Message(std::move(payload), readingTemplate->channel));
+}
+
+std::unique_ptr<Message> PrecompiledJsonProtocol::makeMessage(const std::string& deviceKey,
+                                                              const std::vector<std::shared_ptr<Alarm>>& alarms) const
+{
+    return m_jsonProtocol.makeMessage(deviceKey, alarms);
+}
+
+std::unique_ptr<Message> PrecompiledJsonProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const
+{
+    return m_jsonProtocol.makeMessage(deviceKey, actuatorStatuses);
+}
+
+std::unique_ptr<Message> PrecompiledJsonProtocol::makeMessage(const std::string& deviceKey,
+                                                              const std::vector<ConfigurationItem>& configuration) const
+{
+    return m_jsonProtocol.makeMessage(deviceKey, configuration);
+}
+
+void PrecompiledJsonProtocol::addSensors(const std::string& deviceKey, const std::vector<std::string>& references)
+{
+    auto& readingTemplates = m_readingTemplates[deviceKey];
+    for (const auto& reference : references)
+    {
+        // channel is taken from message made by wolkabout::JsonProtocol, so that both always publish to the same one
+        const std::vector<std::shared_ptr<SensorReading>> sensorReadings = {
+          std::make_shared<SensorReading>("", reference)};
+
+        const auto message = m_jsonProtocol.makeMessage(deviceKey, sensorReadings);
+        if (!message)
+        {
+            continue;
+        }
+
+        readingTemplates[reference] = ReadingTemplate{message->getChannel()};
+    }
+}
+
+void PrecompiledJsonProtocol::removeDevice(const std::string& deviceKey)
+{
+    m_readingTemplates.erase(deviceKey);
+}
+
+const PrecompiledJsonProtocol::ReadingTemplate* PrecompiledJsonProtocol::findReadingTemplate(
+  const std::string& deviceKey, const std::string& reference) const
+{
+    const auto device = m_readingTemplates.find(deviceKey);
+    if (device == m_readingTemplates.end())
+    {
+        return nullptr;
+    }
+
+    const auto readingTemplate = device->second.find(reference);
+    return readingTemplate != device->second.end() ? &readingTemplate->second : nullptr;
+}
+
+std::size_t PrecompiledJsonProtocol::escapedSize(const std::string& value)
+{
+    std::size_t size = value.size();
+    for (const char c : value)
+    {
+        if (!needsEscaping(c))
+        {
+            continue;
+        }
+
+        // two character escape sequences, or six character unicode escapes for other control characters
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '\b':
+        case '\f':
+        case '\n':
+        case '\r':
+        case '\t':
+            size += 1;
+            break;
+        default:
+            size += 5;
+        }
+    }
+
+    return size;
+}
+
+void PrecompiledJsonProtocol::appendValue(std::string& payload, const std::string& value)
+{
+    // numeric and most string values are copied at once
+    if (std::none_of(value.begin(), value.end(), needsEscaping))
+    {
+        payload += value;
+        return;
+    }
+
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for (const char c : value)
+    {
+        switch (c)
+        {
+        case '"':
+            payload += "\\\"";
+            break;
+        case '\\':
+            payload += "\\\\";
+            break;
+        case '\b':
+            payload += "\\b";
+            break;
+        case '\f':
+            payload += "\\f";
+            break;
+        case '\n':
+            payload += "\\n";
+            break;
+        case '\r':
+            payload += "\\r";
+            break;
+        case '\t':
+            payload += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                payload += "\\u00";
+                payload += HEX_DIGITS[static_cast<unsigned char>(c) >> 4];
+                payload += HEX_DIGITS[static_cast<unsigned char>(c) & 0x0f];
+            }
+            else
+            {
+                payload += c;
+            }
+        }
+    }
+}
+
+void PrecompiledJsonProtocol::appendUnsigned(std::string& payload, unsigned long long int value)
+{
+    char digits[MAX_UNSIGNED_DIGITS];
+    std::size_t count = 0;
+
+    do
+    {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    while (count != 0)
+    {
+        payload += digits[--count];
+    }
+}
+}    // namespace wolkabout
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PRECOMPILEDJSONPROTOCOL_H
+#define PRECOMPILEDJSONPROTOCOL_H
+
+#include "core/protocol/json/JsonProtocol.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief wolkabout::JsonProtocol with sensor reading messages serialized from templates compiled per sensor.<br>
+ *        When sensors of a device are added, channel of each sensor is taken once from wolkabout::JsonProtocol.
+ *        Readings are then written straight into message payload between fixed JSON fragments, values being
+ *        escaped only when they contain characters that need it.<br>
+ *        Readings of sensors that were not added, and multi-value readings, are serialized by
+ *        wolkabout::JsonProtocol, as are all other messages.<br>
+ *        Sensors must be added and removed on the thread that makes messages.
+ */
+class PrecompiledJsonProtocol : public DataProtocol
+{
+public:
+    std::vector<std::string> getInboundChannels() const override;
+    std::vector<std::string> getInboundChannelsForDevice(const std::string& deviceKey) const override;
+
+    std::string extractDeviceKeyFromChannel(const std::string& topic) const override;
+    std::string extractReferenceFromChannel(const std::string& topic) const override;
+
+    bool isActuatorSetMessage(const Message& message) const override;
+    bool isActuatorGetMessage(const Message& message) const override;
+    bool isConfigurationSetMessage(const Message& message) const override;
+    bool isConfigurationGetMessage(const Message& message) const override;
+
+    std::unique_ptr<ActuatorGetCommand> makeActuatorGetCommand(const Message& message) const override;
+    std::unique_ptr<ActuatorSetCommand> makeActuatorSetCommand(const Message& message) const override;
+    std::unique_ptr<ConfigurationSetCommand> makeConfigurationSetCommand(const Message& message) const override;
+
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey, const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const override;
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<std::shared_ptr<Alarm>>& alarms) const override;
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey,
+      const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const override;
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<ConfigurationItem>& configuration) const override;
+
+    /**
+     * @brief Compiles sensor reading templates of device sensors
+     * @param deviceKey Device key
+     * @param references Sensor references
+     */
+    void addSensors(const std::string& deviceKey, const std::vector<std::string>& references);
+
+    /**
+     * @brief Discards sensor reading templates of device
+     */
+    void removeDevice(const std::string& deviceKey);
+
+private:
+    struct ReadingTemplate
+    {
+        std::string channel;
+    };
+
+    const ReadingTemplate* findReadingTemplate(const std::string& deviceKey, const std::string& reference) const;
+
+    static std::size_t escapedSize(const std::string& value);
+    static void appendValue(std::string& payload, const std::string& value);
+    static void appendUnsigned(std::string& payload, unsigned long long int value);
+
+    JsonProtocol m_jsonProtocol;
+
+    std::unordered_map<std::string, std::unordered_map<std::string, ReadingTemplate>> m_readingTemplates;
+};
+}    // namespace wolkabout
+
+#endif    // PRECOMPILEDJSONPROTOCOL_H
@@ -0,0 +1,411 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/msgpack/MessagePackProtocol.h"
+
+#include "core/model/ActuatorGetCommand.h"
+#include "core/model/ActuatorSetCommand.h"
+#include "core/model/ActuatorStatus.h"
+#include "core/model/Alarm.h"
+#include "core/model/ConfigurationSetCommand.h"
+#include "core/model/Message.h"
+#include "core/model/SensorReading.h"
+#include "core/utilities/Logger.h"
+#include "protocol/msgpack/MessagePackReader.h"
+#include "protocol/msgpack/MessagePackWriter.h"
+
+#include <map>
+
+namespace
+{
+void writeValues(wolkabout::MessagePackWriter& writer, const std::vector<std::string>& values)
+{
+    if (values.size() == 1)
+    {
+        writer.writeString(values.front());
+        return;
+    }
+
+    writer.writeArrayHeader(static_cast<std::uint32_t>(values.size()));
+    for (const auto& value : values)
+    {
+        writer.writeString(value);
+    }
+}
+
+void writeSensorReadings(wolkabout::MessagePackWriter& writer,
+                         const std::vector<std::shared_ptr<wolkabout::SensorReading>>& sensorReadings)
+{
+    writer.writeArrayHeader(static_cast<std::uint32_t>(sensorReadings.size()));
+    for (const auto& sensorReading : sensorReadings)
+    {
+        const bool hasRtc = sensorReading->getRtc() != 0;
+        writer.writeMapHeader(hasRtc ? 2 : 1);
+
+        if (hasRtc)
+        {
+            writer.writeString("utc").writeUnsigned(sensorReading->getRtc());
+        }
+
+        writer.writeString("data");
+        writeValues(writer, sensorReading->getValues());
+    }
+}
+
+bool readValues(wolkabout::MessagePackReader& reader, std::vector<std::string>& values)
+{
+    if (reader.nextIsString())
+    {
+        std::string value;
+        if (!reader.readString(value))
+        {
+            return false;
+        }
+
+        values.push_back(value);
+        return true;
+    }
+
+    std::uint32_t size = 0;
+    if (!reader.readArrayHeader(size))
+    {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < size; ++i)
+    {
+        std::string value;
+        if (!reader.readString(value))
+        {
+            return false;
+        }
+
+        values.push_back(value);
+    }
+
+    return true;
+}
+
+std::string toString(wolkabout::ActuatorStatus::State state)
+{
+    switch (state)
+    {
+    case wolkabout::ActuatorStatus::State::READY:
+        return "READY";
+    case wolkabout::ActuatorStatus::State::BUSY:
+        return "BUSY";
+    case wolkabout::ActuatorStatus::State::ERROR:
+    default:
+        return "ERROR";
+    }
+}
+}    // namespace
+
+namespace wolkabout
+{
+const std::string MessagePackProtocol::SENSOR_READING_TOPIC_ROOT = "d2p/sensor_reading/";
+const std::string MessagePackProtocol::EVENTS_TOPIC_ROOT = "d2p/events/";
+const std::string MessagePackProtocol::ACTUATION_STATUS_TOPIC_ROOT = "d2p/actuator_status/";
+const std::string MessagePackProtocol::CONFIGURATION_RESPONSE_TOPIC_ROOT = "d2p/configuration_get/";
+const std::string MessagePackProtocol::SENSOR_READINGS_ENVELOPE_TOPIC = "d2p/sensor_reading_envelope";
+
+const std::string MessagePackProtocol::DEVICE_PATH_PREFIX = "d/";
+const std::string MessagePackProtocol::REFERENCE_PATH_PREFIX = "r/";
+
+std::vector<std::string> MessagePackProtocol::getInboundChannels() const
+{
+    return m_jsonProtocol.getInboundChannels();
+}
+
+std::vector<std::string> MessagePackProtocol::getInboundChannelsForDevice(const std::string& deviceKey) const
+{
+    return m_jsonProtocol.getInboundChannelsForDevice(deviceKey);
+}
+
+std::string MessagePackProtocol::extractDeviceKeyFromChannel(const std::string& topic) const
+{
+    return m_jsonProtocol.extractDeviceKeyFromChannel(topic);
+}
+
+std::string MessagePackProtocol::extractReferenceFromChannel(const std::string& topic) const
+{
+    return m_jsonProtocol.extractReferenceFromChannel(topic);
+}
+
+bool MessagePackProtocol::isActuatorSetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isActuatorSetMessage(message);
+}
+
+bool MessagePackProtocol::isActuatorGetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isActuatorGetMessage(message);
+}
+
+bool MessagePackProtocol::isConfigurationSetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isConfigurationSetMessage(message);
+}
+
+bool MessagePackProtocol::isConfigurationGetMessage(const Message& message) const
+{
+    return m_jsonProtocol.isConfigurationGetMessage(message);
+}
+
+std::unique_ptr<ActuatorGetCommand> MessagePackProtocol::makeActuatorGetCommand(const Message& message) const
+{
+    // actuator get carries no payload, reference is part of the channel
+    return m_jsonProtocol.makeActuatorGetCommand(message);
+}
+
+std::unique_ptr<ActuatorSetCommand> MessagePackProtocol::makeActuatorSetCommand(const Message& message) const
+{
+    if (isJson(message))
+    {
+        return m_jsonProtocol.makeActuatorSetCommand(message);
+    }
+
+    const auto reference = extractReferenceFromChannel(message.getChannel());
+    if (reference.empty())
+    {
+        LOG(DEBUG) << "Unable to extract reference from channel: " << message.getChannel();
+        return nullptr;
+    }
+
+    MessagePackReader reader{message.getContent()};
+
+    std::uint32_t size = 0;
+    if (!reader.readMapHeader(size))
+    {
+        LOG(DEBUG) << "Unable to parse actuator set command";
+        return nullptr;
+    }
+
+    for (std::uint32_t i = 0; i < size; ++i)
+    {
+        std::string key;
+        if (!reader.readString(key))
+        {
+            break;
+        }
+
+        if (key == "value")
+        {
+            std::string value;
+            if (!reader.readString(value))
+            {
+                break;
+            }
+
+            return std::unique_ptr<ActuatorSetCommand>(new ActuatorSetCommand(reference, value));
+        }
+
+        if (!reader.skip())
+        {
+            break;
+        }
+    }
+
+    LOG(DEBUG) << "Unable to parse actuator set command";
+    return nullptr;
+}
+
+std::unique_ptr<ConfigurationSetCommand> MessagePackProtocol::makeConfigurationSetCommand(
+  const Message& message) const
+{
+    if (isJson(message))
+    {
+        return m_jsonProtocol.makeConfigurationSetCommand(message);
+    }
+
+    MessagePackReader reader{message.getContent()};
+
+    std::uint32_t size = 0;
+    if (!reader.readMapHeader(size))
+    {
+        LOG(DEBUG) << "Unable to parse configuration set command";
+        return nullptr;
+    }
+
+    for (std::uint32_t i = 0; i < size; ++i)
+    {
+        std::string key;
+        if (!reader.readString(key))
+        {
+            break;
+        }
+
+        if (key != "values")
+        {
+            if (!reader.skip())
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        std::uint32_t itemsCount = 0;
+        if (!reader.readMapHeader(itemsCount))
+        {
+            break;
+        }
+
+        std::vector<ConfigurationItem> items;
+        for (std::uint32_t j = 0; j < itemsCount; ++j)
+        {
+            std::string reference;
+            std::vector<std::string> values;
+            if (!reader.readString(reference) || !readValues(reader, values))
+            {
+                LOG(DEBUG) << "Unable to parse configuration set command";
+                return nullptr;
+            }
+
+            items.emplace_back(values, reference);
+        }
+
+        return std::unique_ptr<ConfigurationSetCommand>(new ConfigurationSetCommand(items));
+    }
+
+    LOG(DEBUG) << "Unable to parse configuration set command";
+    return nullptr;
+}
+
+std::unique_ptr<Message> MessagePackProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const
+{
+    if (sensorReadings.empty())
+    {
+        return nullptr;
+    }
+
+    MessagePackWriter writer;
+    writeSensorReadings(writer, sensorReadings);
+
+    const auto channel = makeChannel(SENSOR_READING_TOPIC_ROOT, deviceKey, sensorReadings.front()->getReference());
+    return std::unique_ptr<Message>(new Message(writer.release(), channel));
+}
+
+std::unique_ptr<Message> MessagePackProtocol::makeMessage(const std::string& deviceKey,
+                                                          const std::vector<std::shared_ptr<Alarm>>& alarms) const
+{
+    if (alarms.empty())
+    {
+        return nullptr;
+    }
+
+    MessagePackWriter writer;
+    writer.writeArrayHeader(static_cast<std::uint32_t>(alarms.size()));
+    for (const auto& alarm : alarms)
+    {
+        const bool hasRtc = alarm->getRtc() != 0;
+        writer.writeMapHeader(hasRtc ? 2 : 1);
+
+        if (hasRtc)
+        {
+            writer.writeString("utc").writeUnsigned(alarm->getRtc());
+        }
+
+        writer.writeString("active").writeBool(alarm->getActive());
+    }
+
+    const auto channel = makeChannel(EVENTS_TOPIC_ROOT, deviceKey, alarms.front()->getReference());
+    return std::unique_ptr<Message>(new Message(writer.release(), channel));
+}
+
+std::unique_ptr<Message> MessagePackProtocol::makeMessage(
+  const std::string& deviceKey, const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const
+{
+    if (actuatorStatuses.empty())
+    {
+        return nullptr;
+    }
+
+    // the same as in JSON, only one status is published per message
+    const auto& actuatorStatus = actuatorStatuses.front();
+
+    MessagePackWriter writer;
+    writer.writeMapHeader(2);
+    writer.writeString("status").writeString(toString(actuatorStatus->getState()));
+    writer.writeString("value").writeString(actuatorStatus->getValue());
+
+    const auto channel = makeChannel(ACTUATION_STATUS_TOPIC_ROOT, deviceKey, actuatorStatus->getReference());
+    return std::unique_ptr<Message>(new Message(writer.release(), channel));
+}
+
+std::unique_ptr<Message> MessagePackProtocol::makeMessage(const std::string& deviceKey,
+                                                          const std::vector<ConfigurationItem>& configuration) const
+{
+    MessagePackWriter writer;
+    writer.writeMapHeader(1);
+    writer.writeString("values");
+    writer.writeMapHeader(static_cast<std::uint32_t>(configuration.size()));
+    for (const auto& item : configuration)
+    {
+        writer.writeString(item.getReference());
+        writeValues(writer, item.getValues());
+    }
+
+    const auto channel = CONFIGURATION_RESPONSE_TOPIC_ROOT + DEVICE_PATH_PREFIX + deviceKey;
+    return std::unique_ptr<Message>(new Message(writer.release(), channel));
+}
+
+std::unique_ptr<Message> MessagePackProtocol::makeEnvelope(const std::vector<SensorReadingsGroup>& groups) const
+{
+    if (groups.empty())
+    {
+        return nullptr;
+    }
+
+    // groups of a device are written under one key, even if they are not adjacent
+    std::map<std::string, std::vector<const SensorReadingsGroup*>> devices;
+    for (const auto& group : groups)
+    {
+        devices[group.deviceKey].push_back(&group);
+    }
+
+    MessagePackWriter writer;
+    writer.writeMapHeader(static_cast<std::uint32_t>(devices.size()));
+    for (const auto& device : devices)
+    {
+        writer.writeString(device.first);
+        writer.writeMapHeader(static_cast<std::uint32_t>(device.second.size()));
+        for (const auto group : device.second)
+        {
+            writer.writeString(group->sensorReadings.front()->getReference());
+            writeSensorReadings(writer, group->sensorReadings);
+        }
+    }
+
+    const auto channel = devices.size() == 1 ?
+                           SENSOR_READINGS_ENVELOPE_TOPIC + "/" + DEVICE_PATH_PREFIX + devices.begin()->first :
+                           SENSOR_READINGS_ENVELOPE_TOPIC;
+    return std::unique_ptr<Message>(new Message(writer.release(), channel));
+}
+
+bool MessagePackProtocol::isJson(const Message& message)
+{
+    const auto& content = message.getContent();
+    return content.empty() || content.front() == '{' || content.front() == '[';
+}
+
+std::string MessagePackProtocol::makeChannel(const std::string& root, const std::string& deviceKey,
+                                             const std::string& reference)
+{
+    return root + DEVICE_PATH_PREFIX + deviceKey + "/" + REFERENCE_PATH_PREFIX + reference;
+}
+}    // namespace wolkabout
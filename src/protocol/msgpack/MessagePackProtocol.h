@@ -0,0 +1,87 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MESSAGEPACKPROTOCOL_H
+#define MESSAGEPACKPROTOCOL_H
+
+#include "core/protocol/json/JsonProtocol.h"
+#include "protocol/SensorReadingsEnvelopeProtocol.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Data protocol with the same channels as wolkabout::JsonProtocol, and MessagePack encoded payloads.<br>
+ *        Sensor readings, alarms, actuator statuses and configuration are sent as MessagePack maps
+ *        with the same field names as their JSON counterparts.<br>
+ *        Inbound commands are accepted in both encodings, JSON payloads are recognized by leading '{' or '['.<br>
+ *        Sensor readings envelope is a map of device keys to maps of references to arrays of readings.
+ *        It is published on "d2p/sensor_reading_envelope/d/<device key>" if it holds readings of a single device,
+ *        and on "d2p/sensor_reading_envelope" otherwise.
+ */
+class MessagePackProtocol : public DataProtocol, public SensorReadingsEnvelopeProtocol
+{
+public:
+    std::vector<std::string> getInboundChannels() const override;
+    std::vector<std::string> getInboundChannelsForDevice(const std::string& deviceKey) const override;
+
+    std::string extractDeviceKeyFromChannel(const std::string& topic) const override;
+    std::string extractReferenceFromChannel(const std::string& topic) const override;
+
+    bool isActuatorSetMessage(const Message& message) const override;
+    bool isActuatorGetMessage(const Message& message) const override;
+    bool isConfigurationSetMessage(const Message& message) const override;
+    bool isConfigurationGetMessage(const Message& message) const override;
+
+    std::unique_ptr<ActuatorGetCommand> makeActuatorGetCommand(const Message& message) const override;
+    std::unique_ptr<ActuatorSetCommand> makeActuatorSetCommand(const Message& message) const override;
+    std::unique_ptr<ConfigurationSetCommand> makeConfigurationSetCommand(const Message& message) const override;
+
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey, const std::vector<std::shared_ptr<SensorReading>>& sensorReadings) const override;
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<std::shared_ptr<Alarm>>& alarms) const override;
+    std::unique_ptr<Message> makeMessage(
+      const std::string& deviceKey,
+      const std::vector<std::shared_ptr<ActuatorStatus>>& actuatorStatuses) const override;
+    std::unique_ptr<Message> makeMessage(const std::string& deviceKey,
+                                         const std::vector<ConfigurationItem>& configuration) const override;
+
+    std::unique_ptr<Message> makeEnvelope(const std::vector<SensorReadingsGroup>& groups) const override;
+
+private:
+    static bool isJson(const Message& message);
+
+    static std::string makeChannel(const std::string& root, const std::string& deviceKey,
+                                   const std::string& reference);
+
+    JsonProtocol m_jsonProtocol;
+
+    static const std::string SENSOR_READING_TOPIC_ROOT;
+    static const std::string EVENTS_TOPIC_ROOT;
+    static const std::string ACTUATION_STATUS_TOPIC_ROOT;
+    static const std::string CONFIGURATION_RESPONSE_TOPIC_ROOT;
+    static const std::string SENSOR_READINGS_ENVELOPE_TOPIC;
+
+    static const std::string DEVICE_PATH_PREFIX;
+    static const std::string REFERENCE_PATH_PREFIX;
+};
+}    // namespace wolkabout
+
+#endif    // MESSAGEPACKPROTOCOL_H
@@ -0,0 +1,242 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/msgpack/MessagePackReader.h"
+
+namespace wolkabout
+{
+MessagePackReader::MessagePackReader(const std::string& buffer) : m_buffer{buffer}, m_position{0} {}
+
+bool MessagePackReader::readMapHeader(std::uint32_t& size)
+{
+    return readContainerHeader(0x80, 0xde, 0xdf, size);
+}
+
+bool MessagePackReader::readArrayHeader(std::uint32_t& size)
+{
+    return readContainerHeader(0x90, 0xdc, 0xdd, size);
+}
+
+bool MessagePackReader::readString(std::string& value)
+{
+    if (atEnd())
+    {
+        return false;
+    }
+
+    const auto marker = peek();
+    std::size_t headerSize = 1;
+    std::uint64_t size = 0;
+
+    if ((marker & 0xe0) == 0xa0)
+    {
+        size = marker & 0x1f;
+    }
+    else if (marker >= 0xd9 && marker <= 0xdb)
+    {
+        const unsigned int bytes = 1u << (marker - 0xd9);
+        if (!readBigEndian(m_position + 1, bytes, size))
+        {
+            return false;
+        }
+
+        headerSize += bytes;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (m_buffer.size() - m_position - headerSize < size)
+    {
+        return false;
+    }
+
+    value = m_buffer.substr(m_position + headerSize, static_cast<std::size_t>(size));
+    m_position += headerSize + static_cast<std::size_t>(size);
+    return true;
+}
+
+bool MessagePackReader::nextIsString() const
+{
+    if (atEnd())
+    {
+        return false;
+    }
+
+    const auto marker = peek();
+    return (marker & 0xe0) == 0xa0 || (marker >= 0xd9 && marker <= 0xdb);
+}
+
+bool MessagePackReader::nextIsArray() const
+{
+    if (atEnd())
+    {
+        return false;
+    }
+
+    const auto marker = peek();
+    return (marker & 0xf0) == 0x90 || marker == 0xdc || marker == 0xdd;
+}
+
+bool MessagePackReader::skip()
+{
+    // nested values are counted instead of recursed into, so that deeply nested input can not exhaust the stack
+    std::uint64_t remaining = 1;
+    while (remaining != 0)
+    {
+        --remaining;
+        if (!skipHeader(remaining))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MessagePackReader::skipHeader(std::uint64_t& remaining)
+{
+    if (atEnd())
+    {
+        return false;
+    }
+
+    const auto marker = peek();
+
+    if (marker <= 0x7f || marker >= 0xe0 || marker == 0xc0 || marker == 0xc2 || marker == 0xc3)
+    {
+        return skipBytes(1);
+    }
+
+    if (nextIsString())
+    {
+        std::string value;
+        return readString(value);
+    }
+
+    std::uint32_t size = 0;
+    if (readArrayHeader(size))
+    {
+        remaining += size;
+        return true;
+    }
+
+    if (readMapHeader(size))
+    {
+        remaining += 2 * static_cast<std::uint64_t>(size);
+        return true;
+    }
+
+    switch (marker)
+    {
+    case 0xcc:
+    case 0xd0:
+        return skipBytes(2);
+    case 0xcd:
+    case 0xd1:
+        return skipBytes(3);
+    case 0xca:
+    case 0xce:
+    case 0xd2:
+        return skipBytes(5);
+    case 0xcb:
+    case 0xcf:
+    case 0xd3:
+        return skipBytes(9);
+    case 0xc4:
+    case 0xc5:
+    case 0xc6:
+    {
+        const unsigned int bytes = 1u << (marker - 0xc4);
+        std::uint64_t length = 0;
+        return readBigEndian(m_position + 1, bytes, length) && skipBytes(1 + bytes + length);
+    }
+    default:
+        return false;
+    }
+}
+
+bool MessagePackReader::atEnd() const
+{
+    return m_position >= m_buffer.size();
+}
+
+bool MessagePackReader::readContainerHeader(std::uint8_t fixMask, std::uint8_t marker16, std::uint8_t marker32,
+                                            std::uint32_t& size)
+{
+    if (atEnd())
+    {
+        return false;
+    }
+
+    const auto marker = peek();
+    if ((marker & 0xf0) == fixMask)
+    {
+        size = marker & 0x0f;
+        m_position += 1;
+        return true;
+    }
+
+    if (marker != marker16 && marker != marker32)
+    {
+        return false;
+    }
+
+    const unsigned int bytes = marker == marker16 ? 2 : 4;
+    std::uint64_t value = 0;
+    if (!readBigEndian(m_position + 1, bytes, value))
+    {
+        return false;
+    }
+
+    size = static_cast<std::uint32_t>(value);
+    m_position += 1 + bytes;
+    return true;
+}
+
+bool MessagePackReader::readBigEndian(std::size_t position, unsigned int bytes, std::uint64_t& value) const
+{
+    if (position > m_buffer.size() || m_buffer.size() - position < bytes)
+    {
+        return false;
+    }
+
+    value = 0;
+    for (unsigned int i = 0; i < bytes; ++i)
+    {
+        value = (value << 8) | static_cast<std::uint8_t>(m_buffer[position + i]);
+    }
+
+    return true;
+}
+
+bool MessagePackReader::skipBytes(std::uint64_t bytes)
+{
+    if (m_buffer.size() - m_position < bytes)
+    {
+        return false;
+    }
+
+    m_position += static_cast<std::size_t>(bytes);
+    return true;
+}
+
+std::uint8_t MessagePackReader::peek() const
+{
+    return static_cast<std::uint8_t>(m_buffer[m_position]);
+}
+}    // namespace wolkabout
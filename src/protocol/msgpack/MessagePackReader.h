@@ -0,0 +1,64 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MESSAGEPACKREADER_H
+#define MESSAGEPACKREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Reads MessagePack encoded values from a buffer.<br>
+ *        Each read returns false, without advancing, if next value is not of requested type or is truncated.
+ */
+class MessagePackReader
+{
+public:
+    explicit MessagePackReader(const std::string& buffer);
+
+    bool readMapHeader(std::uint32_t& size);
+    bool readArrayHeader(std::uint32_t& size);
+    bool readString(std::string& value);
+
+    bool nextIsString() const;
+    bool nextIsArray() const;
+
+    /**
+     * @brief Skips next value, including all elements of arrays and maps, however deeply they are nested
+     * @return false if value is malformed
+     */
+    bool skip();
+
+    bool atEnd() const;
+
+private:
+    bool readContainerHeader(std::uint8_t fixMask, std::uint8_t marker16, std::uint8_t marker32, std::uint32_t& size);
+    // skips scalar value, or header of array or map, adding count of its elements to remaining values
+    bool skipHeader(std::uint64_t& remaining);
+    bool readBigEndian(std::size_t position, unsigned int bytes, std::uint64_t& value) const;
+    bool skipBytes(std::uint64_t bytes);
+
+    std::uint8_t peek() const;
+
+    const std::string& m_buffer;
+    std::size_t m_position;
+};
+}    // namespace wolkabout
+
+#endif    // MESSAGEPACKREADER_H
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "protocol/msgpack/MessagePackWriter.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+MessagePackWriter& MessagePackWriter::writeNil()
+{
+    m_buffer.push_back(static_cast<char>(0xc0));
+    return *this;
+}
+
+MessagePackWriter& MessagePackWriter::writeBool(bool value)
+{
+    m_buffer.push_back(static_cast<char>(value ? 0xc3 : 0xc2));
+    return *this;
+}
+
+MessagePackWriter& MessagePackWriter::writeUnsigned(std::uint64_t value)
+{
+    if (value < 0x80)
+    {
+        m_buffer.push_back(static_cast<char>(value));
+    }
+    else if (value <= 0xff)
+    {
+        m_buffer.push_back(static_cast<char>(0xcc));
+        writeBigEndian(value, 1);
+    }
+    else if (value <= 0xffff)
+    {
+        m_buffer.push_back(static_cast<char>(0xcd));
+        writeBigEndian(value, 2);
+    }
+    else if (value <= 0xffffffff)
+    {
+        m_buffer.push_back(static_cast<char>(0xce));
+        writeBigEndian(value, 4);
+    }
+    else
+    {
+        m_buffer.push_back(static_cast<char>(0xcf));
+        writeBigEndian(value, 8);
+    }
+
+    return *this;
+}
+
+MessagePackWriter& MessagePackWriter::writeString(const std::string& value)
+{
+    const auto size = value.size();
+    if (size < 32)
+    {
+        m_buffer.push_back(static_cast<char>(0xa0 | size));
+    }
+    else if (size <= 0xff)
+    {
+        m_buffer.push_back(static_cast<char>(0xd9));
+        writeBigEndian(size, 1);
+    }
+    else if (size <= 0xffff)
+    {
+        m_buffer.push_back(static_cast<char>(0xda));
+        writeBigEndian(size, 2);
+    }
+    else
+    {
+        m_buffer.push_back(static_cast<char>(0xdb));
+        writeBigEndian(size, 4);
+    }
+
+    m_buffer.append(value);
+    return *this;
+}
+
+MessagePackWriter& MessagePackWriter::writeArrayHeader(std::uint32_t size)
+{
+    if (size < 16)
+    {
+        m_buffer.push_back(static_cast<char>(0x90 | size));
+    }
+    else if (size <= 0xffff)
+    {
+        m_buffer.push_back(static_cast<char>(0xdc));
+        writeBigEndian(size, 2);
+    }
+    else
+    {
+        m_buffer.push_back(static_cast<char>(0xdd));
+        writeBigEndian(size, 4);
+    }
+
+    return *this;
+}
+
+MessagePackWriter& MessagePackWriter::writeMapHeader(std::uint32_t size)
+{
+    if (size < 16)
+    {
+        m_buffer.push_back(static_cast<char>(0x80 | size));
+    }
+    else if (size <= 0xffff)
+    {
+        m_buffer.push_back(static_cast<char>(0xde));
+        writeBigEndian(size, 2);
+    }
+    else
+    {
+        m_buffer.push_back(static_cast<char>(0xdf));
+        writeBigEndian(size, 4);
+    }
+
+    return *this;
+}
+
+const std::string& MessagePackWriter::getBuffer() const
+{
+    return m_buffer;
+}
+
+std::string MessagePackWriter::release()
+{
+    return std::move(m_buffer);
+}
+
+void MessagePackWriter::writeBigEndian(std::uint64_t value, unsigned int bytes)
+{
+    for (unsigned int i = bytes; i > 0; --i)
+    {
+        m_buffer.push_back(static_cast<char>((value >> (8 * (i - 1))) & 0xff));
+    }
+}
+}    // namespace wolkabout
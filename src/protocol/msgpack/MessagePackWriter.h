@@ -0,0 +1,58 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MESSAGEPACKWRITER_H
+#define MESSAGEPACKWRITER_H
+
+#include <cstdint>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Appends MessagePack encoded values to a buffer.<br>
+ *        Supports the subset of the format used by wolkabout::MessagePackProtocol:
+ *        nil, booleans, integers, strings, arrays and maps.
+ */
+class MessagePackWriter
+{
+public:
+    MessagePackWriter& writeNil();
+    MessagePackWriter& writeBool(bool value);
+    MessagePackWriter& writeUnsigned(std::uint64_t value);
+    MessagePackWriter& writeString(const std::string& value);
+
+    /**
+     * @brief Starts array, followed by size values
+     */
+    MessagePackWriter& writeArrayHeader(std::uint32_t size);
+
+    /**
+     * @brief Starts map, followed by size key-value pairs
+     */
+    MessagePackWriter& writeMapHeader(std::uint32_t size);
+
+    const std::string& getBuffer() const;
+    std::string release();
+
+private:
+    void writeBigEndian(std::uint64_t value, unsigned int bytes);
+
+    std::string m_buffer;
+};
+}    // namespace wolkabout
+
+#endif    // MESSAGEPACKWRITER_H
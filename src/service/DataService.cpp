@@ -19,6 +19,7 @@
 #include "core/connectivity/ConnectivityService.h"
 #include "core/model/ActuatorGetCommand.h"
 #include "core/model/ActuatorSetCommand.h"
+#include "core/model/Alarm.h"
 #include "core/model/ConfigurationSetCommand.h"
 #include "core/model/Message.h"
 #include "core/model/SensorReading.h"
@@ -28,15 +29,21 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <tuple>
+#include <utility>
 
 namespace wolkabout
 {
 const std::string DataService::PERSISTENCE_KEY_DELIMITER = "+";
+const constexpr unsigned int DataService::PUBLISH_BATCH_ITEMS_COUNT;
+const constexpr std::size_t DataService::TIMED_READINGS_PER_KEY;
 
 DataService::DataService(DataProtocol& protocol, Persistence& persistence, ConnectivityService& connectivityService,
                          const ActuatorSetHandler& actuatorSetHandler, const ActuatorGetHandler& actuatorGetHandler,
                          const ConfigurationSetHandler& configurationSetHandler,
-                         const ConfigurationGetHandler& configurationGetHandler)
+                         const ConfigurationGetHandler& configurationGetHandler,
+                         unsigned int publishBatchItemsCount, std::size_t publishBatchMaxBytes)
 : m_protocol{protocol}
 , m_persistence{persistence}
 , m_connectivityService{connectivityService}
@@ -44,6 +51,22 @@ DataService::DataService(DataProtocol& protocol, Persistence& persistence, Conne
 , m_actuatorGetHandler{actuatorGetHandler}
 , m_configurationSetHandler{configurationSetHandler}
 , m_configurationGetHandler{configurationGetHandler}
+, m_publishBatchItemsCount{publishBatchItemsCount > 0 ? publishBatchItemsCount : PUBLISH_BATCH_ITEMS_COUNT}
+, m_publishBatchMaxBytes{publishBatchMaxBytes}
+, m_envelopeProtocol{nullptr}
+, m_envelopesAcrossDevices{false}
+, m_readingAggregator{[this](const std::string& deviceKey, const std::string& reference,
+                             const ReadingAggregation& aggregation, const ReadingAggregator::Window& window) {
+    persistAggregate(deviceKey, reference, aggregation, window);
+}}
+, m_sensorReadingsKeys{PERSISTENCE_KEY_DELIMITER}
+, m_alarmsKeys{PERSISTENCE_KEY_DELIMITER}
+, m_actuatorStatusesKeys{PERSISTENCE_KEY_DELIMITER}
+, m_sensorReadingsKeysIndexed{false}
+, m_alarmsKeysIndexed{false}
+, m_actuatorStatusesKeysIndexed{false}
+, m_bufferedSensorReadings{0}
+, m_tracer{nullptr}
 {
 }
 
@@ -51,6 +74,8 @@ void DataService::messageReceived(std::shared_ptr<Message> message)
 {
     assert(message);
 
+    const auto received = m_tracer ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
     const std::string deviceKey = m_protocol.extractDeviceKeyFromChannel(message->getChannel());
 
     if (m_protocol.isActuatorGetMessage(*message))
@@ -87,7 +112,10 @@ void DataService::messageReceived(std::shared_ptr<Message> message)
 
         if (m_actuatorSetHandler)
         {
-            m_actuatorSetHandler(deviceKey, command->getReference(), command->getValue());
+            auto trace = m_tracer ? m_tracer->begin(deviceKey, command->getReference(), command->getValue()) : nullptr;
+            ActuationTracer::spanEnd(trace, TraceHop::INBOUND_RECEIVE, received);
+
+            m_actuatorSetHandler(deviceKey, command->getReference(), command->getValue(), std::move(trace));
         }
     }
     else if (m_protocol.isConfigurationGetMessage(*message))
@@ -125,19 +153,193 @@ const Protocol& DataService::getProtocol()
 void DataService::addSensorReading(const std::string& deviceKey, const std::string& reference, const std::string& value,
                                    unsigned long long int rtc)
 {
-    auto sensorReading = std::make_shared<SensorReading>(value, reference, rtc);
+    if (hasReadingStages(reference))
+    {
+        const ReadingValue readingValue{value};
+        if (!passReadingStages(deviceKey, reference, &readingValue, 1, rtc))
+        {
+            return;
+        }
+    }
 
-    m_persistence.putSensorReading(makePersistenceKey(deviceKey, reference), sensorReading);
+    const std::string& key = m_sensorReadingsKeys.getKey(deviceKey, reference);
+    persistSensorReading(key, makeSensorReading(key, value, reference, rtc));
 }
 
 void DataService::addSensorReading(const std::string& deviceKey, const std::string& reference,
                                    const std::vector<std::string>& values, unsigned long long int rtc)
 {
-    auto sensorReading = std::make_shared<SensorReading>(values, reference, rtc);
+    if (hasReadingStages(reference))
+    {
+        const std::vector<ReadingValue> readingValues(values.begin(), values.end());
+        if (!passReadingStages(deviceKey, reference, readingValues.data(), readingValues.size(), rtc))
+        {
+            return;
+        }
+    }
+
+    const std::string& key = m_sensorReadingsKeys.getKey(deviceKey, reference);
+    persistSensorReading(key, makeSensorReading(key, values, reference, rtc));
+}
+
+void DataService::addSensorReading(const std::string& deviceKey, const std::string& reference,
+                                   const ReadingValue& value, unsigned long long int rtc)
+{
+    if (hasReadingStages(reference) && !passReadingStages(deviceKey, reference, &value, 1, rtc))
+    {
+        return;
+    }
+
+    const std::string& key = m_sensorReadingsKeys.getKey(deviceKey, reference);
+    persistSensorReading(key, makeSensorReading(key, value.toString(), reference, rtc));
+}
+
+void DataService::addSensorReading(const std::string& deviceKey, const std::string& reference,
+                                   const std::vector<ReadingValue>& values, unsigned long long int rtc)
+{
+    if (hasReadingStages(reference) && !passReadingStages(deviceKey, reference, values.data(), values.size(), rtc))
+    {
+        return;
+    }
+
+    const std::string& key = m_sensorReadingsKeys.getKey(deviceKey, reference);
+    persistSensorReading(key, makeSensorReading(key, toStrings(values), reference, rtc));
+}
+
+void DataService::addSensorReadings(const std::string& deviceKey,
+                                    const std::vector<SensorReadingBatch::Reading>& readings,
+                                    unsigned long long int defaultRtc)
+{
+    const std::string* lastReference = nullptr;
+    const std::string* key = nullptr;
+
+    for (const auto& reading : readings)
+    {
+        // readings of the same sensor usually come together, reuse key while reference does not change
+        if (!lastReference || *lastReference != reading.reference)
+        {
+            key = &m_sensorReadingsKeys.getKey(deviceKey, reading.reference);
+            lastReference = &reading.reference;
+        }
 
-    auto key = makePersistenceKey(deviceKey, reference);
+        const auto rtc = reading.rtc != 0 ? reading.rtc : defaultRtc;
 
-    m_persistence.putSensorReading(key, sensorReading);
+        if (hasReadingStages(reading.reference))
+        {
+            const bool passed =
+              reading.isMultiValue() ?
+                passReadingStages(deviceKey, reading.reference, reading.values.data(), reading.values.size(), rtc) :
+                passReadingStages(deviceKey, reading.reference, &reading.value, 1, rtc);
+
+            if (!passed)
+            {
+                continue;
+            }
+        }
+
+        auto sensorReading = reading.isMultiValue() ?
+                               makeSensorReading(*key, toStrings(reading.values), reading.reference, rtc) :
+                               makeSensorReading(*key, reading.value.toString(), reading.reference, rtc);
+
+        persistSensorReading(*key, sensorReading);
+    }
+}
+
+void DataService::setReadingFilter(const std::string& reference, const ReadingFilter& filter)
+{
+    m_readingFilterStage.setFilter(reference, filter);
+}
+
+void DataService::setReadingAggregation(const std::string& reference, const ReadingAggregation& aggregation)
+{
+    m_readingAggregator.setAggregation(reference, aggregation);
+}
+
+void DataService::closeAggregationWindows(unsigned long long int now)
+{
+    m_readingAggregator.closeIdleWindows(now);
+}
+
+void DataService::removeReadingsState(const std::string& deviceKey)
+{
+    m_readingFilterStage.removeDevice(deviceKey);
+    m_readingAggregator.removeDevice(deviceKey);
+
+    for (auto it = m_persistedReadings.begin(); it != m_persistedReadings.end();)
+    {
+        const std::string* keyDeviceKey = m_sensorReadingsKeys.getDeviceKey(it->first);
+        if (keyDeviceKey && *keyDeviceKey == deviceKey)
+        {
+            it = m_persistedReadings.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // slabs holding readings which are still buffered outlive their arena, and are freed with the last of them
+    for (auto it = m_readingArenas.begin(); it != m_readingArenas.end();)
+    {
+        const std::string* keyDeviceKey = m_sensorReadingsKeys.getDeviceKey(*it->first);
+        if (keyDeviceKey && *keyDeviceKey == deviceKey)
+        {
+            it = m_readingArenas.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void DataService::dropOldestSensorReading(const std::string& deviceKey, const std::string& reference)
+{
+    const auto& key = m_sensorReadingsKeys.getKey(deviceKey, reference);
+    if (m_persistence.getSensorReadings(key, 1).empty())
+    {
+        return;
+    }
+
+    m_persistence.removeSensorReadings(key, 1);
+    countRemovedSensorReadings(key, 1, false);
+}
+
+DataService::Metrics::Metrics(MetricsRegistry& metricsRegistry)
+: registry{metricsRegistry}
+, readingsPersisted{metricsRegistry.counter("data.readings.persisted")}
+, readingsPublished{metricsRegistry.counter("data.readings.published")}
+, readingsDiscarded{metricsRegistry.counter("data.readings.discarded")}
+, messagesPublished{metricsRegistry.counter("data.messages.published")}
+, messagesFailed{metricsRegistry.counter("data.messages.failed")}
+, readingsPublishLatency{metricsRegistry.histogram("data.readings.publish_latency_us")}
+{
+}
+
+void DataService::setMetrics(MetricsRegistry& metrics)
+{
+    m_metrics.reset(new Metrics(metrics));
+}
+
+std::string DataService::bufferedReadingsGaugeName(const std::string& deviceKey)
+{
+    return "data.readings.buffered." + deviceKey;
+}
+
+void DataService::setTracer(ActuationTracer& tracer)
+{
+    m_tracer = &tracer;
+}
+
+void DataService::setSensorReadingsEnvelopes(const SensorReadingsEnvelopeProtocol& protocol, bool acrossDevices)
+{
+    m_envelopeProtocol = &protocol;
+    m_envelopesAcrossDevices = acrossDevices;
+}
+
+std::size_t DataService::getBufferedSensorReadingsCount() const
+{
+    return m_bufferedSensorReadings;
 }
 
 void DataService::addAlarm(const std::string& deviceKey, const std::string& reference, bool active,
@@ -145,15 +347,34 @@ void DataService::addAlarm(const std::string& deviceKey, const std::string& refe
 {
     auto alarm = std::make_shared<Alarm>(active, reference, rtc);
 
-    m_persistence.putAlarm(makePersistenceKey(deviceKey, reference), alarm);
+    m_persistence.putAlarm(m_alarmsKeys.getKey(deviceKey, reference), alarm);
 }
 
 void DataService::addActuatorStatus(const std::string& deviceKey, const std::string& reference,
-                                    const std::string& value, ActuatorStatus::State state)
+                                    const std::string& value, ActuatorStatus::State state,
+                                    std::shared_ptr<ActuationTrace> trace)
 {
     auto actuatorStatusWithRef = std::make_shared<ActuatorStatus>(value, reference, state);
 
-    m_persistence.putActuatorStatus(makePersistenceKey(deviceKey, reference), actuatorStatusWithRef);
+    const std::string& key = m_actuatorStatusesKeys.getKey(deviceKey, reference);
+    if (!m_persistence.putActuatorStatus(key, actuatorStatusWithRef))
+    {
+        if (m_tracer)
+        {
+            m_tracer->finish(trace);
+        }
+
+        return;
+    }
+
+    if (trace)
+    {
+        // persistence keeps only the latest status, so trace of the status it replaced ends unpublished
+        finishActuatorStatusTrace(key, false);
+        m_actuatorStatusTraces[key] = ActuatorStatusTrace{std::move(trace), std::chrono::steady_clock::now()};
+    }
+
+    markActuatorStatusChanged(deviceKey, key);
 }
 
 void DataService::addConfiguration(const std::string& deviceKey, const std::vector<ConfigurationItem>& configuration)
@@ -161,116 +382,399 @@ void DataService::addConfiguration(const std::string& deviceKey, const std::vect
     auto conf = std::make_shared<std::vector<ConfigurationItem>>(configuration);
 
     m_persistence.putConfiguration(deviceKey, conf);
+    m_changedConfigurations.insert(deviceKey);
 }
 
 void DataService::publishSensorReadings()
 {
-    for (const auto& key : m_persistence.getSensorReadingsKeys())
-    {
-        publishSensorReadingsForPersistanceKey(key);
-    }
+    PublishBudget budget;
+    publishSensorReadings(budget);
 }
 
-void DataService::publishSensorReadings(const std::string& deviceKey)
+bool DataService::publishSensorReadings(PublishBudget& budget)
+{
+    return publishCurrentSensorReadings(budget) || publishSensorReadingsBacklog(budget);
+}
+
+bool DataService::publishCurrentSensorReadings(PublishBudget& budget)
+{
+    return publishSensorReadings(budget, false);
+}
+
+bool DataService::publishSensorReadingsBacklog(PublishBudget& budget)
 {
-    const auto& readingskeys = m_persistence.getSensorReadingsKeys();
+    return publishSensorReadings(budget, true);
+}
 
-    const std::vector<std::string> matchingReadingsKeys = findMatchingPersistanceKeys(deviceKey, readingskeys);
+void DataService::markSensorReadingsBacklog()
+{
+    const auto keys = m_persistence.getSensorReadingsKeys();
+    m_sensorReadingsBacklogKeys = std::set<std::string>(keys.begin(), keys.end());
+}
 
-    for (const std::string& matchingKey : matchingReadingsKeys)
+void DataService::markPersistedChanged()
+{
+    for (const auto& key : m_persistence.getActuatorStatusesKeys())
     {
-        publishSensorReadingsForPersistanceKey(matchingKey);
+        const std::string* deviceKey = resolveDeviceKey(m_actuatorStatusesKeys, key);
+        const std::string* indexedKey = deviceKey ? m_actuatorStatusesKeys.findKey(key) : nullptr;
+        if (!indexedKey)
+        {
+            LOG(ERROR) << "Unable to parse persistence key: " << key;
+            continue;
+        }
+
+        markActuatorStatusChanged(*deviceKey, *indexedKey);
+    }
+
+    for (const auto& key : m_persistence.getConfigurationKeys())
+    {
+        m_changedConfigurations.insert(key);
     }
 }
 
-void DataService::publishSensorReadingsForPersistanceKey(const std::string& persistanceKey)
+bool DataService::publishSensorReadings(PublishBudget& budget, bool backlog)
 {
-    const auto sensorReadings = m_persistence.getSensorReadings(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+    const auto keys = m_persistence.getSensorReadingsKeys();
+    if (keys.empty())
+    {
+        // persistence may discard readings on its own, resynchronize once it is drained
+        m_bufferedSensorReadings = 0;
+        m_sensorReadingsBacklogKeys.clear();
+        resetPersistedReadings();
+        return false;
+    }
 
-    if (sensorReadings.empty())
+    if (m_envelopeProtocol)
     {
-        return;
+        std::vector<std::string> passKeys;
+        for (const auto& key : keys)
+        {
+            if ((m_sensorReadingsBacklogKeys.count(key) != 0) == backlog)
+            {
+                passKeys.push_back(key);
+            }
+        }
+
+        return !publishSensorReadingsEnvelopes(passKeys, budget) && budget.exhausted();
     }
 
-    auto pair = parsePersistenceKey(persistanceKey);
-    if (pair.first.empty() || pair.second.empty())
+    for (const auto& key : keys)
     {
-        LOG(ERROR) << "Unable to parse persistence key: " << persistanceKey;
-        m_persistence.removeSensorReadings(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        return;
+        const auto backlogKey = m_sensorReadingsBacklogKeys.find(key);
+        if ((backlogKey != m_sensorReadingsBacklogKeys.end()) != backlog)
+        {
+            continue;
+        }
+
+        if (!publishSensorReadingsForPersistanceKey(key, budget))
+        {
+            return budget.exhausted();
+        }
+
+        if (backlog)
+        {
+            m_sensorReadingsBacklogKeys.erase(backlogKey);
+        }
     }
 
-    const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(pair.first, sensorReadings);
+    return false;
+}
 
-    if (!outboundMessage)
+void DataService::publishSensorReadings(const std::string& deviceKey)
+{
+    if (!m_sensorReadingsKeysIndexed)
     {
-        LOG(ERROR) << "Unable to create message from readings: " << persistanceKey;
-        m_persistence.removeSensorReadings(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        return;
+        indexPersistenceKeys(m_sensorReadingsKeys, m_persistence.getSensorReadingsKeys());
+        m_sensorReadingsKeysIndexed = true;
     }
 
-    if (m_connectivityService.publish(outboundMessage))
+    PublishBudget budget;
+    if (m_envelopeProtocol)
     {
-        m_persistence.removeSensorReadings(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+        publishSensorReadingsEnvelopes(m_sensorReadingsKeys.getKeys(deviceKey), budget);
+        return;
+    }
 
-        // proceed to publish next batch only if publish is successfull
-        publishSensorReadingsForPersistanceKey(persistanceKey);
+    for (const std::string& matchingKey : m_sensorReadingsKeys.getKeys(deviceKey))
+    {
+        if (!publishSensorReadingsForPersistanceKey(matchingKey, budget))
+        {
+            return;
+        }
     }
 }
 
-void DataService::publishAlarms()
+bool DataService::publishSensorReadingsForPersistanceKey(const std::string& persistanceKey, PublishBudget& budget)
 {
-    for (const auto& key : m_persistence.getAlarmsKeys())
+    while (!budget.exhausted())
     {
-        publishAlarmsForPersistanceKey(key);
+        const auto sensorReadings = m_persistence.getSensorReadings(persistanceKey, m_publishBatchItemsCount);
+
+        if (sensorReadings.empty())
+        {
+            return true;
+        }
+
+        const std::string* deviceKey = resolveDeviceKey(m_sensorReadingsKeys, persistanceKey);
+        if (!deviceKey)
+        {
+            LOG(ERROR) << "Unable to parse persistence key: " << persistanceKey;
+            m_persistence.removeSensorReadings(persistanceKey, m_publishBatchItemsCount);
+            countRemovedSensorReadings(persistanceKey, sensorReadings.size(), false);
+            return true;
+        }
+
+        auto itemsCount = sensorReadings.size();
+        std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(*deviceKey, sensorReadings);
+
+        // shrink envelope until it fits, a single reading is always sent as is
+        while (outboundMessage && itemsCount > 1 && exceedsPublishBatchMaxBytes(outboundMessage))
+        {
+            itemsCount /= 2;
+            outboundMessage = m_protocol.makeMessage(
+              *deviceKey, std::vector<std::shared_ptr<SensorReading>>(sensorReadings.begin(),
+                                                                      sensorReadings.begin() + itemsCount));
+        }
+
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create message from readings: " << persistanceKey;
+            m_persistence.removeSensorReadings(persistanceKey, m_publishBatchItemsCount);
+            countRemovedSensorReadings(persistanceKey, sensorReadings.size(), false);
+            return true;
+        }
+
+        // proceed to publish next batch only if publish is successfull
+        if (!publishMessage(outboundMessage))
+        {
+            return false;
+        }
+
+        m_persistence.removeSensorReadings(
+          persistanceKey, itemsCount == sensorReadings.size() ? m_publishBatchItemsCount : itemsCount);
+        countRemovedSensorReadings(persistanceKey, itemsCount, true);
+        budget.consume(outboundMessage->getContent().size());
     }
+
+    return false;
 }
 
-void DataService::publishAlarms(const std::string& deviceKey)
+bool DataService::publishSensorReadingsEnvelopes(const std::vector<std::string>& persistanceKeys,
+                                                 PublishBudget& budget)
 {
-    const auto& alarmsKeys = m_persistence.getAlarmsKeys();
-
-    const std::vector<std::string> matchingAlarmsKeys = findMatchingPersistanceKeys(deviceKey, alarmsKeys);
+    // group of an envelope, with index of its persistence key and whether it holds all readings of the key
+    struct EnvelopeGroup
+    {
+        std::size_t keyIndex;
+        bool drained;
+    };
 
-    for (const std::string& matchingKey : matchingAlarmsKeys)
+    std::size_t nextKey = 0;
+    while (nextKey < persistanceKeys.size())
     {
-        publishAlarmsForPersistanceKey(matchingKey);
+        if (budget.exhausted())
+        {
+            return false;
+        }
+
+        std::vector<SensorReadingsGroup> groups;
+        std::vector<EnvelopeGroup> envelopeGroups;
+        std::size_t itemsCount = 0;
+
+        // key is passed only once it is drained, one that fills the envelope is continued in the next one
+        while (nextKey < persistanceKeys.size() && itemsCount < m_publishBatchItemsCount)
+        {
+            const auto& persistanceKey = persistanceKeys[nextKey];
+            const auto requested = m_publishBatchItemsCount - itemsCount;
+            auto sensorReadings = m_persistence.getSensorReadings(persistanceKey, requested);
+
+            if (sensorReadings.empty())
+            {
+                ++nextKey;
+                continue;
+            }
+
+            const std::string* deviceKey = resolveDeviceKey(m_sensorReadingsKeys, persistanceKey);
+            if (!deviceKey)
+            {
+                LOG(ERROR) << "Unable to parse persistence key: " << persistanceKey;
+                m_persistence.removeSensorReadings(persistanceKey, sensorReadings.size());
+                countRemovedSensorReadings(persistanceKey, sensorReadings.size(), false);
+                continue;
+            }
+
+            if (!m_envelopesAcrossDevices && !groups.empty() && groups.front().deviceKey != *deviceKey)
+            {
+                break;
+            }
+
+            const bool drained = sensorReadings.size() < requested;
+            itemsCount += sensorReadings.size();
+
+            groups.push_back(SensorReadingsGroup{*deviceKey, std::move(sensorReadings)});
+            envelopeGroups.push_back(EnvelopeGroup{nextKey, drained});
+
+            if (drained)
+            {
+                ++nextKey;
+            }
+        }
+
+        if (groups.empty())
+        {
+            return true;
+        }
+
+        std::shared_ptr<Message> outboundMessage = m_envelopeProtocol->makeEnvelope(groups);
+
+        // shrink envelope until it fits, dropping groups first, a single reading is always sent as is
+        while (outboundMessage && exceedsPublishBatchMaxBytes(outboundMessage) &&
+               (groups.size() > 1 || groups.front().sensorReadings.size() > 1))
+        {
+            if (groups.size() > 1)
+            {
+                const auto kept = groups.size() / 2;
+                nextKey = envelopeGroups[kept].keyIndex;
+
+                groups.resize(kept);
+                envelopeGroups.resize(kept);
+            }
+            else
+            {
+                auto& sensorReadings = groups.front().sensorReadings;
+                sensorReadings.resize(sensorReadings.size() / 2);
+
+                envelopeGroups.front().drained = false;
+                nextKey = envelopeGroups.front().keyIndex;
+            }
+
+            outboundMessage = m_envelopeProtocol->makeEnvelope(groups);
+        }
+
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create envelope from readings of " << groups.size() << " sensors";
+            for (std::size_t i = 0; i < groups.size(); ++i)
+            {
+                const auto& persistanceKey = persistanceKeys[envelopeGroups[i].keyIndex];
+                m_persistence.removeSensorReadings(persistanceKey, groups[i].sensorReadings.size());
+                countRemovedSensorReadings(persistanceKey, groups[i].sensorReadings.size(), false);
+            }
+
+            continue;
+        }
+
+        // proceed to publish next envelope only if publish is successfull
+        if (!publishMessage(outboundMessage))
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < groups.size(); ++i)
+        {
+            const auto& persistanceKey = persistanceKeys[envelopeGroups[i].keyIndex];
+            m_persistence.removeSensorReadings(persistanceKey, groups[i].sensorReadings.size());
+            countRemovedSensorReadings(persistanceKey, groups[i].sensorReadings.size(), true);
+
+            if (envelopeGroups[i].drained)
+            {
+                m_sensorReadingsBacklogKeys.erase(persistanceKey);
+            }
+        }
+
+        budget.consume(outboundMessage->getContent().size());
     }
+
+    return true;
 }
 
-void DataService::publishAlarmsForPersistanceKey(const std::string& persistanceKey)
+void DataService::publishAlarms()
 {
-    const auto alarms = m_persistence.getAlarms(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+    PublishBudget budget;
+    publishAlarms(budget);
+}
 
-    if (alarms.empty())
+bool DataService::publishAlarms(PublishBudget& budget)
+{
+    for (const auto& key : m_persistence.getAlarmsKeys())
     {
-        return;
+        if (!publishAlarmsForPersistanceKey(key, budget))
+        {
+            return budget.exhausted();
+        }
     }
 
-    auto pair = parsePersistenceKey(persistanceKey);
-    if (pair.first.empty() || pair.second.empty())
+    return false;
+}
+
+void DataService::publishAlarms(const std::string& deviceKey)
+{
+    if (!m_alarmsKeysIndexed)
     {
-        LOG(ERROR) << "Unable to parse persistence key: " << persistanceKey;
-        m_persistence.removeAlarms(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        return;
+        indexPersistenceKeys(m_alarmsKeys, m_persistence.getAlarmsKeys());
+        m_alarmsKeysIndexed = true;
     }
 
-    const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(pair.first, alarms);
-
-    if (!outboundMessage)
+    PublishBudget budget;
+    for (const std::string& matchingKey : m_alarmsKeys.getKeys(deviceKey))
     {
-        LOG(ERROR) << "Unable to create message from alarms: " << persistanceKey;
-        m_persistence.removeAlarms(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
-        return;
+        if (!publishAlarmsForPersistanceKey(matchingKey, budget))
+        {
+            return;
+        }
     }
+}
 
-    if (m_connectivityService.publish(outboundMessage))
+bool DataService::publishAlarmsForPersistanceKey(const std::string& persistanceKey, PublishBudget& budget)
+{
+    while (!budget.exhausted())
     {
-        m_persistence.removeAlarms(persistanceKey, PUBLISH_BATCH_ITEMS_COUNT);
+        const auto alarms = m_persistence.getAlarms(persistanceKey, m_publishBatchItemsCount);
+
+        if (alarms.empty())
+        {
+            return true;
+        }
+
+        const std::string* deviceKey = resolveDeviceKey(m_alarmsKeys, persistanceKey);
+        if (!deviceKey)
+        {
+            LOG(ERROR) << "Unable to parse persistence key: " << persistanceKey;
+            m_persistence.removeAlarms(persistanceKey, m_publishBatchItemsCount);
+            return true;
+        }
+
+        auto itemsCount = alarms.size();
+        std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(*deviceKey, alarms);
+
+        // shrink envelope until it fits, a single alarm is always sent as is
+        while (outboundMessage && itemsCount > 1 && exceedsPublishBatchMaxBytes(outboundMessage))
+        {
+            itemsCount /= 2;
+            outboundMessage = m_protocol.makeMessage(
+              *deviceKey, std::vector<std::shared_ptr<Alarm>>(alarms.begin(), alarms.begin() + itemsCount));
+        }
+
+        if (!outboundMessage)
+        {
+            LOG(ERROR) << "Unable to create message from alarms: " << persistanceKey;
+            m_persistence.removeAlarms(persistanceKey, m_publishBatchItemsCount);
+            return true;
+        }
 
         // proceed to publish next batch only if publish is successfull
-        publishAlarmsForPersistanceKey(persistanceKey);
+        if (!publishMessage(outboundMessage))
+        {
+            return false;
+        }
+
+        m_persistence.removeAlarms(persistanceKey,
+                                   itemsCount == alarms.size() ? m_publishBatchItemsCount : itemsCount);
+        budget.consume(outboundMessage->getContent().size());
     }
+
+    return false;
 }
 
 void DataService::publishActuatorStatuses()
@@ -282,47 +786,82 @@ void DataService::publishActuatorStatuses()
 }
 void DataService::publishActuatorStatuses(const std::string& deviceKey)
 {
-    const auto& actuatorStatusesKeys = m_persistence.getActuatorStatusesKeys();
-
-    const std::vector<std::string> matchingActuatorStatusesKeys =
-      findMatchingPersistanceKeys(deviceKey, actuatorStatusesKeys);
+    if (!m_actuatorStatusesKeysIndexed)
+    {
+        indexPersistenceKeys(m_actuatorStatusesKeys, m_persistence.getActuatorStatusesKeys());
+        m_actuatorStatusesKeysIndexed = true;
+    }
 
-    for (const std::string& matchingKey : matchingActuatorStatusesKeys)
+    for (const std::string& matchingKey : m_actuatorStatusesKeys.getKeys(deviceKey))
     {
         publishActuatorStatusesForPersistanceKey(matchingKey);
     }
 }
 
-void DataService::publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey)
+void DataService::publishChangedActuatorStatuses()
+{
+    for (auto it = m_changedActuatorStatuses.begin(); it != m_changedActuatorStatuses.end();)
+    {
+        auto& changedKeys = it->second;
+
+        // keys that fail to publish stay marked, and are retried on next publish
+        changedKeys.erase(std::remove_if(changedKeys.begin(), changedKeys.end(),
+                                         [&](const std::string* key) {
+                                             return publishActuatorStatusesForPersistanceKey(*key);
+                                         }),
+                          changedKeys.end());
+
+        it = changedKeys.empty() ? m_changedActuatorStatuses.erase(it) : std::next(it);
+    }
+}
+
+void DataService::markActuatorStatusChanged(const std::string& deviceKey, const std::string& persistanceKey)
+{
+    // persistence keeps only the latest status, so a key is marked once however often it changes
+    auto& changedKeys = m_changedActuatorStatuses[deviceKey];
+    if (std::find(changedKeys.begin(), changedKeys.end(), &persistanceKey) == changedKeys.end())
+    {
+        changedKeys.push_back(&persistanceKey);
+    }
+}
+
+bool DataService::publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey)
 {
     const auto actuatorStatus = m_persistence.getActuatorStatus(persistanceKey);
 
     if (!actuatorStatus)
     {
-        return;
+        finishActuatorStatusTrace(persistanceKey, false);
+        return true;
     }
 
-    auto pair = parsePersistenceKey(persistanceKey);
-    if (pair.first.empty() || pair.second.empty())
+    const std::string* deviceKey = resolveDeviceKey(m_actuatorStatusesKeys, persistanceKey);
+    if (!deviceKey)
     {
         LOG(ERROR) << "Unable to parse persistence key: " << persistanceKey;
         m_persistence.removeActuatorStatus(persistanceKey);
-        return;
+        finishActuatorStatusTrace(persistanceKey, false);
+        return true;
     }
 
-    const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(pair.first, {actuatorStatus});
+    const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(*deviceKey, {actuatorStatus});
 
     if (!outboundMessage)
     {
         LOG(ERROR) << "Unable to create message from actuator status: " << persistanceKey;
         m_persistence.removeActuatorStatus(persistanceKey);
-        return;
+        finishActuatorStatusTrace(persistanceKey, false);
+        return true;
     }
 
-    if (m_connectivityService.publish(outboundMessage))
+    if (publishMessage(outboundMessage))
     {
         m_persistence.removeActuatorStatus(persistanceKey);
+        finishActuatorStatusTrace(persistanceKey, true);
+        return true;
     }
+
+    return false;
 }
 
 void DataService::publishConfiguration()
@@ -338,13 +877,22 @@ void DataService::publishConfiguration(const std::string& deviceKey)
     publishConfigurationForPersistanceKey(deviceKey);
 }
 
-void DataService::publishConfigurationForPersistanceKey(const std::string& persistanceKey)
+void DataService::publishChangedConfigurations()
+{
+    // configurations that fail to publish stay marked, and are retried on next publish
+    for (auto it = m_changedConfigurations.begin(); it != m_changedConfigurations.end();)
+    {
+        it = publishConfigurationForPersistanceKey(*it) ? m_changedConfigurations.erase(it) : std::next(it);
+    }
+}
+
+bool DataService::publishConfigurationForPersistanceKey(const std::string& persistanceKey)
 {
     const auto configuration = m_persistence.getConfiguration(persistanceKey);
 
     if (!configuration)
     {
-        return;
+        return true;
     }
 
     const std::shared_ptr<Message> outboundMessage = m_protocol.makeMessage(persistanceKey, *configuration);
@@ -353,48 +901,278 @@ void DataService::publishConfigurationForPersistanceKey(const std::string& persi
     {
         LOG(ERROR) << "Unable to create message from configuration: " << persistanceKey;
         m_persistence.removeConfiguration(persistanceKey);
-        return;
+        return true;
     }
 
-    if (m_connectivityService.publish(outboundMessage))
+    if (publishMessage(outboundMessage))
     {
         m_persistence.removeConfiguration(persistanceKey);
+        return true;
     }
+
+    return false;
 }
 
-std::string DataService::makePersistenceKey(const std::string& deviceKey, const std::string& reference) const
+std::vector<std::string> DataService::toStrings(const std::vector<ReadingValue>& values)
 {
-    return deviceKey + PERSISTENCE_KEY_DELIMITER + reference;
+    std::vector<std::string> stringifiedValues;
+    stringifiedValues.reserve(values.size());
+
+    for (const auto& value : values)
+    {
+        stringifiedValues.push_back(value.toString());
+    }
+
+    return stringifiedValues;
 }
 
-std::pair<std::string, std::string> DataService::parsePersistenceKey(const std::string& key) const
+void DataService::indexPersistenceKeys(PersistenceKeyIndex& index, const std::vector<std::string>& persistanceKeys)
 {
-    auto pos = key.find(PERSISTENCE_KEY_DELIMITER);
-    if (pos == std::string::npos)
+    for (const auto& key : persistanceKeys)
     {
-        return std::make_pair("", "");
+        index.addKey(key);
     }
+}
 
-    auto deviceKey = key.substr(0, pos);
-    auto reference = key.substr(pos + PERSISTENCE_KEY_DELIMITER.size(), std::string::npos);
+const std::string* DataService::resolveDeviceKey(PersistenceKeyIndex& index, const std::string& persistanceKey)
+{
+    // keys persisted before this instance was created are not yet indexed
+    if (!index.getDeviceKey(persistanceKey) && !index.addKey(persistanceKey))
+    {
+        return nullptr;
+    }
 
-    return std::make_pair(deviceKey, reference);
+    return index.getDeviceKey(persistanceKey);
 }
 
-std::vector<std::string> DataService::findMatchingPersistanceKeys(const std::string& deviceKey,
-                                                                  const std::vector<std::string>& persistanceKeys) const
+bool DataService::publishMessage(const std::shared_ptr<Message>& message)
 {
-    std::vector<std::string> matchingKeys;
+    const bool published = m_connectivityService.publish(message);
 
-    for (const auto& key : persistanceKeys)
+    if (m_metrics)
+    {
+        (published ? m_metrics->messagesPublished : m_metrics->messagesFailed).increment();
+    }
+
+    return published;
+}
+
+bool DataService::exceedsPublishBatchMaxBytes(const std::shared_ptr<Message>& message) const
+{
+    if (m_publishBatchMaxBytes == 0)
+    {
+        return false;
+    }
+
+    return message->getChannel().size() + message->getContent().size() > m_publishBatchMaxBytes;
+}
+
+bool DataService::hasReadingStages(const std::string& reference) const
+{
+    return m_readingAggregator.aggregates(reference) || m_readingFilterStage.filters(reference);
+}
+
+bool DataService::passReadingStages(const std::string& deviceKey, const std::string& reference,
+                                    const ReadingValue* values, std::size_t count, unsigned long long int rtc)
+{
+    // aggregated readings are not filtered, filter would skew the statistics
+    if (m_readingAggregator.add(deviceKey, reference, values, count, rtc))
+    {
+        return false;
+    }
+
+    return m_readingFilterStage.accept(deviceKey, reference, values, count, rtc);
+}
+
+void DataService::persistAggregate(const std::string& deviceKey, const std::string& reference,
+                                   const ReadingAggregation& aggregation, const ReadingAggregator::Window& window)
+{
+    std::vector<std::string> minimums;
+    std::vector<std::string> maximums;
+    std::vector<std::string> means;
+    std::vector<std::string> lasts;
+    for (const auto& statistics : window.components)
+    {
+        minimums.push_back(ReadingValue{statistics.min}.toString());
+        maximums.push_back(ReadingValue{statistics.max}.toString());
+        means.push_back(ReadingValue{statistics.sum / static_cast<double>(window.count)}.toString());
+        lasts.push_back(ReadingValue{statistics.last}.toString());
+    }
+
+    const std::string count = ReadingValue{window.count}.toString();
+
+    if (aggregation.getOutput() == ReadingAggregation::Output::MULTI_VALUE)
+    {
+        std::vector<std::string> values;
+        values.reserve(4 * window.components.size() + 1);
+        values.insert(values.end(), minimums.begin(), minimums.end());
+        values.insert(values.end(), maximums.begin(), maximums.end());
+        values.insert(values.end(), means.begin(), means.end());
+        values.push_back(count);
+        values.insert(values.end(), lasts.begin(), lasts.end());
+
+        const std::string& key = m_sensorReadingsKeys.getKey(deviceKey, reference);
+        persistSensorReading(key, makeSensorReading(key, std::move(values), reference, window.end));
+        return;
+    }
+
+    const auto persistStatistic = [&](const std::string& suffix, const std::vector<std::string>& values) {
+        const std::string statisticReference = reference + suffix;
+        const std::string& key = m_sensorReadingsKeys.getKey(deviceKey, statisticReference);
+
+        auto sensorReading = values.size() == 1 ?
+                               makeSensorReading(key, values.front(), statisticReference, window.end) :
+                               makeSensorReading(key, values, statisticReference, window.end);
+
+        persistSensorReading(key, sensorReading);
+    };
+
+    persistStatistic("_MIN", minimums);
+    persistStatistic("_MAX", maximums);
+    persistStatistic("_MEAN", means);
+    persistStatistic("_COUNT", {count});
+    persistStatistic("_LAST", lasts);
+}
+
+std::shared_ptr<SensorReading> DataService::makeSensorReading(const std::string& persistanceKey, std::string value,
+                                                              const std::string& reference, unsigned long long int rtc)
+{
+    return std::allocate_shared<SensorReading>(SlabAllocator<SensorReading>{readingArena(persistanceKey)},
+                                               std::move(value), reference, rtc);
+}
+
+std::shared_ptr<SensorReading> DataService::makeSensorReading(const std::string& persistanceKey,
+                                                              std::vector<std::string> values,
+                                                              const std::string& reference, unsigned long long int rtc)
+{
+    return std::allocate_shared<SensorReading>(SlabAllocator<SensorReading>{readingArena(persistanceKey)},
+                                               std::move(values), reference, rtc);
+}
+
+SlabArena& DataService::readingArena(const std::string& persistanceKey)
+{
+    // persistence keys are interned, so their addresses identify them
+    auto it = m_readingArenas.find(&persistanceKey);
+    if (it == m_readingArenas.end())
+    {
+        it = m_readingArenas
+               .emplace(std::piecewise_construct, std::forward_as_tuple(&persistanceKey), std::forward_as_tuple())
+               .first;
+    }
+
+    return it->second;
+}
+
+void DataService::persistSensorReading(const std::string& persistanceKey, std::shared_ptr<SensorReading> sensorReading)
+{
+    if (!m_persistence.putSensorReading(persistanceKey, sensorReading))
+    {
+        return;
+    }
+
+    ++m_bufferedSensorReadings;
+
+    if (!m_metrics)
+    {
+        return;
+    }
+
+    m_metrics->readingsPersisted.increment();
+
+    auto it = m_persistedReadings.find(persistanceKey);
+    if (it == m_persistedReadings.end())
     {
-        auto pair = parsePersistenceKey(key);
-        if (pair.first == deviceKey)
+        const std::string* deviceKey = resolveDeviceKey(m_sensorReadingsKeys, persistanceKey);
+        if (!deviceKey)
         {
-            matchingKeys.push_back(key);
+            return;
         }
+
+        Gauge& deviceBuffered = m_metrics->registry.gauge(bufferedReadingsGaugeName(*deviceKey));
+        it = m_persistedReadings.emplace(persistanceKey, PersistedReadings{&deviceBuffered, 0, {}}).first;
+    }
+
+    // persistence may drop readings on its own, so times are kept only for the newest ones
+    auto& persistedAt = it->second.persistedAt;
+    if (persistedAt.size() == TIMED_READINGS_PER_KEY)
+    {
+        persistedAt.pop_front();
+        ++it->second.untimed;
+    }
+
+    persistedAt.push_back(std::chrono::steady_clock::now());
+    it->second.deviceBuffered->add(1);
+}
+
+void DataService::countRemovedSensorReadings(const std::string& persistanceKey, std::size_t count, bool published)
+{
+    auto buffered = m_bufferedSensorReadings.load();
+    while (!m_bufferedSensorReadings.compare_exchange_weak(buffered, buffered > count ? buffered - count : 0))
+    {
+    }
+
+    if (!m_metrics)
+    {
+        return;
+    }
+
+    (published ? m_metrics->readingsPublished : m_metrics->readingsDiscarded).increment(count);
+
+    const auto it = m_persistedReadings.find(persistanceKey);
+    if (it == m_persistedReadings.end())
+    {
+        return;
+    }
+
+    // readings recovered from persistence, or dropped by it on its own, were not counted
+    auto& persistedAt = it->second.persistedAt;
+    const auto removed = std::min(count, it->second.untimed + persistedAt.size());
+
+    const auto removedUntimed = std::min(removed, it->second.untimed);
+    it->second.untimed -= removedUntimed;
+
+    for (std::size_t i = removedUntimed; i < removed; ++i)
+    {
+        if (published)
+        {
+            m_metrics->readingsPublishLatency.recordSince(persistedAt.front());
+        }
+        persistedAt.pop_front();
+    }
+
+    it->second.deviceBuffered->add(-static_cast<std::int64_t>(removed));
+}
+
+void DataService::resetPersistedReadings()
+{
+    for (auto& kvp : m_persistedReadings)
+    {
+        kvp.second.deviceBuffered->add(
+          -static_cast<std::int64_t>(kvp.second.untimed + kvp.second.persistedAt.size()));
+        kvp.second.untimed = 0;
+        kvp.second.persistedAt.clear();
+    }
+}
+
+void DataService::finishActuatorStatusTrace(const std::string& persistanceKey, bool published)
+{
+    if (m_actuatorStatusTraces.empty())
+    {
+        return;
+    }
+
+    const auto it = m_actuatorStatusTraces.find(persistanceKey);
+    if (it == m_actuatorStatusTraces.end())
+    {
+        return;
+    }
+
+    if (published)
+    {
+        ActuationTracer::spanEnd(it->second.trace, TraceHop::PUBLISH, it->second.persistedAt);
     }
 
-    return matchingKeys;
+    m_tracer->finish(it->second.trace);
+    m_actuatorStatusTraces.erase(it);
 }
 }    // namespace wolkabout
@@ -20,11 +20,30 @@
 #include "core/InboundMessageHandler.h"
 #include "core/model/ActuatorStatus.h"
 #include "core/model/ConfigurationItem.h"
+#include "model/ActuationTrace.h"
+#include "model/PersistenceKeyIndex.h"
+#include "model/PublishBudget.h"
+#include "model/ReadingAggregation.h"
+#include "model/ReadingFilter.h"
+#include "model/ReadingValue.h"
+#include "model/SensorReadingBatch.h"
+#include "protocol/SensorReadingsEnvelopeProtocol.h"
+#include "service/ReadingAggregator.h"
+#include "service/ReadingFilterStage.h"
+#include "utilities/ActuationTracer.h"
+#include "utilities/MetricsRegistry.h"
+#include "utilities/SlabArena.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace wolkabout
@@ -32,8 +51,11 @@ namespace wolkabout
 class DataProtocol;
 class Persistence;
 class ConnectivityService;
+class SensorReading;
 
-typedef std::function<void(const std::string&, const std::string&, const std::string&)> ActuatorSetHandler;
+typedef std::function<void(const std::string&, const std::string&, const std::string&,
+                           std::shared_ptr<ActuationTrace>)>
+  ActuatorSetHandler;
 typedef std::function<void(const std::string&, const std::string&)> ActuatorGetHandler;
 
 typedef std::function<void(const std::string&, const std::vector<ConfigurationItem>&)> ConfigurationSetHandler;
@@ -42,10 +64,16 @@ typedef std::function<void(const std::string&)> ConfigurationGetHandler;
 class DataService : public MessageListener
 {
 public:
+    static const constexpr unsigned int PUBLISH_BATCH_ITEMS_COUNT = 50;
+
+    // persist times kept per persistence key to measure publish latency, older buffered readings are not timed
+    static const constexpr std::size_t TIMED_READINGS_PER_KEY = 256;
+
     DataService(DataProtocol& protocol, Persistence& persistence, ConnectivityService& connectivityService,
                 const ActuatorSetHandler& actuatorSetHandler, const ActuatorGetHandler& actuatorGetHandler,
                 const ConfigurationSetHandler& configurationSetHandler,
-                const ConfigurationGetHandler& configurationGetHandler);
+                const ConfigurationGetHandler& configurationGetHandler,
+                unsigned int publishBatchItemsCount = PUBLISH_BATCH_ITEMS_COUNT, std::size_t publishBatchMaxBytes = 0);
 
     void messageReceived(std::shared_ptr<Message> message) override;
     const Protocol& getProtocol() override;
@@ -56,35 +84,217 @@ public:
     void addSensorReading(const std::string& deviceKey, const std::string& reference,
                           const std::vector<std::string>& values, unsigned long long int rtc);
 
+    void addSensorReading(const std::string& deviceKey, const std::string& reference, const ReadingValue& value,
+                          unsigned long long int rtc);
+
+    void addSensorReading(const std::string& deviceKey, const std::string& reference,
+                          const std::vector<ReadingValue>& values, unsigned long long int rtc);
+
+    void addSensorReadings(const std::string& deviceKey, const std::vector<SensorReadingBatch::Reading>& readings,
+                           unsigned long long int defaultRtc);
+
+    /**
+     * @brief Sets filter applied to readings of sensors with given reference before they are persisted
+     */
+    void setReadingFilter(const std::string& reference, const ReadingFilter& filter);
+
+    /**
+     * @brief Sets aggregation of readings of sensors with given reference<br>
+     *        Numeric readings are persisted only as aggregates, when their windows close
+     * @throws std::logic_error if aggregation window is not a multiple of its hop
+     */
+    void setReadingAggregation(const std::string& reference, const ReadingAggregation& aggregation);
+
+    /**
+     * @brief Persists aggregates of windows of sensors that stopped sending readings<br>
+     *        Windows are closed by reading time, see wolkabout::ReadingAggregator::closeIdleWindows
+     * @param now Current local time in milliseconds
+     */
+    void closeAggregationWindows(unsigned long long int now);
+
+    /**
+     * @brief Forgets readings of device last reported through reading filters, and discards its open windows<br>
+     *        Stops counting buffered readings of device, after which its gauge can be removed from the registry
+     */
+    void removeReadingsState(const std::string& deviceKey);
+
+    /**
+     * @brief Discards the oldest persisted reading of the sensor, if there is one
+     */
+    void dropOldestSensorReading(const std::string& deviceKey, const std::string& reference);
+
+    /**
+     * @brief Enables metrics of persisted and published readings, and of published messages<br>
+     *        Latency of a reading is measured from the moment it is persisted until its publish is acknowledged,
+     *        for at most TIMED_READINGS_PER_KEY newest buffered readings of each sensor
+     */
+    void setMetrics(MetricsRegistry& metrics);
+
+    /**
+     * @brief Name of the gauge counting buffered readings of device
+     */
+    static std::string bufferedReadingsGaugeName(const std::string& deviceKey);
+
+    /**
+     * @brief Enables tracing of actuations<br>
+     *        Traces start when actuator set message is received, and are passed to actuator set handler.
+     *        They finish when actuator status they were added with is published, or superseded by a later one
+     */
+    void setTracer(ActuationTracer& tracer);
+
+    /**
+     * @brief Publishes persisted sensor readings of many sensors in a single message, instead of a message per
+     *        sensor<br>
+     *        Envelope is bounded by the same item count and size as per sensor messages
+     * @param protocol Protocol making envelopes, must outlive this service
+     * @param acrossDevices Whether readings of different devices are packed into the same envelope
+     */
+    void setSensorReadingsEnvelopes(const SensorReadingsEnvelopeProtocol& protocol, bool acrossDevices);
+
+    /**
+     * @brief Number of sensor readings persisted by this service and not yet published or discarded<br>
+     *        Safe to call from any thread
+     */
+    std::size_t getBufferedSensorReadingsCount() const;
+
     void addAlarm(const std::string& deviceKey, const std::string& reference, bool active, unsigned long long int rtc);
 
     void addActuatorStatus(const std::string& deviceKey, const std::string& reference, const std::string& value,
-                           ActuatorStatus::State state);
+                           ActuatorStatus::State state, std::shared_ptr<ActuationTrace> trace = nullptr);
 
     void addConfiguration(const std::string& deviceKey, const std::vector<ConfigurationItem>& configuration);
 
     void publishSensorReadings();
     void publishSensorReadings(const std::string& deviceKey);
 
+    /**
+     * @brief Publishes persisted sensor readings until budget is exhausted
+     * @param budget Budget shared with other publish calls of the same pass
+     * @return true if budget was exhausted before all persisted readings were published
+     */
+    bool publishSensorReadings(PublishBudget& budget);
+
+    /**
+     * @brief Publishes persisted readings of sensors that are not part of the backlog, until budget is exhausted
+     * @param budget Budget shared with other publish calls of the same pass
+     * @return true if budget was exhausted before all such readings were published
+     */
+    bool publishCurrentSensorReadings(PublishBudget& budget);
+
+    /**
+     * @brief Publishes persisted readings of sensors that are part of the backlog, until budget is exhausted<br>
+     *        Sensor leaves the backlog once all of its persisted readings are published
+     * @param budget Budget shared with other publish calls of the same pass
+     * @return true if budget was exhausted before all such readings were published
+     */
+    bool publishSensorReadingsBacklog(PublishBudget& budget);
+
+    /**
+     * @brief Marks sensors which currently have persisted readings as backlog<br>
+     *        Called when connection is established, so that readings persisted while it was down
+     *        are published after readings added since
+     */
+    void markSensorReadingsBacklog();
+
+    /**
+     * @brief Marks currently persisted actuator statuses and configurations as changed<br>
+     *        Called when connection is established, so that ones persisted while it was down,
+     *        or before this instance was created, are published with changed ones
+     */
+    void markPersistedChanged();
+
     void publishAlarms();
     void publishAlarms(const std::string& deviceKey);
 
+    /**
+     * @brief Publishes persisted alarms until budget is exhausted
+     * @param budget Budget shared with other publish calls of the same pass
+     * @return true if budget was exhausted before all persisted alarms were published
+     */
+    bool publishAlarms(PublishBudget& budget);
+
     void publishActuatorStatuses();
     void publishActuatorStatuses(const std::string& deviceKey);
 
+    /**
+     * @brief Publishes only actuator statuses added since last call, device by device<br>
+     *        Each actuator is published once, with its latest status
+     */
+    void publishChangedActuatorStatuses();
+
     void publishConfiguration();
     void publishConfiguration(const std::string& deviceKey);
 
+    /**
+     * @brief Publishes only configurations added since last call
+     */
+    void publishChangedConfigurations();
+
 private:
-    std::string makePersistenceKey(const std::string& deviceKey, const std::string& reference) const;
-    std::pair<std::string, std::string> parsePersistenceKey(const std::string& key) const;
-    std::vector<std::string> findMatchingPersistanceKeys(const std::string& deviceKey,
-                                                         const std::vector<std::string>& persistanceKeys) const;
+    struct Metrics
+    {
+        explicit Metrics(MetricsRegistry& metricsRegistry);
+
+        MetricsRegistry& registry;
+
+        Counter& readingsPersisted;
+        Counter& readingsPublished;
+        Counter& readingsDiscarded;
+        Counter& messagesPublished;
+        Counter& messagesFailed;
+        LatencyHistogram& readingsPublishLatency;
+    };
+
+    // readings of a persistence key counted in per device gauge, oldest ones untimed, followed by times the newest
+    // ones were persisted
+    struct PersistedReadings
+    {
+        Gauge* deviceBuffered;
+        std::size_t untimed;
+        std::deque<std::chrono::steady_clock::time_point> persistedAt;
+    };
+
+    // trace of actuation that resulted in persisted actuator status
+    struct ActuatorStatusTrace
+    {
+        std::shared_ptr<ActuationTrace> trace;
+        std::chrono::steady_clock::time_point persistedAt;
+    };
+
+    static std::vector<std::string> toStrings(const std::vector<ReadingValue>& values);
+
+    static void indexPersistenceKeys(PersistenceKeyIndex& index, const std::vector<std::string>& persistanceKeys);
+    static const std::string* resolveDeviceKey(PersistenceKeyIndex& index, const std::string& persistanceKey);
 
-    void publishSensorReadingsForPersistanceKey(const std::string& persistanceKey);
-    void publishAlarmsForPersistanceKey(const std::string& persistanceKey);
-    void publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey);
-    void publishConfigurationForPersistanceKey(const std::string& persistanceKey);
+    bool publishSensorReadings(PublishBudget& budget, bool backlog);
+    bool publishSensorReadingsForPersistanceKey(const std::string& persistanceKey, PublishBudget& budget);
+    bool publishSensorReadingsEnvelopes(const std::vector<std::string>& persistanceKeys, PublishBudget& budget);
+    bool publishAlarmsForPersistanceKey(const std::string& persistanceKey, PublishBudget& budget);
+    bool publishActuatorStatusesForPersistanceKey(const std::string& persistanceKey);
+    bool publishConfigurationForPersistanceKey(const std::string& persistanceKey);
+
+    void markActuatorStatusChanged(const std::string& deviceKey, const std::string& persistanceKey);
+
+    bool publishMessage(const std::shared_ptr<Message>& message);
+    bool exceedsPublishBatchMaxBytes(const std::shared_ptr<Message>& message) const;
+
+    bool hasReadingStages(const std::string& reference) const;
+    bool passReadingStages(const std::string& deviceKey, const std::string& reference, const ReadingValue* values,
+                           std::size_t count, unsigned long long int rtc);
+
+    void persistAggregate(const std::string& deviceKey, const std::string& reference,
+                          const ReadingAggregation& aggregation, const ReadingAggregator::Window& window);
+    std::shared_ptr<SensorReading> makeSensorReading(const std::string& persistanceKey, std::string value,
+                                                     const std::string& reference, unsigned long long int rtc);
+    std::shared_ptr<SensorReading> makeSensorReading(const std::string& persistanceKey,
+                                                     std::vector<std::string> values, const std::string& reference,
+                                                     unsigned long long int rtc);
+    SlabArena& readingArena(const std::string& persistanceKey);
+
+    void persistSensorReading(const std::string& persistanceKey, std::shared_ptr<SensorReading> sensorReading);
+    void countRemovedSensorReadings(const std::string& persistanceKey, std::size_t count, bool published);
+    void resetPersistedReadings();
+    void finishActuatorStatusTrace(const std::string& persistanceKey, bool published);
 
     DataProtocol& m_protocol;
     Persistence& m_persistence;
@@ -96,8 +306,45 @@ private:
     ConfigurationSetHandler m_configurationSetHandler;
     ConfigurationGetHandler m_configurationGetHandler;
 
+    const unsigned int m_publishBatchItemsCount;
+    const std::size_t m_publishBatchMaxBytes;
+
+    const SensorReadingsEnvelopeProtocol* m_envelopeProtocol;
+    bool m_envelopesAcrossDevices;
+
+    ReadingAggregator m_readingAggregator;
+    ReadingFilterStage m_readingFilterStage;
+
+    PersistenceKeyIndex m_sensorReadingsKeys;
+    PersistenceKeyIndex m_alarmsKeys;
+    PersistenceKeyIndex m_actuatorStatusesKeys;
+
+    // keys persisted before this instance was created are indexed on first per-device publish
+    bool m_sensorReadingsKeysIndexed;
+    bool m_alarmsKeysIndexed;
+    bool m_actuatorStatusesKeysIndexed;
+
+    std::atomic<std::size_t> m_bufferedSensorReadings;
+
+    // readings of each persistence key are allocated next to each other, and freed by slab once published
+    std::unordered_map<const std::string*, SlabArena> m_readingArenas;
+
+    // persistence keys of actuator statuses added since they were last published, per device
+    std::map<std::string, std::vector<const std::string*>> m_changedActuatorStatuses;
+
+    // device keys of configurations added since they were last published
+    std::set<std::string> m_changedConfigurations;
+
+    // persistence keys of readings which were persisted when connection was last established
+    std::set<std::string> m_sensorReadingsBacklogKeys;
+
+    std::unique_ptr<Metrics> m_metrics;
+    std::unordered_map<std::string, PersistedReadings> m_persistedReadings;
+
+    ActuationTracer* m_tracer;
+    std::unordered_map<std::string, ActuatorStatusTrace> m_actuatorStatusTraces;
+
     static const std::string PERSISTENCE_KEY_DELIMITER;
-    static const constexpr unsigned int PUBLISH_BATCH_ITEMS_COUNT = 50;
 };
 }    // namespace wolkabout
 
@@ -29,6 +29,8 @@
 #include "core/utilities/Logger.h"
 #include "core/utilities/StringUtils.h"
 
+#include <utility>
+
 namespace wolkabout
 {
 FirmwareUpdateService::FirmwareUpdateService(JsonDFUProtocol& protocol,
@@ -39,6 +41,11 @@ FirmwareUpdateService::FirmwareUpdateService(JsonDFUProtocol& protocol,
 , m_firmwareInstaller{firmwareInstaller}
 , m_firmwareVersionProvider{firmwareVersionProvider}
 , m_connectivityService{connectivityService}
+, m_installsStarted{nullptr}
+, m_installsSucceeded{nullptr}
+, m_installsFailed{nullptr}
+, m_installsAborted{nullptr}
+, m_installsInProgress{nullptr}
 {
 }
 
@@ -47,8 +54,8 @@ void FirmwareUpdateService::messageReceived(std::shared_ptr<Message> message)
     auto installCommand = m_protocol.makeFirmwareUpdateInstall(*message);
     if (installCommand)
     {
-        auto installDto = *installCommand;
-        addToCommandBuffer([=] { handleFirmwareUpdateCommand(installDto); });
+        std::shared_ptr<FirmwareUpdateInstall> installDto{std::move(installCommand)};
+        addToCommandBuffer([=] { handleFirmwareUpdateCommand(*installDto); });
 
         return;
     }
@@ -56,8 +63,8 @@ void FirmwareUpdateService::messageReceived(std::shared_ptr<Message> message)
     auto abortCommand = m_protocol.makeFirmwareUpdateAbort(*message);
     if (abortCommand)
     {
-        auto abortDto = *abortCommand;
-        addToCommandBuffer([=] { handleFirmwareUpdateCommand(abortDto); });
+        std::shared_ptr<FirmwareUpdateAbort> abortDto{std::move(abortCommand)};
+        addToCommandBuffer([=] { handleFirmwareUpdateCommand(*abortDto); });
 
         return;
     }
@@ -99,6 +106,15 @@ void FirmwareUpdateService::publishFirmwareVersion(const std::string& deviceKey)
     });
 }
 
+void FirmwareUpdateService::setMetrics(MetricsRegistry& metrics)
+{
+    m_installsStarted = &metrics.counter("firmware.installs.started");
+    m_installsSucceeded = &metrics.counter("firmware.installs.succeeded");
+    m_installsFailed = &metrics.counter("firmware.installs.failed");
+    m_installsAborted = &metrics.counter("firmware.installs.aborted");
+    m_installsInProgress = &metrics.gauge("firmware.installs.in_progress");
+}
+
 void FirmwareUpdateService::handleFirmwareUpdateCommand(const FirmwareUpdateInstall& command)
 {
     if (command.getDeviceKeys().size() != 1 || command.getDeviceKeys().at(0).empty())
@@ -147,6 +163,12 @@ void FirmwareUpdateService::install(const std::string& deviceKey, const std::str
 {
     sendStatus(FirmwareUpdateStatus{{deviceKey}, FirmwareUpdateStatus::Status::INSTALLATION});
 
+    if (m_installsStarted)
+    {
+        m_installsStarted->increment();
+        m_installsInProgress->add(1);
+    }
+
     m_firmwareInstaller->install(
       deviceKey, firmwareFilePath, [=](const std::string& key) { installSucceeded(key); },
       [=](const std::string& key) { installFailed(key); });
@@ -154,12 +176,24 @@ void FirmwareUpdateService::install(const std::string& deviceKey, const std::str
 
 void FirmwareUpdateService::installSucceeded(const std::string& deviceKey)
 {
+    if (m_installsSucceeded)
+    {
+        m_installsSucceeded->increment();
+        m_installsInProgress->add(-1);
+    }
+
     sendStatus(FirmwareUpdateStatus{{deviceKey}, FirmwareUpdateStatus::Status::COMPLETED});
     publishFirmwareVersion(deviceKey);
 }
 
 void FirmwareUpdateService::installFailed(const std::string& deviceKey)
 {
+    if (m_installsFailed)
+    {
+        m_installsFailed->increment();
+        m_installsInProgress->add(-1);
+    }
+
     sendStatus(FirmwareUpdateStatus{{deviceKey}, FirmwareUpdateStatus::Error::INSTALLATION_FAILED});
 }
 
@@ -169,6 +203,13 @@ void FirmwareUpdateService::abort(const std::string& deviceKey)
     if (m_firmwareInstaller->abort(deviceKey))
     {
         LOG(INFO) << "Firmware installation aborted for device: " << deviceKey;
+
+        if (m_installsAborted)
+        {
+            m_installsAborted->increment();
+            m_installsInProgress->add(-1);
+        }
+
         sendStatus(FirmwareUpdateStatus{{deviceKey}, FirmwareUpdateStatus::Status::ABORTED});
     }
     else
@@ -194,8 +235,8 @@ void FirmwareUpdateService::sendStatus(const FirmwareUpdateStatus& response)
     }
 }
 
-void FirmwareUpdateService::addToCommandBuffer(std::function<void()> command)
+void FirmwareUpdateService::addToCommandBuffer(Command command)
 {
-    m_commandBuffer.pushCommand(std::make_shared<std::function<void()>>(command));
+    m_commandExecutor.push(std::move(command));
 }
 }    // namespace wolkabout
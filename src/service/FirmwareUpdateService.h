@@ -17,6 +17,8 @@
 #define FIRMWAREUPDATESERVICE_H
 
 #include "InboundGatewayMessageHandler.h"
+#include "utilities/CommandExecutor.h"
+#include "utilities/MetricsRegistry.h"
 
 #include <map>
 #include <memory>
@@ -45,6 +47,12 @@ public:
 
     void publishFirmwareVersion(const std::string& deviceKey);
 
+    /**
+     * @brief Enables metrics of firmware installations<br>
+     *        Must be called before firmware update commands are received
+     */
+    void setMetrics(MetricsRegistry& metrics);
+
 private:
     void handleFirmwareUpdateCommand(const FirmwareUpdateInstall& command);
     void handleFirmwareUpdateCommand(const FirmwareUpdateAbort& command);
@@ -59,7 +67,7 @@ private:
 
     void sendStatus(const FirmwareUpdateStatus& status);
 
-    void addToCommandBuffer(std::function<void()> command);
+    void addToCommandBuffer(Command command);
 
     JsonDFUProtocol& m_protocol;
 
@@ -68,7 +76,13 @@ private:
 
     ConnectivityService& m_connectivityService;
 
-    CommandBuffer m_commandBuffer;
+    Counter* m_installsStarted;
+    Counter* m_installsSucceeded;
+    Counter* m_installsFailed;
+    Counter* m_installsAborted;
+    Gauge* m_installsInProgress;
+
+    CommandExecutor m_commandExecutor;
 };
 }    // namespace wolkabout
 
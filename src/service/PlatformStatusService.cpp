@@ -47,13 +47,11 @@ void PlatformStatusService::messageReceived(std::shared_ptr<Message> message)
     // Now, do an external call with the received data.
     if (m_listener)
     {
-        m_commandBuffer.pushCommand(std::make_shared<std::function<void()>>(
-          [this, parsed]() { m_listener->platformStatus(parsed->getStatus()); }));
+        m_commandExecutor.push([this, parsed]() { m_listener->platformStatus(parsed->getStatus()); });
     }
     else if (m_lambda)
     {
-        m_commandBuffer.pushCommand(
-          std::make_shared<std::function<void()>>([this, parsed]() { m_lambda(parsed->getStatus()); }));
+        m_commandExecutor.push([this, parsed]() { m_lambda(parsed->getStatus()); });
     }
 }
 
@@ -19,8 +19,8 @@
 
 #include "api/PlatformStatusListener.h"
 #include "core/InboundMessageHandler.h"
-#include "core/utilities/CommandBuffer.h"
 #include "protocol/PlatformStatusProtocol.h"
+#include "utilities/CommandExecutor.h"
 
 #include <functional>
 
@@ -76,8 +76,8 @@ private:
     std::shared_ptr<PlatformStatusListener> m_listener;
     PlatformStatusCallback m_lambda;
 
-    // Here we have the command buffer that will execute external calls.
-    CommandBuffer m_commandBuffer;
+    // Here we have the command executor that will execute external calls.
+    CommandExecutor m_commandExecutor;
 };
 }    // namespace wolkabout
 
@@ -0,0 +1,208 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "service/ReadingAggregator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace wolkabout
+{
+ReadingAggregator::ReadingAggregator(WindowClosedHandler windowClosedHandler)
+: m_windowClosedHandler{std::move(windowClosedHandler)}
+{
+}
+
+void ReadingAggregator::setAggregation(const std::string& reference, const ReadingAggregation& aggregation)
+{
+    if (aggregation.getHop().count() <= 0 || aggregation.getWindow().count() < aggregation.getHop().count() ||
+        aggregation.getWindow().count() % aggregation.getHop().count() != 0)
+    {
+        throw std::logic_error("Aggregation window must be a multiple of hop.");
+    }
+
+    m_aggregations.erase(reference);
+    m_aggregations.emplace(reference, aggregation);
+
+    for (auto& kvp : m_windows)
+    {
+        kvp.second.erase(reference);
+    }
+}
+
+bool ReadingAggregator::aggregates(const std::string& reference) const
+{
+    return !m_aggregations.empty() && m_aggregations.find(reference) != m_aggregations.end();
+}
+
+bool ReadingAggregator::add(const std::string& deviceKey, const std::string& reference, const ReadingValue* values,
+                            std::size_t count, unsigned long long int rtc)
+{
+    auto aggregationIt = m_aggregations.find(reference);
+    if (aggregationIt == m_aggregations.end() || count == 0)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (!values[i].isNumeric())
+        {
+            return false;
+        }
+    }
+
+    const ReadingAggregation& aggregation = aggregationIt->second;
+    const auto hop = static_cast<unsigned long long int>(aggregation.getHop().count());
+    const auto length = static_cast<unsigned long long int>(aggregation.getWindow().count());
+    const auto windowsPerReading = length / hop;
+
+    auto& sensorWindows = m_windows[deviceKey][reference];
+    auto& windows = sensorWindows.windows;
+    if (windows.empty())
+    {
+        windows.resize(windowsPerReading, Window{0, 0, 0, {}});
+    }
+
+    sensorWindows.latestRtc = std::max(sensorWindows.latestRtc, rtc);
+    sensorWindows.idleSince = 0;
+
+    closeWindows(deviceKey, reference, aggregation, sensorWindows, rtc);
+
+    const auto latestStart = rtc / hop * hop;
+    for (unsigned long long int i = 0; i < windowsPerReading && i * hop <= latestStart; ++i)
+    {
+        const auto start = latestStart - i * hop;
+        if (start + length <= sensorWindows.closedUpTo)
+        {
+            // this and older windows were already closed, reopening them would report them twice
+            break;
+        }
+
+        Window& window = windows[(start / hop) % windowsPerReading];
+        if (window.count != 0 && window.start != start)
+        {
+            // slot is taken by a newer window, this one was already closed
+            continue;
+        }
+
+        if (window.count == 0)
+        {
+            window.start = start;
+            window.end = start + length;
+            window.components.clear();
+            for (std::size_t j = 0; j < count; ++j)
+            {
+                const double value = values[j].toDouble();
+                window.components.push_back(Statistics{value, value, 0, value});
+            }
+        }
+        else if (window.components.size() != count)
+        {
+            continue;
+        }
+
+        ++window.count;
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            const double value = values[j].toDouble();
+
+            Statistics& statistics = window.components[j];
+            statistics.min = std::min(statistics.min, value);
+            statistics.max = std::max(statistics.max, value);
+            statistics.sum += value;
+            statistics.last = value;
+        }
+    }
+
+    return true;
+}
+
+void ReadingAggregator::closeWindows(unsigned long long int rtc)
+{
+    for (auto& deviceWindows : m_windows)
+    {
+        for (auto& referenceWindows : deviceWindows.second)
+        {
+            auto aggregationIt = m_aggregations.find(referenceWindows.first);
+            if (aggregationIt != m_aggregations.end())
+            {
+                closeWindows(deviceWindows.first, referenceWindows.first, aggregationIt->second,
+                             referenceWindows.second, rtc);
+            }
+        }
+    }
+}
+
+void ReadingAggregator::closeIdleWindows(unsigned long long int now)
+{
+    for (auto& deviceWindows : m_windows)
+    {
+        for (auto& referenceWindows : deviceWindows.second)
+        {
+            auto aggregationIt = m_aggregations.find(referenceWindows.first);
+            if (aggregationIt == m_aggregations.end())
+            {
+                continue;
+            }
+
+            SensorWindows& sensorWindows = referenceWindows.second;
+            if (sensorWindows.idleSince == 0 || now < sensorWindows.idleSince)
+            {
+                sensorWindows.idleSince = now;
+                continue;
+            }
+
+            closeWindows(deviceWindows.first, referenceWindows.first, aggregationIt->second, sensorWindows,
+                         sensorWindows.latestRtc + (now - sensorWindows.idleSince));
+        }
+    }
+}
+
+void ReadingAggregator::removeDevice(const std::string& deviceKey)
+{
+    m_windows.erase(deviceKey);
+}
+
+void ReadingAggregator::closeWindows(const std::string& deviceKey, const std::string& reference,
+                                     const ReadingAggregation& aggregation, SensorWindows& sensorWindows,
+                                     unsigned long long int rtc)
+{
+    sensorWindows.closedUpTo = std::max(sensorWindows.closedUpTo, rtc);
+
+    // there are only window / hop slots, close ended windows oldest first
+    while (true)
+    {
+        Window* oldest = nullptr;
+        for (auto& window : sensorWindows.windows)
+        {
+            if (window.count != 0 && window.end <= rtc && (!oldest || window.start < oldest->start))
+            {
+                oldest = &window;
+            }
+        }
+
+        if (!oldest)
+        {
+            return;
+        }
+
+        m_windowClosedHandler(deviceKey, reference, aggregation, *oldest);
+        oldest->count = 0;
+    }
+}
+}    // namespace wolkabout
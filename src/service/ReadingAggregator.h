@@ -0,0 +1,135 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef READINGAGGREGATOR_H
+#define READINGAGGREGATOR_H
+
+#include "model/ReadingAggregation.h"
+#include "model/ReadingValue.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Aggregates numeric readings of each device and sensor reference in windows
+ *        described by wolkabout::ReadingAggregation of the reference.<br>
+ *        Only running statistics of open windows are kept, never the readings themselves.<br>
+ *        Not thread safe.
+ */
+class ReadingAggregator
+{
+public:
+    struct Statistics
+    {
+        double min;
+        double max;
+        double sum;
+        double last;
+    };
+
+    struct Window
+    {
+        unsigned long long int start;
+        unsigned long long int end;
+        unsigned long long int count;
+
+        // one per value of multi-value reading
+        std::vector<Statistics> components;
+    };
+
+    typedef std::function<void(const std::string& deviceKey, const std::string& reference,
+                               const ReadingAggregation& aggregation, const Window& window)>
+      WindowClosedHandler;
+
+    explicit ReadingAggregator(WindowClosedHandler windowClosedHandler);
+
+    /**
+     * @brief Sets aggregation of all sensors with given reference, replacing previous one
+     * @throws std::logic_error if hop is 0, or window is not a multiple of hop
+     */
+    void setAggregation(const std::string& reference, const ReadingAggregation& aggregation);
+
+    /**
+     * @brief Checks if readings of sensors with given reference are aggregated
+     */
+    bool aggregates(const std::string& reference) const;
+
+    /**
+     * @brief Adds reading to open windows, first closing windows that end before reading rtc
+     * @param deviceKey Device key
+     * @param reference Sensor reference
+     * @param values Reading values, single value for single value readings
+     * @param count Number of values
+     * @param rtc Reading rtc in milliseconds
+     * @return false if reading is not aggregated and should be persisted as is, ie. if it is not numeric<br>
+     *         Readings that belong only to already closed windows are discarded
+     */
+    bool add(const std::string& deviceKey, const std::string& reference, const ReadingValue* values,
+             std::size_t count, unsigned long long int rtc);
+
+    /**
+     * @brief Closes windows of all devices that end before given reading time
+     * @param rtc Reading time in milliseconds
+     */
+    void closeWindows(unsigned long long int rtc);
+
+    /**
+     * @brief Closes windows of sensors that stopped sending readings<br>
+     *        Windows are closed by reading time, so reading time of such sensor is advanced
+     *        by local time elapsed since the first call that found it idle.
+     *        This keeps windows of a device whose clock differs from local one open until its readings are in.
+     * @param now Local time in milliseconds, expected to be called periodically, at least once per hop
+     */
+    void closeIdleWindows(unsigned long long int now);
+
+    /**
+     * @brief Discards open windows of device
+     */
+    void removeDevice(const std::string& deviceKey);
+
+private:
+    struct SensorWindows
+    {
+        // window starting at time t is kept at (t / hop) % (window / hop)
+        std::vector<Window> windows;
+
+        // reading time up to which windows are closed, readings of windows ending at or before it are late
+        unsigned long long int closedUpTo;
+
+        // latest reading rtc, and local time since which no reading was added, 0 while readings are added
+        unsigned long long int latestRtc;
+        unsigned long long int idleSince;
+    };
+
+    void closeWindows(const std::string& deviceKey, const std::string& reference,
+                      const ReadingAggregation& aggregation, SensorWindows& sensorWindows,
+                      unsigned long long int rtc);
+
+    WindowClosedHandler m_windowClosedHandler;
+
+    std::unordered_map<std::string, ReadingAggregation> m_aggregations;
+
+    // open windows of each device and reference
+    std::unordered_map<std::string, std::unordered_map<std::string, SensorWindows>> m_windows;
+};
+}    // namespace wolkabout
+
+#endif    // READINGAGGREGATOR_H
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "service/ReadingFilterStage.h"
+
+#include <cmath>
+
+namespace wolkabout
+{
+void ReadingFilterStage::setFilter(const std::string& reference, const ReadingFilter& filter)
+{
+    m_filters[reference] = filter;
+}
+
+bool ReadingFilterStage::filters(const std::string& reference) const
+{
+    return !m_filters.empty() && m_filters.find(reference) != m_filters.end();
+}
+
+bool ReadingFilterStage::accept(const std::string& deviceKey, const std::string& reference,
+                                const ReadingValue* values, std::size_t count, unsigned long long int rtc)
+{
+    auto filterIt = m_filters.find(reference);
+    if (filterIt == m_filters.end())
+    {
+        return true;
+    }
+
+    const ReadingFilter& filter = filterIt->second;
+
+    auto& deviceReadings = m_lastReported[deviceKey];
+    auto lastIt = deviceReadings.find(reference);
+    if (lastIt != deviceReadings.end())
+    {
+        const LastReported& last = lastIt->second;
+
+        // readings older than last reported one, ie. backfilled ones, can not be compared with it,
+        // so they are reported as they are, and do not replace it
+        if (rtc < last.rtc)
+        {
+            return true;
+        }
+
+        const auto elapsed = std::chrono::milliseconds{rtc - last.rtc};
+
+        if (filter.getMinInterval().count() != 0 && elapsed < filter.getMinInterval())
+        {
+            return false;
+        }
+
+        const bool silenceExceeded = filter.getMaxSilence().count() != 0 && elapsed >= filter.getMaxSilence();
+        if (filter.isChangeOnly() && !silenceExceeded && !changed(filter, last.values, values, count))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        lastIt = deviceReadings.emplace(reference, LastReported{{}, 0}).first;
+    }
+
+    lastIt->second.values.assign(values, values + count);
+    lastIt->second.rtc = rtc;
+    return true;
+}
+
+void ReadingFilterStage::removeDevice(const std::string& deviceKey)
+{
+    m_lastReported.erase(deviceKey);
+}
+
+bool ReadingFilterStage::changed(const ReadingFilter& filter, const std::vector<ReadingValue>& lastValues,
+                                 const ReadingValue* values, std::size_t count)
+{
+    if (lastValues.size() != count)
+    {
+        return true;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (changed(filter, lastValues[i], values[i]))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ReadingFilterStage::changed(const ReadingFilter& filter, const ReadingValue& lastValue,
+                                 const ReadingValue& value)
+{
+    if (!lastValue.isNumeric() || !value.isNumeric())
+    {
+        return lastValue.getType() != value.getType() || lastValue.toString() != value.toString();
+    }
+
+    const double last = lastValue.toDouble();
+    const double difference = std::fabs(value.toDouble() - last);
+
+    const double deadband =
+      std::fmax(filter.getAbsoluteDeadband(), std::fabs(last) * filter.getPercentageDeadband() / 100);
+
+    return difference > deadband;
+}
+}    // namespace wolkabout
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef READINGFILTERSTAGE_H
+#define READINGFILTERSTAGE_H
+
+#include "model/ReadingFilter.h"
+#include "model/ReadingValue.h"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Applies wolkabout::ReadingFilter of sensor reference to readings of every device,
+ *        keeping last reported reading of each device and reference.<br>
+ *        Not thread safe.
+ */
+class ReadingFilterStage
+{
+public:
+    /**
+     * @brief Sets filter of all sensors with given reference, replacing previous one
+     */
+    void setFilter(const std::string& reference, const ReadingFilter& filter);
+
+    /**
+     * @brief Checks if readings of sensors with given reference are filtered
+     */
+    bool filters(const std::string& reference) const;
+
+    /**
+     * @brief Checks reading against filter of its reference, and remembers it if it is reported<br>
+     *        Reading older than last reported one is reported without being remembered
+     * @param deviceKey Device key
+     * @param reference Sensor reference
+     * @param values Reading values, single value for single value readings
+     * @param count Number of values
+     * @param rtc Reading rtc in milliseconds
+     * @return true if reading should be reported
+     */
+    bool accept(const std::string& deviceKey, const std::string& reference, const ReadingValue* values,
+                std::size_t count, unsigned long long int rtc);
+
+    /**
+     * @brief Forgets last reported readings of device
+     */
+    void removeDevice(const std::string& deviceKey);
+
+private:
+    struct LastReported
+    {
+        std::vector<ReadingValue> values;
+        unsigned long long int rtc;
+    };
+
+    static bool changed(const ReadingFilter& filter, const std::vector<ReadingValue>& lastValues,
+                        const ReadingValue* values, std::size_t count);
+    static bool changed(const ReadingFilter& filter, const ReadingValue& lastValue, const ReadingValue& value);
+
+    std::unordered_map<std::string, ReadingFilter> m_filters;
+    std::unordered_map<std::string, std::unordered_map<std::string, LastReported>> m_lastReported;
+};
+}    // namespace wolkabout
+
+#endif    // READINGFILTERSTAGE_H
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "service/RegistrationPipeline.h"
+
+#include "core/utilities/Logger.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+RegistrationPipeline::RegistrationPipeline(std::function<void()> subscribe,
+                                           std::function<bool(const std::string&)> publish)
+: m_subscribe{std::move(subscribe)}
+, m_publish{std::move(publish)}
+, m_inFlightLimit{0}
+, m_responseTimeout{0}
+{
+}
+
+void RegistrationPipeline::setLimits(unsigned int inFlight, std::chrono::milliseconds responseTimeout)
+{
+    m_inFlightLimit = inFlight;
+    m_responseTimeout = responseTimeout;
+}
+
+void RegistrationPipeline::add(const std::vector<std::string>& deviceKeys)
+{
+    if (deviceKeys.empty())
+    {
+        return;
+    }
+
+    // subscribe to channels of all added devices at once, before their registration responses arrive
+    m_subscribe();
+
+    m_pending.insert(m_pending.end(), deviceKeys.begin(), deviceKeys.end());
+    publishPending();
+}
+
+void RegistrationPipeline::restart(const std::vector<std::string>& deviceKeys)
+{
+    m_inFlight.clear();
+    m_pending.assign(deviceKeys.begin(), deviceKeys.end());
+    publishPending();
+}
+
+void RegistrationPipeline::responseReceived(const std::string& deviceKey)
+{
+    if (m_inFlight.erase(deviceKey) != 0)
+    {
+        publishPending();
+    }
+}
+
+void RegistrationPipeline::remove(const std::string& deviceKey)
+{
+    if (m_inFlight.erase(deviceKey) != 0)
+    {
+        publishPending();
+    }
+}
+
+void RegistrationPipeline::expire(Clock::time_point now)
+{
+    if (m_inFlightLimit == 0)
+    {
+        return;
+    }
+
+    bool expired = false;
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();)
+    {
+        if (it->second <= now)
+        {
+            LOG(WARN) << "Registration response for device '" << it->first << "' not received, retrying";
+
+            m_pending.push_back(it->first);
+            it = m_inFlight.erase(it);
+            expired = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    if (expired)
+    {
+        publishPending();
+    }
+}
+
+std::size_t RegistrationPipeline::inFlight() const
+{
+    return m_inFlight.size();
+}
+
+std::size_t RegistrationPipeline::pending() const
+{
+    return m_pending.size();
+}
+
+void RegistrationPipeline::publishPending()
+{
+    while (!m_pending.empty() && (m_inFlightLimit == 0 || m_inFlight.size() < m_inFlightLimit))
+    {
+        const std::string deviceKey = m_pending.front();
+        m_pending.pop_front();
+
+        if (m_inFlight.find(deviceKey) != m_inFlight.end())
+        {
+            // already awaiting response
+            continue;
+        }
+
+        if (!m_publish(deviceKey))
+        {
+            // removed
+            continue;
+        }
+
+        m_inFlight.emplace(deviceKey, Clock::now() + m_responseTimeout);
+    }
+}
+}    // namespace wolkabout
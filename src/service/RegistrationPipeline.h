@@ -0,0 +1,99 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef REGISTRATIONPIPELINE_H
+#define REGISTRATIONPIPELINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Publishes device registration requests, keeping at most a limited number of them awaiting response.<br>
+ *        A request that gets no response within response timeout frees its slot, and is published again later.<br>
+ *        Not thread safe.
+ */
+class RegistrationPipeline
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @param subscribe Subscribes to channels of all devices, called once per batch of added devices
+     * @param publish Publishes registration request of device, returns false if device no longer exists
+     */
+    RegistrationPipeline(std::function<void()> subscribe, std::function<bool(const std::string&)> publish);
+
+    /**
+     * @param inFlight Maximum number of requests awaiting response, 0 for no limit
+     * @param responseTimeout Time after which request awaiting response is published again,
+     *                        applies only when number of requests is limited
+     */
+    void setLimits(unsigned int inFlight, std::chrono::milliseconds responseTimeout);
+
+    /**
+     * @brief Registers added devices, subscribing to their channels once, before any request is published
+     */
+    void add(const std::vector<std::string>& deviceKeys);
+
+    /**
+     * @brief Registers all devices from start, forgetting requests awaiting response<br>
+     *        Used on reconnect, since responses to requests sent over previous connection may never arrive
+     */
+    void restart(const std::vector<std::string>& deviceKeys);
+
+    /**
+     * @brief Frees slot of device request, and publishes next pending request
+     */
+    void responseReceived(const std::string& deviceKey);
+
+    /**
+     * @brief Frees slot of removed device, and publishes next pending request
+     */
+    void remove(const std::string& deviceKey);
+
+    /**
+     * @brief Frees slots of requests that got no response by their deadline, and queues them again
+     * @param now Current time
+     */
+    void expire(Clock::time_point now);
+
+    std::size_t inFlight() const;
+    std::size_t pending() const;
+
+private:
+    void publishPending();
+
+    std::function<void()> m_subscribe;
+    std::function<bool(const std::string&)> m_publish;
+
+    unsigned int m_inFlightLimit;
+    std::chrono::milliseconds m_responseTimeout;
+
+    // devices awaiting registration, and response deadlines of devices awaiting registration response
+    std::deque<std::string> m_pending;
+    std::unordered_map<std::string, Clock::time_point> m_inFlight;
+};
+}    // namespace wolkabout
+
+#endif    // REGISTRATIONPIPELINE_H
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/ActuationTracer.h"
+
+#include <cstddef>
+#include <utility>
+
+namespace wolkabout
+{
+ActuationTracer::ActuationTracer(std::shared_ptr<TraceSink> sink, unsigned int sampleEvery)
+: m_sink{std::move(sink)}
+, m_sampleEvery{sampleEvery == 0 ? 1 : sampleEvery}
+, m_actuationsCount{0}
+{
+}
+
+std::shared_ptr<ActuationTrace> ActuationTracer::begin(const std::string& deviceKey, const std::string& reference,
+                                                       const std::string& value)
+{
+    const auto id = m_actuationsCount.fetch_add(1, std::memory_order_relaxed);
+    if (id % m_sampleEvery != 0)
+    {
+        return nullptr;
+    }
+
+    auto trace = std::make_shared<ActuationTrace>();
+    trace->id = id;
+    trace->deviceKey = deviceKey;
+    trace->reference = reference;
+    trace->value = value;
+    trace->spans.reserve(static_cast<std::size_t>(TraceHop::PUBLISH) + 1);
+
+    return trace;
+}
+
+void ActuationTracer::finish(const std::shared_ptr<ActuationTrace>& trace)
+{
+    if (trace && m_sink)
+    {
+        m_sink->consume(*trace);
+    }
+}
+
+std::chrono::steady_clock::time_point ActuationTracer::spanStart(const std::shared_ptr<ActuationTrace>& trace)
+{
+    return trace ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+}
+
+void ActuationTracer::spanEnd(const std::shared_ptr<ActuationTrace>& trace, TraceHop hop,
+                              std::chrono::steady_clock::time_point start)
+{
+    if (trace)
+    {
+        trace->spans.push_back(TraceSpan{hop, start, std::chrono::steady_clock::now()});
+    }
+}
+}    // namespace wolkabout
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ACTUATIONTRACER_H
+#define ACTUATIONTRACER_H
+
+#include "TraceSink.h"
+#include "model/ActuationTrace.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Starts traces of actuations, and hands finished ones to sink.<br>
+ *        Trace is passed along with the command it belongs to, so each span is added by the thread
+ *        currently handling the command, and trace is never accessed concurrently.
+ */
+class ActuationTracer
+{
+public:
+    /**
+     * @param sink Receives finished traces
+     * @param sampleEvery Only every n-th actuation is traced
+     */
+    explicit ActuationTracer(std::shared_ptr<TraceSink> sink, unsigned int sampleEvery = 1);
+
+    /**
+     * @brief Starts trace of actuation, if it is sampled
+     * @return Trace, or nullptr if actuation is not traced
+     */
+    std::shared_ptr<ActuationTrace> begin(const std::string& deviceKey, const std::string& reference,
+                                          const std::string& value);
+
+    void finish(const std::shared_ptr<ActuationTrace>& trace);
+
+    /**
+     * @brief Returns start of span, or default time point when actuation is not traced, to avoid reading clock
+     */
+    static std::chrono::steady_clock::time_point spanStart(const std::shared_ptr<ActuationTrace>& trace);
+
+    /**
+     * @brief Adds span that started at given point and ends now, if actuation is traced
+     */
+    static void spanEnd(const std::shared_ptr<ActuationTrace>& trace, TraceHop hop,
+                        std::chrono::steady_clock::time_point start);
+
+private:
+    std::shared_ptr<TraceSink> m_sink;
+    const unsigned int m_sampleEvery;
+
+    std::atomic<unsigned long long int> m_actuationsCount;
+};
+}    // namespace wolkabout
+
+#endif    // ACTUATIONTRACER_H
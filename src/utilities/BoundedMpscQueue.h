@@ -0,0 +1,179 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BOUNDEDMPSCQUEUE_H
+#define BOUNDEDMPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace wolkabout
+{
+/**
+ * @brief Bounded lock-free queue with multiple producers and a single consumer.<br>
+ *        Each slot carries a sequence number telling producers and the consumer whose turn it is,
+ *        so neither side takes a lock.<br>
+ *        tryPop must only be called from one thread at a time.
+ */
+template <typename T> class BoundedMpscQueue
+{
+public:
+    /**
+     * @param capacity Maximum number of queued items, rounded up to power of two
+     * @throws std::invalid_argument if capacity is 0
+     */
+    explicit BoundedMpscQueue(std::size_t capacity)
+    : m_capacity{roundUpToPowerOfTwo(capacity)}
+    , m_mask{m_capacity - 1}
+    , m_slots{new Slot[m_capacity]}
+    , m_pushPosition{0}
+    , m_popPosition{0}
+    {
+        for (std::size_t i = 0; i < m_capacity; ++i)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    /**
+     * @brief Enqueues item if there is free slot
+     * @return true if enqueued, false if queue is full, in which case item is left untouched
+     */
+    bool tryPush(T& item)
+    {
+        auto position = m_pushPosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Slot& slot = m_slots[position & m_mask];
+            const auto sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0)
+            {
+                if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.item = std::move(item);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPush(T&& item) { return tryPush(item); }
+
+    /**
+     * @brief Dequeues oldest item, consumer side only
+     * @return false if queue is empty
+     */
+    bool tryPop(T& item)
+    {
+        const auto position = m_popPosition.load(std::memory_order_relaxed);
+
+        Slot& slot = m_slots[position & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+        {
+            return false;
+        }
+
+        item = std::move(slot.item);
+        slot.sequence.store(position + m_capacity, std::memory_order_release);
+        m_popPosition.store(position + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side check whether there is nothing to pop
+     */
+    bool empty() const
+    {
+        const auto position = m_popPosition.load(std::memory_order_relaxed);
+        return m_slots[position & m_mask].sequence.load(std::memory_order_acquire) != position + 1;
+    }
+
+    /**
+     * @brief Producer side check whether push would fail at this moment
+     */
+    bool full() const
+    {
+        const auto position = m_pushPosition.load(std::memory_order_relaxed);
+        return m_slots[position & m_mask].sequence.load(std::memory_order_acquire) < position;
+    }
+
+    /**
+     * @brief Approximate number of queued items, may be stale by the time it is returned
+     */
+    std::size_t size() const
+    {
+        const auto popPosition = m_popPosition.load(std::memory_order_relaxed);
+        const auto pushPosition = m_pushPosition.load(std::memory_order_relaxed);
+        return pushPosition > popPosition ? pushPosition - popPosition : 0;
+    }
+
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T item;
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value)
+    {
+        if (value == 0)
+        {
+            throw std::invalid_argument("Queue capacity must be greater than 0");
+        }
+
+        std::size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+
+        return result;
+    }
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // keeps producers and consumer positions on separate cache lines
+    char m_pushPadding[64];
+    std::atomic<std::size_t> m_pushPosition;
+    char m_popPadding[64];
+    std::atomic<std::size_t> m_popPosition;
+};
+}    // namespace wolkabout
+
+#endif    // BOUNDEDMPSCQUEUE_H
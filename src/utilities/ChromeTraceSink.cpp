@@ -0,0 +1,118 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/ChromeTraceSink.h"
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+const char* hopName(wolkabout::TraceHop hop)
+{
+    switch (hop)
+    {
+    case wolkabout::TraceHop::INBOUND_RECEIVE:
+        return "inbound receive";
+    case wolkabout::TraceHop::COMMAND_QUEUE:
+        return "command queue";
+    case wolkabout::TraceHop::HANDLER_QUEUE:
+        return "handler queue";
+    case wolkabout::TraceHop::ACTUATION_HANDLER:
+        return "actuation handler";
+    case wolkabout::TraceHop::STATUS_PROVIDER:
+        return "status provider";
+    case wolkabout::TraceHop::RESULT_QUEUE:
+        return "result queue";
+    case wolkabout::TraceHop::PUBLISH:
+        return "publish";
+    }
+
+    return "unknown";
+}
+
+std::string escape(const std::string& value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+
+    for (const char c : value)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char code[7];
+            std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned int>(c));
+            escaped += code;
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
+}    // namespace
+
+namespace wolkabout
+{
+ChromeTraceSink::ChromeTraceSink(const std::string& filePath)
+: m_file{filePath, std::ios::out | std::ios::trunc}
+, m_firstEvent{true}
+, m_origin{std::chrono::steady_clock::now()}
+{
+    if (!m_file)
+    {
+        throw std::runtime_error("Unable to open trace file: " + filePath);
+    }
+
+    m_file << "[";
+}
+
+ChromeTraceSink::~ChromeTraceSink()
+{
+    m_file << "\n]\n";
+}
+
+void ChromeTraceSink::consume(const ActuationTrace& trace)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    m_file << (m_firstEvent ? "\n" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << trace.id
+           << R"(,"args":{"name":")" << escape(trace.deviceKey) << '/' << escape(trace.reference) << R"("}})";
+    m_firstEvent = false;
+
+    for (const auto& span : trace.spans)
+    {
+        const auto start = microsecondsSinceOrigin(span.start);
+
+        m_file << ",\n"
+               << R"({"name":")" << hopName(span.hop) << R"(","cat":"actuation","ph":"X","pid":1,"tid":)"
+               << trace.id << R"(,"ts":)" << start << R"(,"dur":)" << microsecondsSinceOrigin(span.end) - start
+               << R"(,"args":{"value":")" << escape(trace.value) << R"("}})";
+    }
+}
+
+long long int ChromeTraceSink::microsecondsSinceOrigin(std::chrono::steady_clock::time_point timePoint) const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(timePoint - m_origin).count();
+}
+}    // namespace wolkabout
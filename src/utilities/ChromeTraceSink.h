@@ -0,0 +1,62 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHROMETRACESINK_H
+#define CHROMETRACESINK_H
+
+#include "TraceSink.h"
+#include "model/ActuationTrace.h"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Writes finished traces to a file in Chrome trace event format, viewable in chrome://tracing or Perfetto.<br>
+ *        Each actuation is shown as a separate track, with a slice per span.<br>
+ *        File is completed when sink is destroyed, but trace viewers also load files that are not completed.
+ */
+class ChromeTraceSink : public TraceSink
+{
+public:
+    /**
+     * @brief Creates trace file, overwriting existing one
+     * @param filePath Path to trace file
+     * @throws std::runtime_error if file can not be opened
+     */
+    explicit ChromeTraceSink(const std::string& filePath);
+    ~ChromeTraceSink() override;
+
+    ChromeTraceSink(const ChromeTraceSink&) = delete;
+    ChromeTraceSink& operator=(const ChromeTraceSink&) = delete;
+
+    void consume(const ActuationTrace& trace) override;
+
+private:
+    long long int microsecondsSinceOrigin(std::chrono::steady_clock::time_point timePoint) const;
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    bool m_firstEvent;
+
+    const std::chrono::steady_clock::time_point m_origin;
+};
+}    // namespace wolkabout
+
+#endif    // CHROMETRACESINK_H
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace wolkabout
+{
+/**
+ * @brief Move-only callable queued for execution.<br>
+ *        Callables that fit in INLINE_SIZE bytes are stored inline, avoiding heap allocation.
+ */
+class Command
+{
+public:
+    Command() noexcept : m_operations{nullptr} {}
+
+    template <typename F, typename = typename std::enable_if<
+                            !std::is_same<typename std::decay<F>::type, Command>::value>::type>
+    Command(F&& function) : m_operations{nullptr}
+    {
+        typedef typename std::decay<F>::type Function;
+        typedef typename std::conditional<fitsInline<Function>(), InlineStorage<Function>,
+                                          HeapStorage<Function>>::type Holder;
+
+        Holder::construct(&m_storage, std::forward<F>(function));
+        m_operations = Holder::operations();
+    }
+
+    Command(Command&& other) noexcept : m_operations{other.m_operations}
+    {
+        if (m_operations)
+        {
+            m_operations->move(&other.m_storage, &m_storage);
+            other.m_operations = nullptr;
+        }
+    }
+
+    Command& operator=(Command&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+
+            if (other.m_operations)
+            {
+                other.m_operations->move(&other.m_storage, &m_storage);
+                m_operations = other.m_operations;
+                other.m_operations = nullptr;
+            }
+        }
+
+        return *this;
+    }
+
+    Command(const Command&) = delete;
+    Command& operator=(const Command&) = delete;
+
+    ~Command() { reset(); }
+
+    void operator()()
+    {
+        if (m_operations)
+        {
+            m_operations->invoke(&m_storage);
+        }
+    }
+
+    explicit operator bool() const { return m_operations != nullptr; }
+
+    void reset()
+    {
+        if (m_operations)
+        {
+            m_operations->destroy(&m_storage);
+            m_operations = nullptr;
+        }
+    }
+
+    // fits commands of Wolk reading and alarm intake, which capture device key, reference and a value,
+    // and keeps sizeof(Command) within two cache lines
+    static const constexpr std::size_t INLINE_SIZE = 112;
+
+    /**
+     * @brief Whether callable of given type is stored inline, without heap allocation
+     */
+    template <typename Function> static constexpr bool fitsInline()
+    {
+        return sizeof(Function) <= INLINE_SIZE && alignof(std::max_align_t) % alignof(Function) == 0 &&
+               std::is_nothrow_move_constructible<Function>::value;
+    }
+
+private:
+    typedef typename std::aligned_storage<INLINE_SIZE, alignof(std::max_align_t)>::type Storage;
+
+    struct Operations
+    {
+        void (*invoke)(void* storage);
+        void (*move)(void* from, void* to);
+        void (*destroy)(void* storage);
+    };
+
+    template <typename Function> struct InlineStorage
+    {
+        template <typename F> static void construct(void* storage, F&& function)
+        {
+            ::new (storage) Function(std::forward<F>(function));
+        }
+
+        static void invoke(void* storage) { (*static_cast<Function*>(storage))(); }
+
+        static void move(void* from, void* to)
+        {
+            ::new (to) Function(std::move(*static_cast<Function*>(from)));
+            static_cast<Function*>(from)->~Function();
+        }
+
+        static void destroy(void* storage) { static_cast<Function*>(storage)->~Function(); }
+
+        static const Operations* operations()
+        {
+            static const Operations ops = {&invoke, &move, &destroy};
+            return &ops;
+        }
+    };
+
+    template <typename Function> struct HeapStorage
+    {
+        template <typename F> static void construct(void* storage, F&& function)
+        {
+            ::new (storage) Function*(new Function(std::forward<F>(function)));
+        }
+
+        static void invoke(void* storage) { (**static_cast<Function**>(storage))(); }
+
+        static void move(void* from, void* to) { ::new (to) Function*(*static_cast<Function**>(from)); }
+
+        static void destroy(void* storage) { delete *static_cast<Function**>(storage); }
+
+        static const Operations* operations()
+        {
+            static const Operations ops = {&invoke, &move, &destroy};
+            return &ops;
+        }
+    };
+
+    Storage m_storage;
+    const Operations* m_operations;
+};
+}    // namespace wolkabout
+
+#endif    // COMMAND_H
@@ -0,0 +1,201 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/CommandExecutor.h"
+
+#include <utility>
+
+namespace wolkabout
+{
+const constexpr std::size_t CommandExecutor::DEFAULT_CAPACITY;
+
+CommandExecutor::CommandExecutor(std::size_t capacity)
+: m_queue{capacity}
+, m_overflowSize{0}
+, m_running{true}
+, m_workerWaiting{false}
+, m_producersWaiting{0}
+, m_worker{&CommandExecutor::run, this}
+{
+}
+
+CommandExecutor::~CommandExecutor()
+{
+    stop();
+}
+
+bool CommandExecutor::push(Command command)
+{
+    unsigned int attempts = 0;
+    while (m_running)
+    {
+        if (queueAccepts(command))
+        {
+            notifyWorker();
+            return true;
+        }
+
+        if (isWorkerThread())
+        {
+            // waiting on itself would never end
+            return pushUnbounded(std::move(command));
+        }
+
+        if (++attempts < PUSH_ATTEMPTS_BEFORE_WAITING)
+        {
+            // worker usually frees a slot within few commands, cheaper than parking
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        ++m_producersWaiting;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_slotAvailable.wait(lock, [&] { return !m_running || (m_overflowSize == 0 && !m_queue.full()); });
+        --m_producersWaiting;
+        attempts = 0;
+    }
+
+    return false;
+}
+
+bool CommandExecutor::pushUnbounded(Command command)
+{
+    if (!m_running)
+    {
+        return false;
+    }
+
+    if (queueAccepts(command))
+    {
+        notifyWorker();
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_overflow.push_back(std::move(command));
+    ++m_overflowSize;
+    m_commandAvailable.notify_one();
+    return true;
+}
+
+bool CommandExecutor::tryPush(Command& command)
+{
+    if (!m_running || !queueAccepts(command))
+    {
+        return false;
+    }
+
+    notifyWorker();
+    return true;
+}
+
+void CommandExecutor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_running = false;
+    }
+
+    m_commandAvailable.notify_one();
+    m_slotAvailable.notify_all();
+
+    if (!m_worker.joinable())
+    {
+        return;
+    }
+
+    if (isWorkerThread())
+    {
+        m_worker.detach();
+        return;
+    }
+
+    m_worker.join();
+}
+
+std::size_t CommandExecutor::size() const
+{
+    return m_queue.size() + m_overflowSize;
+}
+
+bool CommandExecutor::isWorkerThread() const
+{
+    return std::this_thread::get_id() == m_worker.get_id();
+}
+
+void CommandExecutor::run()
+{
+    Command command;
+    while (waitForCommand(command))
+    {
+        if (m_producersWaiting != 0)
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_slotAvailable.notify_one();
+        }
+
+        command();
+        command.reset();
+    }
+}
+
+void CommandExecutor::notifyWorker()
+{
+    // pairs with the fence in waitForCommand, so either worker sees the command or we see it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_workerWaiting.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_commandAvailable.notify_one();
+    }
+}
+
+bool CommandExecutor::waitForCommand(Command& command)
+{
+    while (m_running)
+    {
+        if (m_queue.tryPop(command))
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return true;
+        }
+
+        std::unique_lock<std::mutex> lock{m_mutex};
+        if (!m_overflow.empty())
+        {
+            // queue is drained, so overflowed commands are next in order
+            command = std::move(m_overflow.front());
+            m_overflow.pop_front();
+            --m_overflowSize;
+            return true;
+        }
+
+        m_workerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_commandAvailable.wait(lock, [&] { return !m_running || !m_queue.empty() || m_overflowSize != 0; });
+        m_workerWaiting.store(false, std::memory_order_relaxed);
+    }
+
+    return false;
+}
+
+bool CommandExecutor::queueAccepts(Command& command)
+{
+    // nothing overtakes overflowed commands
+    return m_overflowSize == 0 && m_queue.tryPush(command);
+}
+}    // namespace wolkabout
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMANDEXECUTOR_H
+#define COMMANDEXECUTOR_H
+
+#include "utilities/BoundedMpscQueue.h"
+#include "utilities/Command.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace wolkabout
+{
+/**
+ * @brief Executes commands one at a time, in order of submission, on its own thread.<br>
+ *        Producers enqueue without locking; the mutex is only taken to wake an idle worker
+ *        or to park a producer while the queue is full.
+ */
+class CommandExecutor
+{
+public:
+    /**
+     * @param capacity Maximum number of pending commands, rounded up to power of two
+     */
+    explicit CommandExecutor(std::size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Stops executor, discarding pending commands
+     */
+    ~CommandExecutor();
+
+    CommandExecutor(const CommandExecutor&) = delete;
+    CommandExecutor& operator=(const CommandExecutor&) = delete;
+
+    /**
+     * @brief Enqueues command, waiting for free slot if queue is full<br>
+     *        When called from a command being executed, command is never waited on,
+     *        but is pushed as with pushUnbounded
+     * @return false if executor is stopped
+     */
+    bool push(Command command);
+
+    /**
+     * @brief Enqueues command without waiting<br>
+     *        If queue is full command is kept in an unbounded overflow list, and other producers wait
+     *        until it is executed. Intended for producers that must not wait on this executor,
+     *        such as other executors reporting results back.
+     * @return false if executor is stopped
+     */
+    bool pushUnbounded(Command command);
+
+    /**
+     * @brief Enqueues command if there is a free slot
+     * @return false if queue is full or executor is stopped, in which case command is left untouched
+     */
+    bool tryPush(Command& command);
+
+    void stop();
+
+    /**
+     * @brief Approximate number of pending commands
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Whether caller is a command being executed by this executor
+     */
+    bool isWorkerThread() const;
+
+    static const constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+private:
+    void run();
+
+    void notifyWorker();
+    bool waitForCommand(Command& command);
+
+    bool queueAccepts(Command& command);
+
+    BoundedMpscQueue<Command> m_queue;
+
+    // commands pushed with pushUnbounded while queue was full, guarded by m_mutex
+    std::deque<Command> m_overflow;
+    std::atomic<std::size_t> m_overflowSize;
+
+    std::atomic_bool m_running;
+    std::atomic_bool m_workerWaiting;
+    std::atomic<unsigned int> m_producersWaiting;
+
+    std::mutex m_mutex;
+    std::condition_variable m_commandAvailable;
+    std::condition_variable m_slotAvailable;
+
+    std::thread m_worker;
+
+    static const constexpr unsigned int PUSH_ATTEMPTS_BEFORE_WAITING = 64;
+};
+}    // namespace wolkabout
+
+#endif    // COMMANDEXECUTOR_H
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COMPLETIONGUARD_H
+#define COMPLETIONGUARD_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace wolkabout
+{
+/**
+ * @brief Guards completion callbacks handed out to code that outlives their owner.<br>
+ *        A guarded callback runs at most once, and does nothing once the guard is closed.
+ *        Closing waits for guarded callbacks that are running, so the owner may be destroyed right after.
+ */
+class CompletionGuard
+{
+public:
+    CompletionGuard() : m_state{std::make_shared<State>()} {}
+
+    ~CompletionGuard() { close(); }
+
+    CompletionGuard(const CompletionGuard&) = delete;
+    CompletionGuard& operator=(const CompletionGuard&) = delete;
+
+    /**
+     * @brief Wraps callback so that it runs at most once, and only while guard is open<br>
+     *        Returned callable can be called from any thread, and at any time
+     */
+    template <typename T> std::function<void(T)> guard(std::function<void(T)> callback) const
+    {
+        const auto state = m_state;
+        const auto completed = std::make_shared<std::atomic_bool>(false);
+
+        return [state, completed, callback](T result) {
+            if (completed->exchange(true))
+            {
+                return;
+            }
+
+            std::lock_guard<std::recursive_mutex> lock{state->mutex};
+            if (state->open)
+            {
+                callback(std::move(result));
+            }
+        };
+    }
+
+    /**
+     * @brief Disables all guarded callbacks, waiting for the ones being run
+     */
+    void close()
+    {
+        std::lock_guard<std::recursive_mutex> lock{m_state->mutex};
+        m_state->open = false;
+    }
+
+    bool isOpen() const
+    {
+        std::lock_guard<std::recursive_mutex> lock{m_state->mutex};
+        return m_state->open;
+    }
+
+private:
+    struct State
+    {
+        State() : open{true} {}
+
+        // recursive, so that a guarded callback may complete another one inline
+        std::recursive_mutex mutex;
+        bool open;
+    };
+
+    std::shared_ptr<State> m_state;
+};
+}    // namespace wolkabout
+
+#endif    // COMPLETIONGUARD_H
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXPONENTIALBACKOFF_H
+#define EXPONENTIALBACKOFF_H
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace wolkabout
+{
+/**
+ * @brief Delays between retries of a failing operation.<br>
+ *        Delay doubles with each retry up to a maximum, and is randomized to between half
+ *        and full value, so that many clients retrying after a common outage are spread out.<br>
+ *        Not thread safe.
+ */
+class ExponentialBackoff
+{
+public:
+    ExponentialBackoff(std::chrono::milliseconds initialDelay, std::chrono::milliseconds maxDelay)
+    : m_initialDelay{initialDelay}
+    , m_maxDelay{std::max(initialDelay, maxDelay)}
+    , m_delay{initialDelay}
+    , m_random{std::random_device{}()}
+    {
+    }
+
+    /**
+     * @brief Delay before next retry
+     */
+    std::chrono::milliseconds next()
+    {
+        const auto delay = m_delay;
+        m_delay = std::min(m_maxDelay, m_delay * 2);
+
+        std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter{delay.count() / 2, delay.count()};
+        return std::chrono::milliseconds{jitter(m_random)};
+    }
+
+    /**
+     * @brief Restarts from initial delay, ie. after operation succeeded
+     */
+    void reset() { m_delay = m_initialDelay; }
+
+private:
+    std::chrono::milliseconds m_initialDelay;
+    std::chrono::milliseconds m_maxDelay;
+    std::chrono::milliseconds m_delay;
+
+    std::minstd_rand m_random;
+};
+}    // namespace wolkabout
+
+#endif    // EXPONENTIALBACKOFF_H
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/InMemoryTraceSink.h"
+
+namespace wolkabout
+{
+const constexpr std::size_t InMemoryTraceSink::DEFAULT_CAPACITY;
+
+InMemoryTraceSink::InMemoryTraceSink(std::size_t capacity) : m_capacity{capacity == 0 ? 1 : capacity} {}
+
+void InMemoryTraceSink::consume(const ActuationTrace& trace)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    if (m_traces.size() == m_capacity)
+    {
+        m_traces.pop_front();
+    }
+
+    m_traces.push_back(trace);
+}
+
+std::vector<ActuationTrace> InMemoryTraceSink::getTraces() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    return std::vector<ActuationTrace>(m_traces.begin(), m_traces.end());
+}
+}    // namespace wolkabout
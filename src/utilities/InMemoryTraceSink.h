@@ -0,0 +1,56 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INMEMORYTRACESINK_H
+#define INMEMORYTRACESINK_H
+
+#include "TraceSink.h"
+#include "model/ActuationTrace.h"
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Keeps the latest finished traces in memory, dropping the oldest ones when full
+ */
+class InMemoryTraceSink : public TraceSink
+{
+public:
+    explicit InMemoryTraceSink(std::size_t capacity = DEFAULT_CAPACITY);
+
+    void consume(const ActuationTrace& trace) override;
+
+    /**
+     * @brief Returns kept traces, from oldest to latest<br>
+     *        Safe to call from any thread
+     */
+    std::vector<ActuationTrace> getTraces() const;
+
+    static const constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+private:
+    const std::size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+    std::deque<ActuationTrace> m_traces;
+};
+}    // namespace wolkabout
+
+#endif    // INMEMORYTRACESINK_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/Metrics.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace wolkabout
+{
+const constexpr unsigned int LatencyHistogram::SUB_BUCKET_BITS;
+const constexpr std::size_t LatencyHistogram::SUB_BUCKETS_COUNT;
+const constexpr std::size_t LatencyHistogram::BUCKETS_COUNT;
+
+LatencyHistogram::LatencyHistogram()
+: m_count{0}, m_sum{0}, m_min{std::numeric_limits<std::uint64_t>::max()}, m_max{0}
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(std::chrono::microseconds latency)
+{
+    const auto value = static_cast<std::uint64_t>(std::max<std::chrono::microseconds::rep>(latency.count(), 0));
+
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto min = m_min.load(std::memory_order_relaxed);
+    while (value < min && !m_min.compare_exchange_weak(min, value, std::memory_order_relaxed))
+    {
+    }
+
+    auto max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::recordSince(std::chrono::steady_clock::time_point start)
+{
+    record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+    std::array<std::uint64_t, BUCKETS_COUNT> buckets;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < BUCKETS_COUNT; ++i)
+    {
+        buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += buckets[i];
+    }
+
+    HistogramSnapshot snapshot{};
+    if (total == 0)
+    {
+        return snapshot;
+    }
+
+    snapshot.count = total;
+    snapshot.min = m_min.load(std::memory_order_relaxed);
+    snapshot.max = m_max.load(std::memory_order_relaxed);
+    snapshot.mean = static_cast<double>(m_sum.load(std::memory_order_relaxed)) /
+                    static_cast<double>(m_count.load(std::memory_order_relaxed));
+
+    const auto percentile = [&](double fraction) -> unsigned long long int {
+        const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * static_cast<double>(total)));
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t i = 0; i < BUCKETS_COUNT; ++i)
+        {
+            cumulative += buckets[i];
+            if (cumulative >= rank)
+            {
+                return std::min<std::uint64_t>(bucketUpperBound(i), snapshot.max);
+            }
+        }
+
+        return snapshot.max;
+    };
+
+    snapshot.p50 = percentile(0.5);
+    snapshot.p90 = percentile(0.9);
+    snapshot.p99 = percentile(0.99);
+    snapshot.p999 = percentile(0.999);
+
+    return snapshot;
+}
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t value)
+{
+    if (value < SUB_BUCKETS_COUNT)
+    {
+        return static_cast<std::size_t>(value);
+    }
+
+    // values with the same highest bit share a range, split into sub buckets by the following bits
+    const auto highestBit = static_cast<unsigned int>(63 - __builtin_clzll(value));
+    const auto shift = highestBit - SUB_BUCKET_BITS;
+
+    return shift * SUB_BUCKETS_COUNT + static_cast<std::size_t>(value >> shift);
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t index)
+{
+    if (index < 2 * SUB_BUCKETS_COUNT)
+    {
+        return index;
+    }
+
+    const auto shift = index / SUB_BUCKETS_COUNT - 1;
+    const auto lowerBound = static_cast<std::uint64_t>(index - shift * SUB_BUCKETS_COUNT) << shift;
+
+    return lowerBound + ((std::uint64_t{1} << shift) - 1);
+}
+}    // namespace wolkabout
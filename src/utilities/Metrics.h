@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "model/MetricsSnapshot.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace wolkabout
+{
+/**
+ * @brief Monotonically increasing count. Updates are lock-free, and safe from any thread.
+ */
+class Counter
+{
+public:
+    Counter() : m_value{0} {}
+
+    void increment(std::uint64_t count = 1) { m_value.fetch_add(count, std::memory_order_relaxed); }
+
+    std::uint64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> m_value;
+};
+
+/**
+ * @brief Current level of something, such as queue depth. Updates are lock-free, and safe from any thread.
+ */
+class Gauge
+{
+public:
+    Gauge() : m_value{0} {}
+
+    void set(std::int64_t value) { m_value.store(value, std::memory_order_relaxed); }
+
+    void add(std::int64_t delta) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+
+    std::int64_t value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::int64_t> m_value;
+};
+
+/**
+ * @brief Distribution of latencies in microseconds, in log-linear buckets as in HdrHistogram.<br>
+ *        Each power of two range is split into 16 buckets, so relative error is at most 1/16.<br>
+ *        Recording is lock-free, and safe from any thread. Snapshot taken while recording is in progress
+ *        may miss the latest values, but is never inconsistent by more than those.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(std::chrono::microseconds latency);
+
+    /**
+     * @brief Records time elapsed since given point
+     */
+    void recordSince(std::chrono::steady_clock::time_point start);
+
+    HistogramSnapshot snapshot() const;
+
+private:
+    static std::size_t bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketUpperBound(std::size_t index);
+
+    static const constexpr unsigned int SUB_BUCKET_BITS = 4;
+    static const constexpr std::size_t SUB_BUCKETS_COUNT = 1 << SUB_BUCKET_BITS;
+    static const constexpr std::size_t BUCKETS_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS_COUNT;
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS_COUNT> m_buckets;
+
+    std::atomic<std::uint64_t> m_count;
+    std::atomic<std::uint64_t> m_sum;
+    std::atomic<std::uint64_t> m_min;
+    std::atomic<std::uint64_t> m_max;
+};
+}    // namespace wolkabout
+
+#endif    // METRICS_H
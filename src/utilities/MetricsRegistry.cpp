@@ -0,0 +1,83 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/MetricsRegistry.h"
+
+namespace
+{
+template <typename Metric>
+Metric& findOrCreate(std::map<std::string, std::unique_ptr<Metric>>& metrics, const std::string& name)
+{
+    auto& metric = metrics[name];
+    if (!metric)
+    {
+        metric.reset(new Metric());
+    }
+
+    return *metric;
+}
+}    // namespace
+
+namespace wolkabout
+{
+Counter& MetricsRegistry::counter(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return findOrCreate(m_counters, name);
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return findOrCreate(m_gauges, name);
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return findOrCreate(m_histograms, name);
+}
+
+void MetricsRegistry::removeGauge(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_gauges.erase(name);
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    MetricsSnapshot snapshot;
+
+    for (const auto& kvp : m_counters)
+    {
+        snapshot.counters[kvp.first] = kvp.second->value();
+    }
+
+    for (const auto& kvp : m_gauges)
+    {
+        snapshot.gauges[kvp.first] = kvp.second->value();
+    }
+
+    for (const auto& kvp : m_histograms)
+    {
+        snapshot.histograms[kvp.first] = kvp.second->snapshot();
+    }
+
+    return snapshot;
+}
+}    // namespace wolkabout
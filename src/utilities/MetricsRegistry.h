@@ -0,0 +1,73 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include "model/MetricsSnapshot.h"
+#include "utilities/Metrics.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace wolkabout
+{
+/**
+ * @brief Owns named counters, gauges and latency histograms.<br>
+ *        Metrics are looked up or created under a lock, so components look them up once and keep references,
+ *        which stay valid for the lifetime of the registry. Updating metrics does not lock.
+ */
+class MetricsRegistry
+{
+public:
+    /**
+     * @brief Returns counter with given name, creating it if it does not exist
+     */
+    Counter& counter(const std::string& name);
+
+    /**
+     * @brief Returns gauge with given name, creating it if it does not exist
+     */
+    Gauge& gauge(const std::string& name);
+
+    /**
+     * @brief Returns histogram with given name, creating it if it does not exist
+     */
+    LatencyHistogram& histogram(const std::string& name);
+
+    /**
+     * @brief Removes gauge, references to it must not be used afterwards
+     */
+    void removeGauge(const std::string& name);
+
+    /**
+     * @brief Reads all metrics<br>
+     *        Safe to call from any thread, while metrics are updated
+     */
+    MetricsSnapshot snapshot() const;
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::map<std::string, std::unique_ptr<Counter>> m_counters;
+    std::map<std::string, std::unique_ptr<Gauge>> m_gauges;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> m_histograms;
+};
+}    // namespace wolkabout
+
+#endif    // METRICSREGISTRY_H
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/ShardedCommandExecutor.h"
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace wolkabout
+{
+ShardedCommandExecutor::ShardedCommandExecutor(std::size_t shardsCount, std::size_t capacity)
+{
+    if (shardsCount == 0)
+    {
+        throw std::invalid_argument("Sharded executor requires at least one shard");
+    }
+
+    for (std::size_t i = 0; i < shardsCount; ++i)
+    {
+        m_shards.emplace_back(new CommandExecutor(capacity));
+    }
+}
+
+bool ShardedCommandExecutor::push(const std::string& key, Command command)
+{
+    return shard(key).push(std::move(command));
+}
+
+void ShardedCommandExecutor::stop()
+{
+    for (const auto& executor : m_shards)
+    {
+        executor->stop();
+    }
+}
+
+std::size_t ShardedCommandExecutor::getShardsCount() const
+{
+    return m_shards.size();
+}
+
+CommandExecutor& ShardedCommandExecutor::shard(const std::string& key)
+{
+    return *m_shards[std::hash<std::string>()(key) % m_shards.size()];
+}
+}    // namespace wolkabout
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SHARDEDCOMMANDEXECUTOR_H
+#define SHARDEDCOMMANDEXECUTOR_H
+
+#include "utilities/Command.h"
+#include "utilities/CommandExecutor.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Spreads commands over several wolkabout::CommandExecutor instances by key.<br>
+ *        Commands with the same key always land on the same executor, and run in order of submission.
+ *        Commands with different keys may run in parallel.
+ */
+class ShardedCommandExecutor
+{
+public:
+    /**
+     * @param shardsCount Number of executors, each with its own thread
+     * @param capacity Maximum number of pending commands per executor
+     * @throws std::invalid_argument if shardsCount is 0
+     */
+    explicit ShardedCommandExecutor(std::size_t shardsCount,
+                                    std::size_t capacity = CommandExecutor::DEFAULT_CAPACITY);
+
+    /**
+     * @brief Enqueues command to executor of the key, waiting for free slot if its queue is full
+     * @return false if executor is stopped
+     */
+    bool push(const std::string& key, Command command);
+
+    void stop();
+
+    std::size_t getShardsCount() const;
+
+private:
+    CommandExecutor& shard(const std::string& key);
+
+    std::vector<std::unique_ptr<CommandExecutor>> m_shards;
+};
+}    // namespace wolkabout
+
+#endif    // SHARDEDCOMMANDEXECUTOR_H
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/SlabArena.h"
+
+#include <new>
+
+namespace
+{
+// each slot starts with pointer to its slab, padded so that object stays maximally aligned
+const std::size_t SLOT_HEADER_SIZE = (sizeof(void*) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}    // namespace
+
+namespace wolkabout
+{
+const constexpr std::size_t SlabArena::DEFAULT_SLOTS_PER_SLAB;
+
+SlabArena::SlabArena(std::size_t slotsPerSlab)
+: m_slotsPerSlab{slotsPerSlab == 0 ? 1 : slotsPerSlab}
+, m_slotSize{0}
+, m_slab{nullptr}
+, m_nextSlot{0}
+{
+}
+
+SlabArena::~SlabArena()
+{
+    if (m_slab)
+    {
+        // slots that were never handed out will not be deallocated
+        release(m_slab, m_slotsPerSlab - m_nextSlot);
+    }
+}
+
+void* SlabArena::allocate(std::size_t size)
+{
+    if (m_slotSize == 0)
+    {
+        m_slotSize = SLOT_HEADER_SIZE + alignedSize(size);
+    }
+
+    char* slot;
+    Slab* slab;
+
+    if (SLOT_HEADER_SIZE + alignedSize(size) != m_slotSize)
+    {
+        slot = static_cast<char*>(::operator new(SLOT_HEADER_SIZE + size));
+        slab = nullptr;
+    }
+    else
+    {
+        if (!m_slab || m_nextSlot == m_slotsPerSlab)
+        {
+            m_slab = newSlab();
+            m_nextSlot = 0;
+        }
+
+        slot = reinterpret_cast<char*>(m_slab) + alignedSize(sizeof(Slab)) + m_nextSlot++ * m_slotSize;
+        slab = m_slab;
+    }
+
+    *reinterpret_cast<Slab**>(slot) = slab;
+    return slot + SLOT_HEADER_SIZE;
+}
+
+void SlabArena::deallocate(void* pointer)
+{
+    char* slot = static_cast<char*>(pointer) - SLOT_HEADER_SIZE;
+
+    if (Slab* slab = *reinterpret_cast<Slab**>(slot))
+    {
+        release(slab, 1);
+    }
+    else
+    {
+        ::operator delete(slot);
+    }
+}
+
+std::size_t SlabArena::alignedSize(std::size_t size)
+{
+    return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
+
+void SlabArena::release(Slab* slab, std::size_t slots)
+{
+    if (slots != 0 && slab->liveSlots.fetch_sub(slots, std::memory_order_acq_rel) == slots)
+    {
+        slab->~Slab();
+        ::operator delete(slab);
+    }
+}
+
+SlabArena::Slab* SlabArena::newSlab()
+{
+    void* memory = ::operator new(alignedSize(sizeof(Slab)) + m_slotsPerSlab * m_slotSize);
+
+    // all slots count as live until handed out and deallocated, so slab outlives arena while in use
+    Slab* slab = new (memory) Slab;
+    slab->liveSlots.store(m_slotsPerSlab, std::memory_order_relaxed);
+
+    return slab;
+}
+}    // namespace wolkabout
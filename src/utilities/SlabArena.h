@@ -0,0 +1,99 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SLABARENA_H
+#define SLABARENA_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace wolkabout
+{
+/**
+ * @brief Allocates objects of the same size in consecutive slots of slabs, so that objects allocated
+ *        one after another lie next to each other.<br>
+ *        Each slab counts its live slots, and is freed as a whole when the last of them is deallocated.
+ *        Objects allocated together and released together, such as readings of a sensor, thus free memory
+ *        in one operation per slab.<br>
+ *        allocate must only be called from one thread at a time, while deallocate is safe from any thread,
+ *        also after arena is destroyed.
+ */
+class SlabArena
+{
+public:
+    explicit SlabArena(std::size_t slotsPerSlab = DEFAULT_SLOTS_PER_SLAB);
+    ~SlabArena();
+
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+    /**
+     * @brief Allocates memory in next free slot<br>
+     *        Slot size is set by the first allocation. Allocations of different size are made on the heap
+     */
+    void* allocate(std::size_t size);
+
+    static void deallocate(void* pointer);
+
+    static const constexpr std::size_t DEFAULT_SLOTS_PER_SLAB = 64;
+
+private:
+    struct Slab
+    {
+        std::atomic<std::size_t> liveSlots;
+    };
+
+    static std::size_t alignedSize(std::size_t size);
+    static void release(Slab* slab, std::size_t slots);
+
+    Slab* newSlab();
+
+    const std::size_t m_slotsPerSlab;
+    std::size_t m_slotSize;
+
+    Slab* m_slab;
+    std::size_t m_nextSlot;
+};
+
+/**
+ * @brief Standard allocator allocating from SlabArena, ie. for std::allocate_shared
+ */
+template <typename T> class SlabAllocator
+{
+public:
+    using value_type = T;
+
+    explicit SlabAllocator(SlabArena& arena) : m_arena{&arena} {}
+
+    template <typename U> SlabAllocator(const SlabAllocator<U>& other) : m_arena{other.m_arena} {}
+
+    T* allocate(std::size_t count) { return static_cast<T*>(m_arena->allocate(count * sizeof(T))); }
+
+    void deallocate(T* pointer, std::size_t) { SlabArena::deallocate(pointer); }
+
+    template <typename U> bool operator==(const SlabAllocator<U>& other) const { return m_arena == other.m_arena; }
+
+    template <typename U> bool operator!=(const SlabAllocator<U>& other) const { return m_arena != other.m_arena; }
+
+private:
+    template <typename U> friend class SlabAllocator;
+
+    // only used to allocate, deallocation finds slab through slot header
+    SlabArena* m_arena;
+};
+}    // namespace wolkabout
+
+#endif    // SLABARENA_H
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TOPICTRIE_H
+#define TOPICTRIE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wolkabout
+{
+/**
+ * @brief Maps MQTT topic filters to values, and matches topics against them level by level.<br>
+ *        Matching cost depends on topic depth, not on the number of filters.<br>
+ *        When several filters match a topic, literal level is preferred over '+', and '+' over '#'.<br>
+ *        Trie is not synchronized, concurrent matching is safe only while it is not modified.
+ */
+template <typename T> class TopicTrie
+{
+public:
+    TopicTrie() : m_root{new Node()} {}
+
+    /**
+     * @brief Adds filter, replacing value of the same filter if it was already added
+     * @param filter MQTT topic filter, may contain '+' and '#' wildcards
+     * @param value Value returned for topics matching filter
+     */
+    void insert(const std::string& filter, T value)
+    {
+        Node* node = m_root.get();
+
+        std::size_t begin = 0;
+        while (begin <= filter.size())
+        {
+            auto end = filter.find(LEVEL_SEPARATOR, begin);
+            if (end == std::string::npos)
+            {
+                end = filter.size();
+            }
+
+            node = node->child(filter.substr(begin, end - begin));
+            begin = end + 1;
+        }
+
+        node->hasValue = true;
+        node->value = std::move(value);
+    }
+
+    /**
+     * @return Value of the best matching filter, or nullptr if topic matches no filter
+     */
+    const T* match(const std::string& topic) const { return match(*m_root, topic, 0); }
+
+private:
+    struct Node
+    {
+        Node() : hasValue{false}, value{} {}
+
+        Node* child(const std::string& level)
+        {
+            if (level == SINGLE_LEVEL_WILDCARD || level == MULTI_LEVEL_WILDCARD)
+            {
+                auto& wildcard = level == SINGLE_LEVEL_WILDCARD ? singleLevel : multiLevel;
+                if (!wildcard)
+                {
+                    wildcard.reset(new Node());
+                }
+
+                return wildcard.get();
+            }
+
+            auto it = findChild(level.c_str(), level.size());
+            if (it == children.end() || it->first != level)
+            {
+                it = children.emplace(it, level, std::unique_ptr<Node>(new Node()));
+            }
+
+            return it->second.get();
+        }
+
+        typename std::vector<std::pair<std::string, std::unique_ptr<Node>>>::const_iterator findChild(
+          const char* level, std::size_t length) const
+        {
+            return std::lower_bound(children.begin(), children.end(), std::make_pair(level, length),
+                                    [](const std::pair<std::string, std::unique_ptr<Node>>& child,
+                                       const std::pair<const char*, std::size_t>& key) {
+                                        return child.first.compare(0, std::string::npos, key.first, key.second) < 0;
+                                    });
+        }
+
+        // sorted by level, searched without copying topic levels
+        std::vector<std::pair<std::string, std::unique_ptr<Node>>> children;
+        std::unique_ptr<Node> singleLevel;
+        std::unique_ptr<Node> multiLevel;
+
+        bool hasValue;
+        T value;
+    };
+
+    // begin past the end of topic means that all levels are matched
+    static const T* match(const Node& node, const std::string& topic, std::size_t begin)
+    {
+        if (begin > topic.size())
+        {
+            if (node.hasValue)
+            {
+                return &node.value;
+            }
+
+            // 'a/#' matches 'a' as well
+            return node.multiLevel && node.multiLevel->hasValue ? &node.multiLevel->value : nullptr;
+        }
+
+        auto end = topic.find(LEVEL_SEPARATOR, begin);
+        if (end == std::string::npos)
+        {
+            end = topic.size();
+        }
+
+        const auto length = end - begin;
+
+        auto it = node.findChild(topic.data() + begin, length);
+        if (it != node.children.end() && it->first.compare(0, std::string::npos, topic.data() + begin, length) == 0)
+        {
+            if (const T* value = match(*it->second, topic, end + 1))
+            {
+                return value;
+            }
+        }
+
+        if (node.singleLevel)
+        {
+            if (const T* value = match(*node.singleLevel, topic, end + 1))
+            {
+                return value;
+            }
+        }
+
+        return node.multiLevel && node.multiLevel->hasValue ? &node.multiLevel->value : nullptr;
+    }
+
+    std::unique_ptr<Node> m_root;
+
+    static const constexpr char LEVEL_SEPARATOR = '/';
+    static const constexpr char* SINGLE_LEVEL_WILDCARD = "+";
+    static const constexpr char* MULTI_LEVEL_WILDCARD = "#";
+};
+}    // namespace wolkabout
+
+#endif    // TOPICTRIE_H
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WATERMARK_H
+#define WATERMARK_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace wolkabout
+{
+/**
+ * @brief Tracks whether a load level crossed its high watermark.<br>
+ *        Once crossed, level stays exceeded until it drops to the low watermark,
+ *        so that overload handling does not flap around a single threshold.
+ */
+class Watermark
+{
+public:
+    Watermark() : m_high{0}, m_low{0}, m_exceeded{false} {}
+
+    /**
+     * @param high Level at which watermark is exceeded, 0 disables watermark
+     * @param low Level at which exceeded watermark is cleared
+     */
+    void setLevels(std::size_t high, std::size_t low)
+    {
+        m_high = high;
+        m_low = low;
+        m_exceeded = false;
+    }
+
+    /**
+     * @brief Updates state with current level
+     * @return true if watermark is exceeded
+     */
+    bool exceeded(std::size_t level)
+    {
+        if (m_high == 0)
+        {
+            return false;
+        }
+
+        if (level >= m_high)
+        {
+            m_exceeded = true;
+        }
+        else if (level <= m_low)
+        {
+            m_exceeded = false;
+        }
+
+        return m_exceeded;
+    }
+
+    bool enabled() const { return m_high != 0; }
+
+private:
+    std::size_t m_high;
+    std::size_t m_low;
+    std::atomic_bool m_exceeded;
+};
+}    // namespace wolkabout
+
+#endif    // WATERMARK_H
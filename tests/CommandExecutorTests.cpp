@@ -0,0 +1,259 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/BoundedMpscQueue.h"
+#include "utilities/Command.h"
+#include "utilities/CommandExecutor.h"
+#include "utilities/ShardedCommandExecutor.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(CommandExecutor, Given_FullQueue_When_CommandIsPushed_Then_PushFailsUntilItemIsPopped)
+{
+    // Given
+    wolkabout::BoundedMpscQueue<int> queue{3};
+    ASSERT_EQ(queue.capacity(), 4);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_TRUE(queue.tryPush(i));
+    }
+
+    // When
+    int value = 4;
+    const auto pushedWhenFull = queue.tryPush(value);
+
+    int popped = -1;
+    ASSERT_TRUE(queue.tryPop(popped));
+    const auto pushedAfterPop = queue.tryPush(value);
+
+    // Then
+    ASSERT_FALSE(pushedWhenFull);
+    ASSERT_TRUE(pushedAfterPop);
+    ASSERT_EQ(popped, 0);
+
+    std::vector<int> remaining;
+    while (queue.tryPop(popped))
+    {
+        remaining.push_back(popped);
+    }
+
+    ASSERT_EQ(remaining, (std::vector<int>{1, 2, 3, 4}));
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(CommandExecutor, Given_LargeAndSmallCallables_When_CommandsAreMoved_Then_EachIsInvokedOnce)
+{
+    // Given
+    auto counter = std::make_shared<int>(0);
+    std::array<char, 2 * wolkabout::Command::INLINE_SIZE> large{};
+
+    wolkabout::Command small{[counter] { ++*counter; }};
+    wolkabout::Command big{[counter, large] { *counter += 10 + large[0]; }};
+
+    // When
+    wolkabout::Command movedSmall{std::move(small)};
+    wolkabout::Command movedBig;
+    movedBig = std::move(big);
+
+    movedSmall();
+    movedBig();
+    small();
+    big();
+
+    // Then
+    ASSERT_EQ(*counter, 11);
+    ASSERT_FALSE(static_cast<bool>(small));
+    ASSERT_FALSE(static_cast<bool>(big));
+
+    movedSmall.reset();
+    movedBig.reset();
+    ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(CommandExecutor, Given_ManyProducers_When_QueueIsSmall_Then_AllCommandsAreExecutedInProducerOrder)
+{
+    // Given
+    const int producersCount = 4;
+    const int commandsPerProducer = 10000;
+
+    std::vector<std::vector<int>> executed(producersCount);
+    std::atomic<int> remaining{producersCount * commandsPerProducer};
+
+    std::mutex mutex;
+    std::condition_variable done;
+
+    {
+        wolkabout::CommandExecutor executor{8};
+
+        // When
+        std::vector<std::thread> producers;
+        for (int producer = 0; producer < producersCount; ++producer)
+        {
+            producers.emplace_back([&, producer] {
+                for (int i = 0; i < commandsPerProducer; ++i)
+                {
+                    executor.push([&, producer, i] {
+                        executed[static_cast<std::size_t>(producer)].push_back(i);
+                        if (--remaining == 0)
+                        {
+                            std::lock_guard<std::mutex> lock{mutex};
+                            done.notify_one();
+                        }
+                    });
+                }
+            });
+        }
+
+        for (auto& thread : producers)
+        {
+            thread.join();
+        }
+
+        std::unique_lock<std::mutex> lock{mutex};
+        ASSERT_TRUE(done.wait_for(lock, std::chrono::seconds{30}, [&] { return remaining == 0; }));
+    }
+
+    // Then
+    for (const auto& commands : executed)
+    {
+        ASSERT_EQ(commands.size(), static_cast<std::size_t>(commandsPerProducer));
+        for (int i = 0; i < commandsPerProducer; ++i)
+        {
+            ASSERT_EQ(commands[static_cast<std::size_t>(i)], i);
+        }
+    }
+}
+
+TEST(CommandExecutor, Given_FullQueue_When_CommandPushesFromWorker_Then_CommandIsExecutedWithoutDeadlock)
+{
+    // Given
+    std::atomic<int> executed{0};
+    std::mutex mutex;
+    std::condition_variable done;
+
+    {
+        wolkabout::CommandExecutor executor{2};
+
+        // When
+        executor.push([&] {
+            for (int i = 0; i < 10; ++i)
+            {
+                executor.push([&] {
+                    if (++executed == 10)
+                    {
+                        std::lock_guard<std::mutex> lock{mutex};
+                        done.notify_one();
+                    }
+                });
+            }
+        });
+
+        // Then
+        std::unique_lock<std::mutex> lock{mutex};
+        ASSERT_TRUE(done.wait_for(lock, std::chrono::seconds{10}, [&] { return executed == 10; }));
+    }
+}
+
+TEST(CommandExecutor, Given_BlockedWorker_When_CommandsArePushedUnbounded_Then_TheyAreExecutedInOrder)
+{
+    // Given
+    std::vector<int> executed;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool released = false;
+
+    {
+        wolkabout::CommandExecutor executor{2};
+
+        executor.push([&] {
+            std::unique_lock<std::mutex> lock{mutex};
+            condition.wait(lock, [&] { return released; });
+        });
+
+        // When
+        for (int i = 0; i < 10; ++i)
+        {
+            ASSERT_TRUE(executor.pushUnbounded([&executed, i] { executed.push_back(i); }));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            released = true;
+        }
+        condition.notify_one();
+
+        std::promise<void> done;
+        executor.push([&] { done.set_value(); });
+        ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds{10}), std::future_status::ready);
+    }
+
+    // Then
+    ASSERT_EQ(executed, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(CommandExecutor, Given_ShardedExecutor_When_CommandsArePushedForKeys_Then_EachKeyKeepsItsOrder)
+{
+    // Given
+    const int keysCount = 8;
+    const int commandsPerKey = 1000;
+
+    std::vector<std::vector<int>> executed(keysCount);
+    std::atomic<int> remaining{keysCount * commandsPerKey};
+    std::promise<void> done;
+
+    {
+        wolkabout::ShardedCommandExecutor executor{3, 16};
+
+        // When
+        for (int i = 0; i < commandsPerKey; ++i)
+        {
+            for (int key = 0; key < keysCount; ++key)
+            {
+                executor.push("DEVICE_" + std::to_string(key), [&, key, i] {
+                    executed[static_cast<std::size_t>(key)].push_back(i);
+                    if (--remaining == 0)
+                    {
+                        done.set_value();
+                    }
+                });
+            }
+        }
+
+        ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds{30}), std::future_status::ready);
+    }
+
+    // Then
+    for (const auto& commands : executed)
+    {
+        ASSERT_EQ(commands.size(), static_cast<std::size_t>(commandsPerKey));
+        for (int i = 0; i < commandsPerKey; ++i)
+        {
+            ASSERT_EQ(commands[static_cast<std::size_t>(i)], i);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "utilities/CommandExecutor.h"
+#include "utilities/CompletionGuard.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+TEST(CompletionGuard, Given_CallbackCompletedOnForeignThread_When_ResultIsPosted_Then_ItIsAppliedOnExecutor)
+{
+    // Given
+    wolkabout::CommandExecutor executor;
+    wolkabout::CompletionGuard guard;
+
+    std::promise<bool> appliedOnWorker;
+    auto onResult = guard.guard(std::function<void(int)>{[&](int result) {
+        executor.pushUnbounded([&, result] { appliedOnWorker.set_value(result == 42 && executor.isWorkerThread()); });
+    }});
+
+    // When
+    std::thread provider{[onResult] { onResult(42); }};
+    provider.join();
+
+    // Then
+    auto applied = appliedOnWorker.get_future();
+    ASSERT_EQ(applied.wait_for(std::chrono::seconds{10}), std::future_status::ready);
+    ASSERT_TRUE(applied.get());
+}
+
+TEST(CompletionGuard, Given_GuardedCallback_When_ItIsCompletedTwice_Then_OnlyFirstResultIsApplied)
+{
+    // Given
+    wolkabout::CompletionGuard guard;
+
+    int calls = 0;
+    int applied = 0;
+    auto onResult = guard.guard(std::function<void(int)>{[&](int result) {
+        ++calls;
+        applied = result;
+    }});
+
+    // When
+    onResult(1);
+    onResult(2);
+
+    // Then
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(applied, 1);
+}
+
+TEST(CompletionGuard, Given_CallbackThatNeverCompletes_When_OwnerIsDestroyed_Then_LateCompletionIsIgnored)
+{
+    // Given
+    auto guard = std::unique_ptr<wolkabout::CompletionGuard>(new wolkabout::CompletionGuard());
+
+    bool called = false;
+    auto onResult = guard->guard(std::function<void(int)>{[&](int) { called = true; }});
+    auto neverCompleted = guard->guard(std::function<void(int)>{[&](int) { called = true; }});
+
+    // When
+    guard.reset();
+    neverCompleted = nullptr;
+    onResult(1);
+
+    // Then
+    ASSERT_FALSE(called);
+}
+
+TEST(CompletionGuard, Given_RunningCallback_When_GuardIsClosed_Then_CloseWaitsForIt)
+{
+    // Given
+    wolkabout::CompletionGuard guard;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool started = false;
+    bool released = false;
+    std::atomic_bool finished{false};
+
+    auto onResult = guard.guard(std::function<void(int)>{[&](int) {
+        std::unique_lock<std::mutex> lock{mutex};
+        started = true;
+        condition.notify_all();
+        condition.wait(lock, [&] { return released; });
+        finished = true;
+    }});
+
+    std::thread provider{[onResult] { onResult(1); }};
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        condition.wait(lock, [&] { return started; });
+    }
+
+    // When
+    auto closed = std::async(std::launch::async, [&] {
+        guard.close();
+        return finished.load();
+    });
+
+    ASSERT_EQ(closed.wait_for(std::chrono::milliseconds{100}), std::future_status::timeout);
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        released = true;
+        condition.notify_all();
+    }
+
+    // Then
+    ASSERT_TRUE(closed.get());
+    ASSERT_FALSE(guard.isOpen());
+
+    provider.join();
+}
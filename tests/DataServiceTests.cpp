@@ -18,6 +18,9 @@
 #include "MockPersistance.h"
 #include "core/connectivity/ConnectivityService.h"
 #include "core/model/Message.h"
+#include "protocol/SensorReadingsEnvelopeProtocol.h"
+#include "utilities/InMemoryTraceSink.h"
+#include "utilities/MetricsRegistry.h"
 
 #define private public
 #define protected public
@@ -27,8 +30,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <map>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -60,6 +66,83 @@ private:
     std::vector<std::shared_ptr<wolkabout::Message>> m_messages;
 };
 
+class EnvelopeProtocol : public wolkabout::SensorReadingsEnvelopeProtocol
+{
+public:
+    std::unique_ptr<wolkabout::Message> makeEnvelope(
+      const std::vector<wolkabout::SensorReadingsGroup>& groups) const override
+    {
+        std::vector<std::string> envelope;
+        std::size_t itemsCount = 0;
+        for (const auto& group : groups)
+        {
+            envelope.push_back(group.deviceKey + ":" + group.sensorReadings.front()->getReference() + "x" +
+                               std::to_string(group.sensorReadings.size()));
+            itemsCount += group.sensorReadings.size();
+        }
+
+        m_envelopes.push_back(envelope);
+        return std::unique_ptr<wolkabout::Message>(new wolkabout::Message(std::string(itemsCount * 10, 'x'), ""));
+    }
+
+    // groups of each made envelope, including envelopes that were shrunk before publish
+    mutable std::vector<std::vector<std::string>> m_envelopes;
+};
+
+// persisted readings per persistence key, served through mock persistence
+class PersistedReadings
+{
+public:
+    void put(const std::string& key, const std::string& reference, unsigned int count)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            m_readings[key].push_back(std::make_shared<wolkabout::SensorReading>(std::to_string(i), reference));
+        }
+    }
+
+    void expect(MockPersistence& persistence)
+    {
+        EXPECT_CALL(persistence, getSensorReadingsKeys()).WillRepeatedly(testing::InvokeWithoutArgs([&] {
+            std::vector<std::string> keys;
+            for (const auto& kvp : m_readings)
+            {
+                if (!kvp.second.empty())
+                {
+                    keys.push_back(kvp.first);
+                }
+            }
+            return keys;
+        }));
+
+        EXPECT_CALL(persistence, getSensorReadings(testing::_, testing::_))
+          .WillRepeatedly(testing::Invoke([&](const std::string& key, std::uint_fast64_t count) {
+              const auto& readings = m_readings[key];
+              return std::vector<std::shared_ptr<wolkabout::SensorReading>>(
+                readings.begin(), readings.begin() + static_cast<long>(std::min<std::size_t>(count, readings.size())));
+          }));
+
+        EXPECT_CALL(persistence, removeSensorReadings(testing::_, testing::_))
+          .WillRepeatedly(testing::Invoke([&](const std::string& key, std::uint_fast64_t count) {
+              auto& readings = m_readings[key];
+              readings.erase(readings.begin(),
+                             readings.begin() + static_cast<long>(std::min<std::size_t>(count, readings.size())));
+          }));
+    }
+
+    bool empty() const
+    {
+        return std::all_of(m_readings.begin(), m_readings.end(), [](const std::pair<const std::string, Readings>& kvp) {
+            return kvp.second.empty();
+        });
+    }
+
+private:
+    typedef std::vector<std::shared_ptr<wolkabout::SensorReading>> Readings;
+
+    std::map<std::string, Readings> m_readings;
+};
+
 class DataService : public ::testing::Test
 {
 public:
@@ -71,7 +154,8 @@ public:
 
         dataService = std::unique_ptr<wolkabout::DataService>(new wolkabout::DataService(
           *dataProtocol, *persistence, *connectivityService,
-          [&](const std::string& key, const std::string& ref, const std::string& value) {
+          [&](const std::string& key, const std::string& ref, const std::string& value,
+              std::shared_ptr<wolkabout::ActuationTrace>) {
               actuatorSetCommands.push_back(std::make_tuple(key, ref, value));
           },
           [&](const std::string& key, const std::string& ref) {
@@ -339,6 +423,46 @@ TEST_F(
     // Then
 }
 
+TEST_F(DataService, Given_TypedSensorReading_When_AddSensorReadingIsCalled_Then_ValueIsFormattedForPersistence)
+{
+    // Given
+    const std::string key = "DEVICE_KEY";
+    const std::string ref = "REF";
+    const auto rtc = 2463477347;
+
+    std::shared_ptr<wolkabout::SensorReading> persistedReading;
+    EXPECT_CALL(*persistence, putSensorReading(key + "+" + ref, testing::_))
+      .Times(1)
+      .WillOnce(testing::DoAll(testing::SaveArg<1>(&persistedReading), testing::Return(true)));
+
+    // When
+    dataService->addSensorReading(key, ref, wolkabout::ReadingValue(25), rtc);
+
+    // Then
+    ASSERT_TRUE(persistedReading != nullptr);
+    ASSERT_EQ(persistedReading->getValue(), "25");
+}
+
+TEST_F(DataService, Given_SensorReadingBatch_When_AddSensorReadingsIsCalled_Then_EachReadingIsAddedToPeristance)
+{
+    // Given
+    const std::string key = "DEVICE_KEY";
+    const std::string ref1 = "REF1";
+    const std::string ref2 = "REF2";
+    const auto rtc = 2463477347;
+
+    wolkabout::SensorReadingBatch batch;
+    batch.add(ref1, std::string("VALUE1")).add(ref1, std::string("VALUE2")).add(ref2, {1, 2, 3}, rtc);
+
+    EXPECT_CALL(*persistence, putSensorReading(key + "+" + ref1, testing::_))
+      .Times(2)
+      .WillRepeatedly(testing::Return(true));
+    EXPECT_CALL(*persistence, putSensorReading(key + "+" + ref2, testing::_)).Times(1).WillOnce(testing::Return(true));
+
+    // When
+    dataService->addSensorReadings(key, batch.getReadings(), rtc);
+}
+
 TEST_F(DataService, Given_Alarm_When_AddAlarmIsCalled_Then_AlarmIsAddedToPeristance)
 {
     // Given
@@ -939,3 +1063,467 @@ TEST_F(
 
     ASSERT_EQ(connectivityService->getMessages().size(), 1);
 }
+
+TEST_F(DataService,
+       Given_PublishBatchMaxBytes_When_PublishSensorReadingsIsCalled_Then_ReadingsArePublishedInBoundedMessages)
+{
+    // Given
+    const auto key = "KEY1+REF1";
+
+    wolkabout::DataService boundedDataService(
+      *dataProtocol, *persistence, *connectivityService,
+      [](const std::string&, const std::string&, const std::string&, std::shared_ptr<wolkabout::ActuationTrace>) {},
+      [](const std::string&, const std::string&) {},
+      [](const std::string&, const std::vector<wolkabout::ConfigurationItem>&) {}, [](const std::string&) {}, 4, 25);
+
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> readings = {
+      std::make_shared<wolkabout::SensorReading>("1", "REF1"), std::make_shared<wolkabout::SensorReading>("2", "REF1"),
+      std::make_shared<wolkabout::SensorReading>("3", "REF1"), std::make_shared<wolkabout::SensorReading>("4", "REF1")};
+
+    EXPECT_CALL(*dataProtocol,
+                makeMessageProxy(testing::_,
+                                 testing::Matcher<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>(
+                                   testing::_)))
+      .WillRepeatedly(testing::Invoke(
+        [](const std::string&, const std::vector<std::shared_ptr<wolkabout::SensorReading>>& sensorReadings) {
+            return new wolkabout::Message(std::string(sensorReadings.size() * 10, 'x'), "");
+        }));
+
+    EXPECT_CALL(*persistence, getSensorReadingsKeys())
+      .WillRepeatedly(testing::Return(std::vector<std::string>{key}));
+
+    EXPECT_CALL(*persistence, getSensorReadings(key, 4))
+      .WillRepeatedly(testing::InvokeWithoutArgs([&] { return readings; }));
+
+    EXPECT_CALL(*persistence, removeSensorReadings(key, 2)).Times(1).WillOnce(testing::InvokeWithoutArgs([&] {
+        readings.erase(readings.begin(), readings.begin() + 2);
+    }));
+
+    EXPECT_CALL(*persistence, removeSensorReadings(key, 4)).Times(1).WillOnce(testing::InvokeWithoutArgs([&] {
+        readings.clear();
+    }));
+
+    // When
+    boundedDataService.publishSensorReadings();
+
+    // Then
+    ASSERT_EQ(connectivityService->getMessages().size(), 2);
+    for (const auto& message : connectivityService->getMessages())
+    {
+        ASSERT_LE(message->getContent().size(), 25u);
+    }
+}
+
+TEST_F(DataService,
+       Given_PersistedReadings_When_PublishSensorReadingsIsCalledWithBudget_Then_PublishingStopsWhenBudgetIsExhausted)
+{
+    // Given
+    const auto key = "KEY1+REF1";
+
+    const std::vector<std::shared_ptr<wolkabout::SensorReading>> readings = {
+      std::make_shared<wolkabout::SensorReading>("1", "REF1")};
+
+    EXPECT_CALL(*dataProtocol,
+                makeMessageProxy(testing::_,
+                                 testing::Matcher<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>(
+                                   testing::_)))
+      .Times(2)
+      .WillRepeatedly(testing::InvokeWithoutArgs([&] { return new wolkabout::Message("", ""); }));
+
+    EXPECT_CALL(*persistence, getSensorReadingsKeys())
+      .WillRepeatedly(testing::Return(std::vector<std::string>{key}));
+
+    EXPECT_CALL(*persistence, getSensorReadings(key, wolkabout::DataService::PUBLISH_BATCH_ITEMS_COUNT))
+      .WillRepeatedly(testing::Return(readings));
+
+    EXPECT_CALL(*persistence, removeSensorReadings(key, wolkabout::DataService::PUBLISH_BATCH_ITEMS_COUNT)).Times(2);
+
+    wolkabout::PublishBudget budget{2};
+
+    // When
+    const bool pending = dataService->publishSensorReadings(budget);
+
+    // Then
+    ASSERT_TRUE(pending);
+    ASSERT_EQ(connectivityService->getMessages().size(), 2);
+}
+
+TEST_F(DataService,
+       Given_SensorReadingsBacklog_When_PublishSensorReadingsIsCalledWithBudget_Then_CurrentReadingsArePublishedFirst)
+{
+    // Given
+    const std::string backlogKey = "KEY1+REF1";
+    const std::string currentKey = "KEY1+REF2";
+
+    EXPECT_CALL(*persistence, getSensorReadingsKeys())
+      .WillOnce(testing::Return(std::vector<std::string>{backlogKey}))
+      .WillRepeatedly(testing::Return(std::vector<std::string>{backlogKey, currentKey}));
+
+    dataService->markSensorReadingsBacklog();
+
+    EXPECT_CALL(*dataProtocol,
+                makeMessageProxy(testing::_,
+                                 testing::Matcher<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>(
+                                   testing::_)))
+      .Times(1)
+      .WillOnce(testing::InvokeWithoutArgs([&] { return new wolkabout::Message("", ""); }));
+
+    EXPECT_CALL(*persistence, getSensorReadings(currentKey, wolkabout::DataService::PUBLISH_BATCH_ITEMS_COUNT))
+      .WillOnce(testing::Return(std::vector<std::shared_ptr<wolkabout::SensorReading>>{
+        std::make_shared<wolkabout::SensorReading>("1", "REF2")}));
+
+    EXPECT_CALL(*persistence, getSensorReadings(backlogKey, testing::_)).Times(0);
+
+    EXPECT_CALL(*persistence, removeSensorReadings(currentKey, wolkabout::DataService::PUBLISH_BATCH_ITEMS_COUNT))
+      .Times(1);
+
+    wolkabout::PublishBudget budget{1};
+
+    // When
+    const bool pending = dataService->publishSensorReadings(budget);
+
+    // Then
+    ASSERT_TRUE(pending);
+    ASSERT_EQ(connectivityService->getMessages().size(), 1);
+}
+
+TEST_F(DataService,
+       Given_DeviceKeyWithDelimiter_When_PublishSensorReadingsForDeviceKeyIsCalled_Then_ReadingsArePublishedForDevice)
+{
+    // Given
+    const std::string deviceKey = "DEVICE+KEY";
+    const std::string key = "DEVICE\\+KEY+REF";
+
+    bool removeCalled = false;
+
+    EXPECT_CALL(*persistence, putSensorReading(key, testing::_)).Times(1).WillOnce(testing::Return(true));
+    dataService->addSensorReading(deviceKey, "REF", std::string{"VALUE"}, 0);
+
+    EXPECT_CALL(*persistence, getSensorReadingsKeys())
+      .WillRepeatedly(testing::Return(std::vector<std::string>{key}));
+
+    EXPECT_CALL(*persistence, getSensorReadings(key, wolkabout::DataService::PUBLISH_BATCH_ITEMS_COUNT))
+      .WillRepeatedly(testing::InvokeWithoutArgs([&] {
+          return removeCalled ? std::vector<std::shared_ptr<wolkabout::SensorReading>>{} :
+                                std::vector<std::shared_ptr<wolkabout::SensorReading>>{
+                                  std::make_shared<wolkabout::SensorReading>("VALUE", "REF")};
+      }));
+
+    EXPECT_CALL(*persistence, removeSensorReadings(key, wolkabout::DataService::PUBLISH_BATCH_ITEMS_COUNT))
+      .Times(1)
+      .WillOnce(testing::Assign(&removeCalled, true));
+
+    EXPECT_CALL(*dataProtocol,
+                makeMessageProxy(deviceKey,
+                                 testing::Matcher<const std::vector<std::shared_ptr<wolkabout::SensorReading>>&>(
+                                   testing::_)))
+      .Times(1)
+      .WillOnce(testing::InvokeWithoutArgs([&] { return new wolkabout::Message("", ""); }));
+
+    // When
+    dataService->publishSensorReadings(deviceKey);
+
+    // Then
+    ASSERT_EQ(connectivityService->getMessages().size(), 1);
+}
+
+TEST_F(DataService, Given_BufferedReadings_When_OldestReadingIsDropped_Then_BufferedReadingsCountDecreases)
+{
+    // Given
+    const std::string key = "DEVICE_KEY+REF";
+
+    EXPECT_CALL(*persistence, putSensorReading(key, testing::_))
+      .Times(3)
+      .WillOnce(testing::Return(true))
+      .WillOnce(testing::Return(true))
+      .WillOnce(testing::Return(false));
+
+    dataService->addSensorReading("DEVICE_KEY", "REF", std::string{"1"}, 0);
+    dataService->addSensorReading("DEVICE_KEY", "REF", std::string{"2"}, 0);
+    dataService->addSensorReading("DEVICE_KEY", "REF", std::string{"3"}, 0);
+
+    ASSERT_EQ(dataService->getBufferedSensorReadingsCount(), 2);
+
+    EXPECT_CALL(*persistence, getSensorReadings(key, 1))
+      .WillOnce(testing::Return(std::vector<std::shared_ptr<wolkabout::SensorReading>>{
+        std::make_shared<wolkabout::SensorReading>("1", "REF")}));
+
+    EXPECT_CALL(*persistence, removeSensorReadings(key, 1)).Times(1);
+
+    // When
+    dataService->dropOldestSensorReading("DEVICE_KEY", "REF");
+
+    // Then
+    ASSERT_EQ(dataService->getBufferedSensorReadingsCount(), 1);
+}
+
+TEST_F(DataService,
+       Given_ActuatorStatusesAddedRepeatedly_When_PublishChangedActuatorStatusesIsCalled_Then_OnlyLatestArePublished)
+{
+    // Given
+    const auto status1 =
+      std::make_shared<wolkabout::ActuatorStatus>("2", "REF1", wolkabout::ActuatorStatus::State::READY);
+    const auto status2 =
+      std::make_shared<wolkabout::ActuatorStatus>("1", "REF", wolkabout::ActuatorStatus::State::READY);
+
+    EXPECT_CALL(*persistence, putActuatorStatus(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
+    EXPECT_CALL(*persistence, getActuatorStatusesKeys()).Times(0);
+
+    EXPECT_CALL(*persistence, getActuatorStatus("KEY1+REF1")).Times(1).WillOnce(testing::Return(status1));
+    EXPECT_CALL(*persistence, getActuatorStatus("KEY2+REF")).Times(1).WillOnce(testing::Return(status2));
+    EXPECT_CALL(*persistence, removeActuatorStatus("KEY1+REF1")).Times(1);
+    EXPECT_CALL(*persistence, removeActuatorStatus("KEY2+REF")).Times(1);
+
+    EXPECT_CALL(
+      *dataProtocol,
+      makeMessageProxy(testing::_,
+                       testing::Matcher<const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>>&>(testing::_)))
+      .Times(2)
+      .WillRepeatedly(testing::InvokeWithoutArgs([&] { return new wolkabout::Message("", ""); }));
+
+    dataService->addActuatorStatus("KEY1", "REF1", "0", wolkabout::ActuatorStatus::State::BUSY);
+    dataService->addActuatorStatus("KEY2", "REF", "1", wolkabout::ActuatorStatus::State::READY);
+    dataService->addActuatorStatus("KEY1", "REF1", "1", wolkabout::ActuatorStatus::State::BUSY);
+    dataService->addActuatorStatus("KEY1", "REF1", "2", wolkabout::ActuatorStatus::State::READY);
+
+    // When
+    dataService->publishChangedActuatorStatuses();
+    dataService->publishChangedActuatorStatuses();
+
+    // Then
+    ASSERT_EQ(connectivityService->getMessages().size(), 2);
+}
+
+TEST_F(DataService,
+       Given_PersistedStatusAndConfiguration_When_MarkedAsChanged_Then_TheyArePublishedOnceWithoutRescan)
+{
+    // Given
+    const auto status =
+      std::make_shared<wolkabout::ActuatorStatus>("1", "REF", wolkabout::ActuatorStatus::State::READY);
+    const auto configuration = std::make_shared<std::vector<wolkabout::ConfigurationItem>>();
+
+    EXPECT_CALL(*persistence, getActuatorStatusesKeys())
+      .Times(1)
+      .WillOnce(testing::Return(std::vector<std::string>{"KEY+REF"}));
+    EXPECT_CALL(*persistence, getConfigurationKeys())
+      .Times(1)
+      .WillOnce(testing::Return(std::vector<std::string>{"KEY"}));
+
+    EXPECT_CALL(*persistence, getActuatorStatus("KEY+REF")).Times(1).WillOnce(testing::Return(status));
+    EXPECT_CALL(*persistence, removeActuatorStatus("KEY+REF")).Times(1);
+    EXPECT_CALL(*persistence, getConfiguration("KEY")).Times(1).WillOnce(testing::Return(configuration));
+    EXPECT_CALL(*persistence, removeConfiguration("KEY")).Times(1);
+
+    EXPECT_CALL(
+      *dataProtocol,
+      makeMessageProxy(testing::_,
+                       testing::Matcher<const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>>&>(testing::_)))
+      .Times(1)
+      .WillOnce(testing::InvokeWithoutArgs([&] { return new wolkabout::Message("", ""); }));
+    EXPECT_CALL(
+      *dataProtocol,
+      makeMessageProxy(testing::_, testing::Matcher<const std::vector<wolkabout::ConfigurationItem>&>(testing::_)))
+      .Times(1)
+      .WillOnce(testing::InvokeWithoutArgs([&] { return new wolkabout::Message("", ""); }));
+
+    dataService->markPersistedChanged();
+
+    // When
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        dataService->publishChangedActuatorStatuses();
+        dataService->publishChangedConfigurations();
+    }
+
+    // Then
+    ASSERT_EQ(connectivityService->getMessages().size(), 2);
+}
+
+TEST_F(DataService,
+       Given_TracedActuatorStatuses_When_PublishChangedActuatorStatusesIsCalled_Then_OnlyPublishedTraceHasPublishSpan)
+{
+    // Given
+    auto sink = std::make_shared<wolkabout::InMemoryTraceSink>();
+    wolkabout::ActuationTracer tracer{sink};
+    dataService->setTracer(tracer);
+
+    const auto status =
+      std::make_shared<wolkabout::ActuatorStatus>("2", "REF", wolkabout::ActuatorStatus::State::READY);
+
+    EXPECT_CALL(*persistence, putActuatorStatus(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
+    EXPECT_CALL(*persistence, getActuatorStatus("KEY+REF")).Times(1).WillOnce(testing::Return(status));
+    EXPECT_CALL(*persistence, removeActuatorStatus("KEY+REF")).Times(1);
+
+    EXPECT_CALL(
+      *dataProtocol,
+      makeMessageProxy(testing::_,
+                       testing::Matcher<const std::vector<std::shared_ptr<wolkabout::ActuatorStatus>>&>(testing::_)))
+      .Times(1)
+      .WillOnce(testing::InvokeWithoutArgs([&] { return new wolkabout::Message("", ""); }));
+
+    dataService->addActuatorStatus("KEY", "REF", "1", wolkabout::ActuatorStatus::State::READY,
+                                   tracer.begin("KEY", "REF", "1"));
+    dataService->addActuatorStatus("KEY", "REF", "2", wolkabout::ActuatorStatus::State::READY,
+                                   tracer.begin("KEY", "REF", "2"));
+
+    // When
+    dataService->publishChangedActuatorStatuses();
+
+    // Then
+    const auto traces = sink->getTraces();
+    ASSERT_EQ(traces.size(), 2);
+
+    ASSERT_EQ(traces[0].value, "1");
+    ASSERT_TRUE(traces[0].spans.empty());
+
+    ASSERT_EQ(traces[1].value, "2");
+    ASSERT_EQ(traces[1].spans.size(), 1);
+    ASSERT_EQ(traces[1].spans[0].hop, wolkabout::TraceHop::PUBLISH);
+    ASSERT_LE(traces[1].spans[0].start, traces[1].spans[0].end);
+}
+
+TEST_F(DataService,
+       Given_EnvelopesAcrossDevices_When_PublishSensorReadingsIsCalled_Then_ReadingsOfManySensorsShareEnvelopes)
+{
+    // Given
+    EnvelopeProtocol envelopeProtocol;
+
+    wolkabout::DataService envelopeDataService(
+      *dataProtocol, *persistence, *connectivityService,
+      [](const std::string&, const std::string&, const std::string&, std::shared_ptr<wolkabout::ActuationTrace>) {},
+      [](const std::string&, const std::string&) {},
+      [](const std::string&, const std::vector<wolkabout::ConfigurationItem>&) {}, [](const std::string&) {}, 4);
+    envelopeDataService.setSensorReadingsEnvelopes(envelopeProtocol, true);
+
+    PersistedReadings readings;
+    readings.put("KEY1+REF1", "REF1", 3);
+    readings.put("KEY1+REF2", "REF2", 2);
+    readings.put("KEY2+REF1", "REF1", 2);
+    readings.expect(*persistence);
+
+    // When
+    envelopeDataService.publishSensorReadings();
+
+    // Then
+    ASSERT_TRUE(readings.empty());
+    ASSERT_EQ(connectivityService->getMessages().size(), 2);
+    ASSERT_EQ(envelopeProtocol.m_envelopes,
+              (std::vector<std::vector<std::string>>{{"KEY1:REF1x3", "KEY1:REF2x1"}, {"KEY1:REF2x1", "KEY2:REF1x2"}}));
+}
+
+TEST_F(DataService,
+       Given_EnvelopesPerDeviceWithMaxBytes_When_PublishSensorReadingsIsCalled_Then_EnvelopesAreShrunkToFit)
+{
+    // Given
+    EnvelopeProtocol envelopeProtocol;
+
+    wolkabout::DataService envelopeDataService(
+      *dataProtocol, *persistence, *connectivityService,
+      [](const std::string&, const std::string&, const std::string&, std::shared_ptr<wolkabout::ActuationTrace>) {},
+      [](const std::string&, const std::string&) {},
+      [](const std::string&, const std::vector<wolkabout::ConfigurationItem>&) {}, [](const std::string&) {}, 10,
+      30);
+    envelopeDataService.setSensorReadingsEnvelopes(envelopeProtocol, false);
+
+    PersistedReadings readings;
+    readings.put("KEY1+REF1", "REF1", 2);
+    readings.put("KEY1+REF2", "REF2", 2);
+    readings.put("KEY2+REF1", "REF1", 1);
+    readings.expect(*persistence);
+
+    // When
+    envelopeDataService.publishSensorReadings();
+
+    // Then
+    ASSERT_TRUE(readings.empty());
+    ASSERT_EQ(connectivityService->getMessages().size(), 3);
+    ASSERT_EQ(envelopeProtocol.m_envelopes, (std::vector<std::vector<std::string>>{{"KEY1:REF1x2", "KEY1:REF2x2"},
+                                                                                    {"KEY1:REF1x2"},
+                                                                                    {"KEY1:REF2x2"},
+                                                                                    {"KEY2:REF1x1"}}));
+}
+
+TEST_F(DataService, Given_MoreReadingsThanAreTimed_When_OldestReadingsAreDropped_Then_AllReadingsAreCountedInGauge)
+{
+    // Given
+    const std::string key = "DEVICE_KEY+REF";
+    const std::size_t readingsCount = wolkabout::DataService::TIMED_READINGS_PER_KEY + 2;
+
+    wolkabout::MetricsRegistry metrics;
+    dataService->setMetrics(metrics);
+
+    EXPECT_CALL(*persistence, putSensorReading(key, testing::_)).WillRepeatedly(testing::Return(true));
+    for (std::size_t i = 0; i < readingsCount; ++i)
+    {
+        dataService->addSensorReading("DEVICE_KEY", "REF", std::string{"1"}, 0);
+    }
+
+    ASSERT_EQ(dataService->m_persistedReadings.at(key).persistedAt.size(),
+              wolkabout::DataService::TIMED_READINGS_PER_KEY);
+
+    EXPECT_CALL(*persistence, getSensorReadings(key, 1))
+      .WillRepeatedly(testing::Return(std::vector<std::shared_ptr<wolkabout::SensorReading>>{
+        std::make_shared<wolkabout::SensorReading>("1", "REF")}));
+
+    EXPECT_CALL(*persistence, removeSensorReadings(key, 1)).Times(3);
+
+    // When
+    dataService->dropOldestSensorReading("DEVICE_KEY", "REF");
+    dataService->dropOldestSensorReading("DEVICE_KEY", "REF");
+    dataService->dropOldestSensorReading("DEVICE_KEY", "REF");
+
+    // Then
+    ASSERT_EQ(metrics.snapshot().gauges.at(wolkabout::DataService::bufferedReadingsGaugeName("DEVICE_KEY")),
+              static_cast<long long int>(readingsCount - 3));
+    ASSERT_EQ(dataService->m_persistedReadings.at(key).untimed, 0);
+    ASSERT_EQ(dataService->m_persistedReadings.at(key).persistedAt.size(),
+              wolkabout::DataService::TIMED_READINGS_PER_KEY - 1);
+}
+
+TEST_F(DataService,
+       Given_BufferedReadingsOfTwoDevices_When_ReadingsStateOfOneIsRemoved_Then_OnlyItsReadingsAreForgotten)
+{
+    // Given
+    wolkabout::MetricsRegistry metrics;
+    dataService->setMetrics(metrics);
+
+    EXPECT_CALL(*persistence, putSensorReading(testing::_, testing::_)).WillRepeatedly(testing::Return(true));
+    dataService->addSensorReading("DEVICE_KEY1", "REF", std::string{"1"}, 0);
+    dataService->addSensorReading("DEVICE_KEY2", "REF", std::string{"1"}, 0);
+
+    // When
+    dataService->removeReadingsState("DEVICE_KEY1");
+
+    // Then
+    ASSERT_EQ(dataService->m_persistedReadings.count("DEVICE_KEY1+REF"), 0);
+    ASSERT_EQ(dataService->m_persistedReadings.count("DEVICE_KEY2+REF"), 1);
+}
+
+TEST_F(DataService, Given_BufferedReadingsOfTwoDevices_When_ReadingsStateOfOneIsRemoved_Then_OnlyItsArenasAreErased)
+{
+    // Given
+    std::vector<std::shared_ptr<wolkabout::SensorReading>> buffered;
+    EXPECT_CALL(*persistence, putSensorReading(testing::_, testing::_))
+      .WillRepeatedly(testing::Invoke([&](const std::string&, std::shared_ptr<wolkabout::SensorReading> reading) {
+          buffered.push_back(reading);
+          return true;
+      }));
+
+    dataService->addSensorReading("DEVICE_KEY1", "REF1", std::string{"1"}, 0);
+    dataService->addSensorReading("DEVICE_KEY1", "REF2", std::string{"2"}, 0);
+    dataService->addSensorReading("DEVICE_KEY2", "REF1", std::string{"3"}, 0);
+
+    // When
+    dataService->removeReadingsState("DEVICE_KEY1");
+
+    // Then
+    ASSERT_EQ(dataService->m_readingArenas.size(), 1);
+    ASSERT_EQ(*dataService->m_sensorReadingsKeys.getDeviceKey(*dataService->m_readingArenas.begin()->first),
+              "DEVICE_KEY2");
+
+    // readings allocated from erased arenas stay valid until released
+    ASSERT_EQ(buffered.size(), 3);
+    ASSERT_EQ(buffered[0]->getValue(), "1");
+    ASSERT_EQ(buffered[1]->getValue(), "2");
+    buffered.clear();
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/DeviceAssetIndex.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+wolkabout::DeviceAssetIndex makeIndex()
+{
+    wolkabout::DeviceAssetIndex index;
+    index.addSensor("T");
+    index.addAlarm("HH");
+    index.addActuator("SW");
+    index.addActuator("SL");
+    index.addConfigurationItem("CFG");
+    return index;
+}
+}    // namespace
+
+TEST(DeviceAssetIndex, Given_AddedAssets_When_AssetsAreLookedUpByReference_Then_EachIsFoundUnderItsOwnKind)
+{
+    // Given
+    const auto index = makeIndex();
+
+    // When, Then
+    ASSERT_TRUE(index.hasSensor("T"));
+    ASSERT_TRUE(index.hasAlarm("HH"));
+    ASSERT_TRUE(index.hasActuator("SW"));
+    ASSERT_TRUE(index.hasActuator("SL"));
+    ASSERT_TRUE(index.hasConfigurationItem("CFG"));
+
+    ASSERT_FALSE(index.hasAlarm("T"));
+    ASSERT_FALSE(index.hasActuator("HH"));
+    ASSERT_FALSE(index.hasConfigurationItem("SW"));
+    ASSERT_FALSE(index.hasSensor("CFG"));
+}
+
+TEST(DeviceAssetIndex, Given_UnknownReferences_When_AssetsAreLookedUp_Then_NothingIsFound)
+{
+    // Given
+    const auto index = makeIndex();
+    const wolkabout::DeviceAssetIndex emptyIndex;
+
+    // When, Then
+    ASSERT_FALSE(index.hasSensor("P"));
+    ASSERT_FALSE(index.hasAlarm("LL"));
+    ASSERT_FALSE(index.hasActuator("sw"));
+    ASSERT_FALSE(index.hasConfigurationItem(""));
+
+    ASSERT_FALSE(emptyIndex.hasSensor("T"));
+    ASSERT_TRUE(emptyIndex.getActuatorReferences().empty());
+}
+
+TEST(DeviceAssetIndex, Given_ActuatorAddedTwice_When_ActuatorReferencesAreRequested_Then_TheyAreUniqueInAddedOrder)
+{
+    // Given
+    auto index = makeIndex();
+
+    // When
+    index.addActuator("SW");
+
+    // Then
+    ASSERT_EQ(index.getActuatorReferences(), (std::vector<std::string>{"SW", "SL"}));
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/ExponentialBackoff.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+TEST(ExponentialBackoff, Given_Backoff_When_NextIsCalledRepeatedly_Then_DelayDoublesUpToMaxWithJitter)
+{
+    // Given
+    wolkabout::ExponentialBackoff backoff{std::chrono::milliseconds{100}, std::chrono::milliseconds{1000}};
+
+    // When, Then
+    const long long int expectedDelays[] = {100, 200, 400, 800, 1000, 1000};
+    for (const auto expected : expectedDelays)
+    {
+        const auto delay = backoff.next().count();
+        ASSERT_GE(delay, expected / 2);
+        ASSERT_LE(delay, expected);
+    }
+}
+
+TEST(ExponentialBackoff, Given_BackoffAtMaxDelay_When_ResetIsCalled_Then_DelayStartsFromInitial)
+{
+    // Given
+    wolkabout::ExponentialBackoff backoff{std::chrono::milliseconds{100}, std::chrono::milliseconds{1000}};
+    for (int i = 0; i < 10; ++i)
+    {
+        backoff.next();
+    }
+
+    // When
+    backoff.reset();
+
+    // Then
+    ASSERT_LE(backoff.next().count(), 100);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "InboundGatewayMessageHandler.h"
+#include "core/model/Message.h"
+#include "core/protocol/Protocol.h"
+#include "utilities/CommandExecutor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+class ActuatorSetProtocol : public wolkabout::Protocol
+{
+public:
+    std::vector<std::string> getInboundChannels() const override { return {"p2d/actuator_set/d/+/r/+"}; }
+
+    std::vector<std::string> getInboundChannelsForDevice(const std::string& deviceKey) const override
+    {
+        return {"p2d/actuator_set/d/" + deviceKey + "/r/+"};
+    }
+
+    std::string extractDeviceKeyFromChannel(const std::string& /* topic */) const override { return ""; }
+};
+
+// waits in the first message until released, so that the following ones pile up in the queue
+class BlockingListener : public wolkabout::MessageListener
+{
+public:
+    explicit BlockingListener(std::shared_future<void> released) : m_released{std::move(released)}, m_received{0} {}
+
+    void messageReceived(std::shared_ptr<wolkabout::Message> /* message */) override
+    {
+        if (m_received++ == 0)
+        {
+            m_released.wait();
+        }
+    }
+
+    const wolkabout::Protocol& getProtocol() override { return m_protocol; }
+
+    std::size_t getReceived() const { return m_received; }
+
+private:
+    ActuatorSetProtocol m_protocol;
+    std::shared_future<void> m_released;
+    std::atomic<std::size_t> m_received;
+};
+}    // namespace
+
+TEST(InboundGatewayMessageHandler, Given_FullQueue_When_MessagesAreReceived_Then_CallbackThreadDoesNotWait)
+{
+    // Given
+    std::promise<void> release;
+    const auto listener = std::make_shared<BlockingListener>(release.get_future().share());
+
+    wolkabout::InboundGatewayMessageHandler handler;
+    handler.addListener(listener);
+
+    const std::size_t messagesCount = 2 * wolkabout::CommandExecutor::DEFAULT_CAPACITY + 1;
+
+    // When
+    auto received = std::async(std::launch::async, [&] {
+        for (std::size_t i = 0; i < messagesCount; ++i)
+        {
+            handler.messageReceived("p2d/actuator_set/d/DEVICE_KEY/r/SW", "{\"value\":\"true\"}");
+        }
+    });
+
+    const auto callbackStatus = received.wait_for(std::chrono::seconds{10});
+    release.set_value();
+    received.wait();
+
+    // Then
+    ASSERT_EQ(callbackStatus, std::future_status::ready);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (listener->getReceived() != messagesCount && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    ASSERT_EQ(listener->getReceived(), messagesCount);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/model/ActuatorSetCommand.h"
+#include "core/model/Alarm.h"
+#include "core/model/Message.h"
+#include "core/model/SensorReading.h"
+#include "protocol/msgpack/MessagePackProtocol.h"
+#include "protocol/msgpack/MessagePackReader.h"
+#include "protocol/msgpack/MessagePackWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST(MessagePackProtocol, Given_EncodedValues_When_ValuesAreRead_Then_TheyMatchWrittenValues)
+{
+    // Given
+    const std::string longString(300, 'x');
+
+    wolkabout::MessagePackWriter writer;
+    writer.writeMapHeader(2);
+    writer.writeString("short").writeString("value");
+    writer.writeString("long").writeArrayHeader(3).writeString(longString).writeUnsigned(70000).writeBool(true);
+
+    // When
+    wolkabout::MessagePackReader reader{writer.getBuffer()};
+
+    std::uint32_t mapSize = 0;
+    std::string key;
+    std::string shortValue;
+    std::uint32_t arraySize = 0;
+    std::string longValue;
+
+    // Then
+    ASSERT_TRUE(reader.readMapHeader(mapSize));
+    ASSERT_EQ(mapSize, 2);
+
+    ASSERT_TRUE(reader.readString(key));
+    ASSERT_EQ(key, "short");
+    ASSERT_TRUE(reader.readString(shortValue));
+    ASSERT_EQ(shortValue, "value");
+
+    ASSERT_TRUE(reader.readString(key));
+    ASSERT_EQ(key, "long");
+    ASSERT_TRUE(reader.readArrayHeader(arraySize));
+    ASSERT_EQ(arraySize, 3);
+    ASSERT_TRUE(reader.readString(longValue));
+    ASSERT_EQ(longValue, longString);
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.atEnd());
+}
+
+TEST(MessagePackProtocol, Given_SensorReadings_When_MessageIsMade_Then_ReadingsAreEncodedAsMessagePack)
+{
+    // Given
+    wolkabout::MessagePackProtocol protocol;
+
+    const std::vector<std::shared_ptr<wolkabout::SensorReading>> readings = {
+      std::make_shared<wolkabout::SensorReading>("25", "T", 1000),
+      std::make_shared<wolkabout::SensorReading>(std::vector<std::string>{"1", "2"}, "T", 2000)};
+
+    // When
+    const auto message = protocol.makeMessage("DEVICE_KEY", readings);
+
+    // Then
+    ASSERT_NE(message, nullptr);
+    ASSERT_EQ(message->getChannel(), "d2p/sensor_reading/d/DEVICE_KEY/r/T");
+
+    wolkabout::MessagePackReader reader{message->getContent()};
+
+    std::uint32_t size = 0;
+    ASSERT_TRUE(reader.readArrayHeader(size));
+    ASSERT_EQ(size, 2);
+
+    std::string key;
+    std::string value;
+
+    ASSERT_TRUE(reader.readMapHeader(size));
+    ASSERT_EQ(size, 2);
+    ASSERT_TRUE(reader.readString(key));
+    ASSERT_EQ(key, "utc");
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.readString(key));
+    ASSERT_EQ(key, "data");
+    ASSERT_TRUE(reader.readString(value));
+    ASSERT_EQ(value, "25");
+
+    ASSERT_TRUE(reader.readMapHeader(size));
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.readString(key));
+    ASSERT_EQ(key, "data");
+    ASSERT_TRUE(reader.nextIsArray());
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.atEnd());
+}
+
+TEST(MessagePackProtocol, Given_GroupsOfTwoDevices_When_EnvelopeIsMade_Then_ReadingsAreNestedUnderDeviceAndReference)
+{
+    // Given
+    wolkabout::MessagePackProtocol protocol;
+
+    const std::vector<wolkabout::SensorReadingsGroup> groups = {
+      {"KEY1", {std::make_shared<wolkabout::SensorReading>("25", "T", 1000)}},
+      {"KEY2", {std::make_shared<wolkabout::SensorReading>("1", "P", 2000)}},
+      {"KEY1", {std::make_shared<wolkabout::SensorReading>("60", "H")}}};
+
+    // When
+    const auto message = protocol.makeEnvelope(groups);
+    const auto deviceMessage = protocol.makeEnvelope({groups[0]});
+
+    // Then
+    ASSERT_NE(message, nullptr);
+    ASSERT_EQ(message->getChannel(), "d2p/sensor_reading_envelope");
+    ASSERT_EQ(deviceMessage->getChannel(), "d2p/sensor_reading_envelope/d/KEY1");
+
+    wolkabout::MessagePackReader reader{message->getContent()};
+
+    std::uint32_t size = 0;
+    std::string value;
+
+    ASSERT_TRUE(reader.readMapHeader(size));
+    ASSERT_EQ(size, 2);
+
+    ASSERT_TRUE(reader.readString(value));
+    ASSERT_EQ(value, "KEY1");
+    ASSERT_TRUE(reader.readMapHeader(size));
+    ASSERT_EQ(size, 2);
+    ASSERT_TRUE(reader.readString(value));
+    ASSERT_EQ(value, "T");
+    ASSERT_TRUE(reader.readArrayHeader(size));
+    ASSERT_EQ(size, 1);
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.readString(value));
+    ASSERT_EQ(value, "H");
+    ASSERT_TRUE(reader.skip());
+
+    ASSERT_TRUE(reader.readString(value));
+    ASSERT_EQ(value, "KEY2");
+    ASSERT_TRUE(reader.readMapHeader(size));
+    ASSERT_EQ(size, 1);
+    ASSERT_TRUE(reader.readString(value));
+    ASSERT_EQ(value, "P");
+    ASSERT_TRUE(reader.skip());
+    ASSERT_TRUE(reader.atEnd());
+}
+
+TEST(MessagePackProtocol, Given_DeeplyNestedArrays_When_ValueIsSkipped_Then_WholeValueIsSkipped)
+{
+    // Given
+    const std::size_t depth = 1000000;
+
+    std::string nested(depth, '\x91');
+    nested += '\xc0';
+
+    const std::string truncated(depth, '\x91');
+
+    // When
+    wolkabout::MessagePackReader reader{nested};
+    const bool skipped = reader.skip();
+
+    wolkabout::MessagePackReader truncatedReader{truncated};
+    const bool truncatedSkipped = truncatedReader.skip();
+
+    // Then
+    ASSERT_TRUE(skipped);
+    ASSERT_TRUE(reader.atEnd());
+    ASSERT_FALSE(truncatedSkipped);
+}
+
+TEST(MessagePackProtocol, Given_DeeplyNestedUnknownField_When_ActuatorSetCommandIsMade_Then_ValueIsRead)
+{
+    // Given
+    wolkabout::MessagePackWriter writer;
+    writer.writeMapHeader(2);
+    writer.writeString("nested");
+
+    std::string payload = writer.getBuffer();
+    payload += std::string(1000000, '\x91');
+    payload += '\xc0';
+
+    wolkabout::MessagePackWriter valueWriter;
+    valueWriter.writeString("value").writeString("true");
+    payload += valueWriter.getBuffer();
+
+    const wolkabout::MessagePackProtocol protocol;
+
+    // When
+    const auto command =
+      protocol.makeActuatorSetCommand(wolkabout::Message(payload, "p2d/actuator_set/d/DEVICE_KEY/r/SW"));
+
+    // Then
+    ASSERT_NE(command, nullptr);
+    ASSERT_EQ(command->getValue(), "true");
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/Metrics.h"
+#include "utilities/MetricsRegistry.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(LatencyHistogram, Given_UniformLatencies_When_SnapshotIsTaken_Then_PercentilesAreWithinBucketPrecision)
+{
+    // Given
+    wolkabout::LatencyHistogram histogram;
+
+    // When
+    for (int i = 1; i <= 1000; ++i)
+    {
+        histogram.record(std::chrono::microseconds{i});
+    }
+
+    // Then
+    const auto snapshot = histogram.snapshot();
+    ASSERT_EQ(snapshot.count, 1000);
+    ASSERT_EQ(snapshot.min, 1);
+    ASSERT_EQ(snapshot.max, 1000);
+    ASSERT_DOUBLE_EQ(snapshot.mean, 500.5);
+
+    ASSERT_GE(snapshot.p50, 500);
+    ASSERT_LE(snapshot.p50, 500 + 500 / 16);
+    ASSERT_GE(snapshot.p99, 990);
+    ASSERT_LE(snapshot.p99, 1000);
+    ASSERT_EQ(snapshot.p999, 1000);
+}
+
+TEST(LatencyHistogram, Given_NoLatencies_When_SnapshotIsTaken_Then_SnapshotIsEmpty)
+{
+    // Given
+    wolkabout::LatencyHistogram histogram;
+
+    // When
+    const auto snapshot = histogram.snapshot();
+
+    // Then
+    ASSERT_EQ(snapshot.count, 0);
+    ASSERT_EQ(snapshot.min, 0);
+    ASSERT_EQ(snapshot.max, 0);
+    ASSERT_EQ(snapshot.p999, 0);
+}
+
+TEST(MetricsRegistry, Given_MetricsUpdatedFromManyThreads_When_SnapshotIsTaken_Then_AllUpdatesAreCounted)
+{
+    // Given
+    wolkabout::MetricsRegistry registry;
+    auto& counter = registry.counter("counter");
+    auto& gauge = registry.gauge("gauge");
+
+    // When
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 10000; ++j)
+            {
+                counter.increment();
+                gauge.add(2);
+                registry.histogram("histogram").record(std::chrono::microseconds{j});
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Then
+    const auto snapshot = registry.snapshot();
+    ASSERT_EQ(snapshot.counters.at("counter"), 40000);
+    ASSERT_EQ(snapshot.gauges.at("gauge"), 80000);
+    ASSERT_EQ(snapshot.histograms.at("histogram").count, 40000);
+    ASSERT_EQ(&registry.counter("counter"), &counter);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/PersistenceKeyIndex.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+TEST(PersistenceKeyIndex, Given_DeviceKeyAndReference_When_KeyIsCreated_Then_ItResolvesToDeviceKey)
+{
+    // Given
+    wolkabout::PersistenceKeyIndex index{"+"};
+
+    // When
+    const auto& key = index.getKey("DEVICE_KEY", "REF");
+
+    // Then
+    ASSERT_EQ(key, "DEVICE_KEY+REF");
+    ASSERT_EQ(&index.getKey("DEVICE_KEY", "REF"), &key);
+    ASSERT_NE(index.getDeviceKey(key), nullptr);
+    ASSERT_EQ(*index.getDeviceKey(key), "DEVICE_KEY");
+    ASSERT_EQ(index.findKey(key), &key);
+    ASSERT_EQ(index.getKeys("DEVICE_KEY"), std::vector<std::string>{key});
+}
+
+TEST(PersistenceKeyIndex, Given_PairsThatJoinToSameString_When_KeysAreCreated_Then_KeysDiffer)
+{
+    // Given
+    wolkabout::PersistenceKeyIndex index{"+"};
+
+    // When
+    const auto& firstKey = index.getKey("a+b", "c");
+    const auto& secondKey = index.getKey("a", "b+c");
+    const auto& thirdKey = index.getKey("a\\", "+c");
+
+    // Then
+    ASSERT_NE(firstKey, secondKey);
+    ASSERT_NE(firstKey, thirdKey);
+    ASSERT_NE(secondKey, thirdKey);
+
+    ASSERT_EQ(*index.getDeviceKey(firstKey), "a+b");
+    ASSERT_EQ(*index.getDeviceKey(secondKey), "a");
+    ASSERT_EQ(*index.getDeviceKey(thirdKey), "a\\");
+    ASSERT_EQ(index.getKeys("a+b"), std::vector<std::string>{firstKey});
+    ASSERT_EQ(index.getKeys("a"), std::vector<std::string>{secondKey});
+}
+
+TEST(PersistenceKeyIndex, Given_KeysFoundInPersistence_When_KeysAreAdded_Then_TheyResolveToSameDevicesAsBefore)
+{
+    // Given
+    std::vector<std::string> persistedKeys;
+    {
+        wolkabout::PersistenceKeyIndex index{"+"};
+        persistedKeys = {index.getKey("a+b", "c"), index.getKey("a", "b+c"), index.getKey("a\\", "+c")};
+    }
+
+    wolkabout::PersistenceKeyIndex index{"+"};
+
+    // When
+    for (const auto& key : persistedKeys)
+    {
+        ASSERT_TRUE(index.addKey(key));
+    }
+
+    // Then
+    ASSERT_EQ(*index.getDeviceKey(persistedKeys[0]), "a+b");
+    ASSERT_EQ(*index.getDeviceKey(persistedKeys[1]), "a");
+    ASSERT_EQ(*index.getDeviceKey(persistedKeys[2]), "a\\");
+
+    ASSERT_EQ(&index.getKey("a+b", "c"), index.findKey(persistedKeys[0]));
+    ASSERT_EQ(&index.getKey("a", "b+c"), index.findKey(persistedKeys[1]));
+    ASSERT_EQ(&index.getKey("a\\", "+c"), index.findKey(persistedKeys[2]));
+}
+
+TEST(PersistenceKeyIndex, Given_KeyOfDeviceAsset_When_OtherKeyOfSameAssetIsAdded_Then_ItIsRejected)
+{
+    // Given
+    wolkabout::PersistenceKeyIndex index{"+"};
+    const auto& key = index.getKey("a", "b+c");
+
+    // When
+    // key of an earlier version, before delimiter was escaped, splits into the same device and reference
+    const bool added = index.addKey("a+b+c");
+
+    // Then
+    ASSERT_FALSE(added);
+    ASSERT_EQ(index.getDeviceKey("a+b+c"), nullptr);
+    ASSERT_EQ(index.getKeys("a"), std::vector<std::string>{key});
+}
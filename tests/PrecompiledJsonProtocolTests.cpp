@@ -0,0 +1,112 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/model/Message.h"
+#include "core/model/SensorReading.h"
+#include "core/protocol/json/JsonProtocol.h"
+#include "protocol/json/PrecompiledJsonProtocol.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::string DEVICE_KEY = "DEVICE_KEY";
+
+// makes sensor readings message with both protocols, which must be byte for byte the same
+void assertSameAsJsonProtocol(const std::vector<std::shared_ptr<wolkabout::SensorReading>>& readings)
+{
+    wolkabout::PrecompiledJsonProtocol protocol;
+    protocol.addSensors(DEVICE_KEY, {readings.front()->getReference()});
+
+    const wolkabout::JsonProtocol jsonProtocol;
+
+    const auto message = protocol.makeMessage(DEVICE_KEY, readings);
+    const auto jsonMessage = jsonProtocol.makeMessage(DEVICE_KEY, readings);
+
+    ASSERT_NE(message, nullptr);
+    ASSERT_NE(jsonMessage, nullptr);
+    ASSERT_EQ(message->getChannel(), jsonMessage->getChannel());
+    ASSERT_EQ(message->getContent(), jsonMessage->getContent());
+}
+}    // namespace
+
+TEST(PrecompiledJsonProtocol, Given_AddedSensor_When_SensorReadingsMessageIsMade_Then_ReadingsAreWrittenInJsonArray)
+{
+    // Given
+    wolkabout::PrecompiledJsonProtocol protocol;
+    protocol.addSensors("DEVICE_KEY", {"T", "P"});
+
+    const std::vector<std::shared_ptr<wolkabout::SensorReading>> readings = {
+      std::make_shared<wolkabout::SensorReading>("23.4", "T", 1546300800000),
+      std::make_shared<wolkabout::SensorReading>("-1e-05", "T")};
+
+    // When
+    const auto message = protocol.makeMessage("DEVICE_KEY", readings);
+
+    // Then
+    ASSERT_NE(message, nullptr);
+    ASSERT_EQ(message->getChannel(), "d2p/sensor_reading/d/DEVICE_KEY/r/T");
+    ASSERT_EQ(message->getContent(), R"([{"data":"23.4","utc":1546300800000},{"data":"-1e-05"}])");
+}
+
+TEST(PrecompiledJsonProtocol, Given_StringReading_When_SensorReadingsMessageIsMade_Then_ValueIsEscaped)
+{
+    // Given
+    wolkabout::PrecompiledJsonProtocol protocol;
+    protocol.addSensors("DEVICE_KEY", {"MSG"});
+
+    const std::vector<std::shared_ptr<wolkabout::SensorReading>> readings = {
+      std::make_shared<wolkabout::SensorReading>("say \"hi\"\\\n\x01", "MSG", 1)};
+
+    // When
+    const auto message = protocol.makeMessage("DEVICE_KEY", readings);
+
+    // Then
+    ASSERT_NE(message, nullptr);
+    ASSERT_EQ(message->getContent(), R"([{"data":"say \"hi\"\\\n\u0001","utc":1}])");
+}
+
+TEST(PrecompiledJsonProtocol, Given_SingleReading_When_SensorReadingsMessageIsMade_Then_ItMatchesJsonProtocol)
+{
+    assertSameAsJsonProtocol({std::make_shared<wolkabout::SensorReading>("23.4", "T", 1546300800000)});
+}
+
+TEST(PrecompiledJsonProtocol, Given_ReadingsWithoutRtc_When_SensorReadingsMessageIsMade_Then_ItMatchesJsonProtocol)
+{
+    assertSameAsJsonProtocol({std::make_shared<wolkabout::SensorReading>("-1e-05", "T"),
+                              std::make_shared<wolkabout::SensorReading>("0", "T", 1),
+                              std::make_shared<wolkabout::SensorReading>("1", "T", 0)});
+}
+
+TEST(PrecompiledJsonProtocol, Given_MultiValueReadings_When_SensorReadingsMessageIsMade_Then_ItMatchesJsonProtocol)
+{
+    assertSameAsJsonProtocol(
+      {std::make_shared<wolkabout::SensorReading>(std::vector<std::string>{"1.5", "-2", "3e+10"}, "ACL", 1),
+       std::make_shared<wolkabout::SensorReading>(std::vector<std::string>{"0", "0", "0"}, "ACL")});
+}
+
+TEST(PrecompiledJsonProtocol, Given_EscapedStrings_When_SensorReadingsMessageIsMade_Then_ItMatchesJsonProtocol)
+{
+    assertSameAsJsonProtocol(
+      {std::make_shared<wolkabout::SensorReading>("say \"hi\"\\", "MSG", 1),
+       std::make_shared<wolkabout::SensorReading>("\b\f\n\r\t", "MSG", 2),
+       std::make_shared<wolkabout::SensorReading>(std::string{"\x01\x1f\0", 3}, "MSG", 3),
+       std::make_shared<wolkabout::SensorReading>("/ \xc5\xbe", "MSG")});
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/ReadingAggregation.h"
+#include "model/ReadingValue.h"
+#include "service/ReadingAggregator.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+class ReadingAggregator : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        aggregator.reset(new wolkabout::ReadingAggregator(
+          [this](const std::string& deviceKey, const std::string& reference,
+                 const wolkabout::ReadingAggregation& /* aggregation */,
+                 const wolkabout::ReadingAggregator::Window& window) {
+              closedWindows.push_back(window);
+              closedWindowsReferences.push_back(deviceKey + "+" + reference);
+          }));
+    }
+
+    bool add(const wolkabout::ReadingValue& value, unsigned long long int rtc)
+    {
+        return aggregator->add("KEY", "REF", &value, 1, rtc);
+    }
+
+    std::unique_ptr<wolkabout::ReadingAggregator> aggregator;
+
+    std::vector<wolkabout::ReadingAggregator::Window> closedWindows;
+    std::vector<std::string> closedWindowsReferences;
+};
+}    // namespace
+
+TEST_F(ReadingAggregator, Given_TumblingWindow_When_ReadingAfterWindowEndIsAdded_Then_WindowIsClosedWithStatistics)
+{
+    // Given
+    aggregator->setAggregation("REF", wolkabout::ReadingAggregation{std::chrono::milliseconds{1000}});
+
+    ASSERT_TRUE(add(3, 1000));
+    ASSERT_TRUE(add(1, 1200));
+    ASSERT_TRUE(add(8, 1999));
+    ASSERT_TRUE(closedWindows.empty());
+
+    // When
+    ASSERT_TRUE(add(5, 2000));
+
+    // Then
+    ASSERT_EQ(closedWindows.size(), 1);
+    ASSERT_EQ(closedWindowsReferences[0], "KEY+REF");
+
+    const auto& window = closedWindows[0];
+    ASSERT_EQ(window.start, 1000);
+    ASSERT_EQ(window.end, 2000);
+    ASSERT_EQ(window.count, 3);
+    ASSERT_EQ(window.components.size(), 1);
+    ASSERT_DOUBLE_EQ(window.components[0].min, 1);
+    ASSERT_DOUBLE_EQ(window.components[0].max, 8);
+    ASSERT_DOUBLE_EQ(window.components[0].sum, 12);
+    ASSERT_DOUBLE_EQ(window.components[0].last, 8);
+}
+
+TEST_F(ReadingAggregator, Given_SlidingWindow_When_WindowsAreClosed_Then_EachReadingIsInWindowPerHop)
+{
+    // Given
+    aggregator->setAggregation("REF", wolkabout::ReadingAggregation{std::chrono::milliseconds{1000},
+                                                                    std::chrono::milliseconds{500}});
+
+    ASSERT_TRUE(add(1, 1100));
+    ASSERT_TRUE(add(2, 1600));
+
+    // When
+    aggregator->closeWindows(3000);
+
+    // Then
+    ASSERT_EQ(closedWindows.size(), 3);
+
+    ASSERT_EQ(closedWindows[0].start, 500);
+    ASSERT_EQ(closedWindows[0].count, 1);
+
+    ASSERT_EQ(closedWindows[1].start, 1000);
+    ASSERT_EQ(closedWindows[1].count, 2);
+    ASSERT_DOUBLE_EQ(closedWindows[1].components[0].sum, 3);
+
+    ASSERT_EQ(closedWindows[2].start, 1500);
+    ASSERT_EQ(closedWindows[2].count, 1);
+}
+
+TEST_F(ReadingAggregator, Given_AggregatedReference_When_NonNumericOrLateReadingIsAdded_Then_ItIsNotAggregated)
+{
+    // Given
+    aggregator->setAggregation("REF", wolkabout::ReadingAggregation{std::chrono::milliseconds{1000}});
+    ASSERT_TRUE(add(1, 5000));
+
+    // When, Then
+    ASSERT_FALSE(add("TEXT", 5100));
+    ASSERT_FALSE(aggregator->add("KEY", "OTHER_REF", nullptr, 0, 5100));
+
+    ASSERT_TRUE(add(2, 6000));
+    ASSERT_TRUE(add(100, 5500));
+
+    aggregator->closeWindows(7000);
+    ASSERT_EQ(closedWindows.size(), 2);
+    ASSERT_EQ(closedWindows[0].count, 1);
+    ASSERT_EQ(closedWindows[1].count, 1);
+    ASSERT_DOUBLE_EQ(closedWindows[1].components[0].max, 2);
+}
+
+TEST_F(ReadingAggregator, Given_WindowThatIsNotMultipleOfHop_When_AggregationIsSet_Then_ExceptionIsThrown)
+{
+    ASSERT_THROW(aggregator->setAggregation("REF", wolkabout::ReadingAggregation{std::chrono::milliseconds{1000},
+                                                                                 std::chrono::milliseconds{300}}),
+                 std::logic_error);
+}
+
+TEST_F(ReadingAggregator, Given_ClosedWindow_When_LateReadingForItIsAdded_Then_WindowIsNotReopened)
+{
+    // Given
+    aggregator->setAggregation("REF", wolkabout::ReadingAggregation{std::chrono::milliseconds{1000}});
+    ASSERT_TRUE(add(1, 1500));
+    aggregator->closeWindows(3500);
+    ASSERT_EQ(closedWindows.size(), 1);
+
+    // When
+    ASSERT_TRUE(add(2, 1600));
+    ASSERT_TRUE(add(3, 2500));
+    aggregator->closeWindows(10000);
+
+    // Then
+    ASSERT_EQ(closedWindows.size(), 1);
+    ASSERT_EQ(closedWindows[0].start, 1000);
+}
+
+TEST_F(ReadingAggregator, Given_IdleSensor_When_IdleWindowsAreClosed_Then_ReadingTimeAdvancesByElapsedLocalTime)
+{
+    // Given
+    aggregator->setAggregation("REF", wolkabout::ReadingAggregation{std::chrono::milliseconds{1000}});
+
+    // device clock is far behind local one
+    ASSERT_TRUE(add(1, 1500));
+    aggregator->closeIdleWindows(1000000);
+    ASSERT_TRUE(add(2, 1700));
+
+    // When
+    aggregator->closeIdleWindows(1000100);
+    aggregator->closeIdleWindows(1000200);
+    ASSERT_TRUE(closedWindows.empty());
+
+    aggregator->closeIdleWindows(1000400);
+
+    // Then
+    ASSERT_EQ(closedWindows.size(), 1);
+    ASSERT_EQ(closedWindows[0].count, 2);
+}
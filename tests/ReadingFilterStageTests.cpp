@@ -0,0 +1,120 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/ReadingFilter.h"
+#include "model/ReadingValue.h"
+#include "service/ReadingFilterStage.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+namespace
+{
+bool accept(wolkabout::ReadingFilterStage& stage, const wolkabout::ReadingValue& value, unsigned long long int rtc)
+{
+    return stage.accept("KEY", "REF", &value, 1, rtc);
+}
+}    // namespace
+
+TEST(ReadingFilterStage, Given_AbsoluteDeadband_When_ReadingsAreAdded_Then_OnlyReadingsOutsideDeadbandAreAccepted)
+{
+    // Given
+    wolkabout::ReadingFilterStage stage;
+    stage.setFilter("REF", wolkabout::ReadingFilter().absoluteDeadband(0.5));
+
+    // When, Then
+    ASSERT_TRUE(accept(stage, 10.0, 1000));
+    ASSERT_FALSE(accept(stage, 10.4, 2000));
+    ASSERT_FALSE(accept(stage, 9.6, 3000));
+    ASSERT_TRUE(accept(stage, 10.6, 4000));
+    ASSERT_FALSE(accept(stage, 10.9, 5000));
+}
+
+TEST(ReadingFilterStage, Given_PercentageDeadband_When_ReadingsAreAdded_Then_DeadbandIsRelativeToLastReportedValue)
+{
+    // Given
+    wolkabout::ReadingFilterStage stage;
+    stage.setFilter("REF", wolkabout::ReadingFilter().percentageDeadband(10));
+
+    // When, Then
+    ASSERT_TRUE(accept(stage, 200, 1000));
+    ASSERT_FALSE(accept(stage, 219, 2000));
+    ASSERT_TRUE(accept(stage, 221, 3000));
+    ASSERT_FALSE(accept(stage, 200, 4000));
+}
+
+TEST(ReadingFilterStage, Given_OnChangeWithHeartbeat_When_ValueDoesNotChange_Then_ReadingIsAcceptedAfterMaxSilence)
+{
+    // Given
+    wolkabout::ReadingFilterStage stage;
+    stage.setFilter("REF", wolkabout::ReadingFilter().onChange().heartbeat(std::chrono::milliseconds{60000}));
+
+    // When, Then
+    ASSERT_TRUE(accept(stage, "ON", 1000));
+    ASSERT_FALSE(accept(stage, "ON", 30000));
+    ASSERT_TRUE(accept(stage, "OFF", 40000));
+    ASSERT_FALSE(accept(stage, "OFF", 99999));
+    ASSERT_TRUE(accept(stage, "OFF", 100000));
+}
+
+TEST(ReadingFilterStage, Given_MinInterval_When_ReadingsComeTooSoon_Then_TheyAreDiscarded)
+{
+    // Given
+    wolkabout::ReadingFilterStage stage;
+    stage.setFilter("REF", wolkabout::ReadingFilter().minInterval(std::chrono::milliseconds{100}));
+
+    // When, Then
+    ASSERT_TRUE(accept(stage, 1, 1000));
+    ASSERT_FALSE(accept(stage, 2, 1050));
+    ASSERT_TRUE(accept(stage, 3, 1100));
+}
+
+TEST(ReadingFilterStage, Given_FilteredReference_When_ReadingsOfDifferentDevicesAreAdded_Then_TheyAreFilteredSeparately)
+{
+    // Given
+    wolkabout::ReadingFilterStage stage;
+    stage.setFilter("REF", wolkabout::ReadingFilter().onChange());
+
+    const std::vector<wolkabout::ReadingValue> values{1, 2};
+    ASSERT_TRUE(stage.accept("KEY1", "REF", values.data(), values.size(), 1000));
+
+    // When, Then
+    ASSERT_TRUE(stage.accept("KEY2", "REF", values.data(), values.size(), 1000));
+    ASSERT_FALSE(stage.accept("KEY1", "REF", values.data(), values.size(), 2000));
+    ASSERT_FALSE(stage.filters("OTHER_REF"));
+
+    stage.removeDevice("KEY1");
+    ASSERT_TRUE(stage.accept("KEY1", "REF", values.data(), values.size(), 3000));
+}
+
+TEST(ReadingFilterStage, Given_OutOfOrderReading_When_ItIsAdded_Then_ItIsAcceptedWithoutReplacingLastReported)
+{
+    // Given
+    wolkabout::ReadingFilterStage stage;
+    stage.setFilter("REF",
+                    wolkabout::ReadingFilter().absoluteDeadband(0.5).minInterval(std::chrono::milliseconds{100}));
+    ASSERT_TRUE(accept(stage, 10.0, 5000));
+
+    // When
+    const auto backfilled = accept(stage, 20.0, 1000);
+
+    // Then
+    ASSERT_TRUE(backfilled);
+    ASSERT_FALSE(accept(stage, 10.2, 5200));
+    ASSERT_TRUE(accept(stage, 10.6, 5300));
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "model/ReadingValue.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST(ReadingValue, Given_StringValue_When_ValueIsCopiedAndMoved_Then_EachHolderKeepsItsOwnString)
+{
+    // Given
+    wolkabout::ReadingValue value{std::string("ON")};
+
+    // When
+    wolkabout::ReadingValue copy{value};
+    wolkabout::ReadingValue moved{std::move(value)};
+
+    wolkabout::ReadingValue assigned{1.5};
+    assigned = copy;
+    copy = wolkabout::ReadingValue{"OFF"};
+
+    // Then
+    ASSERT_EQ(moved.getType(), wolkabout::ReadingValue::Type::STRING);
+    ASSERT_EQ(moved.toString(), "ON");
+    ASSERT_EQ(assigned.toString(), "ON");
+    ASSERT_EQ(copy.toString(), "OFF");
+
+    std::vector<wolkabout::ReadingValue> values{"A", 2, true};
+    values.push_back("B");
+    ASSERT_EQ(values[0].toString(), "A");
+    ASSERT_EQ(values[3].toString(), "B");
+}
+
+TEST(ReadingValue, Given_DefaultConstructedValue_When_ValueIsInspected_Then_ItHasNoValue)
+{
+    // Given
+    const wolkabout::ReadingValue value;
+
+    // When, Then
+    ASSERT_EQ(value.getType(), wolkabout::ReadingValue::Type::NONE);
+    ASSERT_FALSE(value.isNumeric());
+    ASSERT_EQ(value.toString(), "");
+    ASSERT_DOUBLE_EQ(value.toDouble(), 0.0);
+}
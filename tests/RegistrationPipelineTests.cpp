@@ -0,0 +1,124 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "service/RegistrationPipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+class RegistrationPipeline : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        pipeline.reset(new wolkabout::RegistrationPipeline([this] { ++subscriptions; },
+                                                           [this](const std::string& deviceKey) {
+                                                               if (removed.count(deviceKey) != 0)
+                                                               {
+                                                                   return false;
+                                                               }
+
+                                                               published.push_back(deviceKey);
+                                                               return true;
+                                                           }));
+        pipeline->setLimits(2, std::chrono::milliseconds{1000});
+    }
+
+    std::unique_ptr<wolkabout::RegistrationPipeline> pipeline;
+
+    int subscriptions = 0;
+    std::vector<std::string> published;
+    std::set<std::string> removed;
+};
+}    // namespace
+
+TEST_F(RegistrationPipeline, Given_InFlightLimit_When_ManyDevicesAreAdded_Then_TheyAreSubscribedOnceAndLimitIsPublished)
+{
+    // When
+    pipeline->add({"D1", "D2", "D3", "D4", "D5"});
+
+    // Then
+    ASSERT_EQ(subscriptions, 1);
+    ASSERT_EQ(published, (std::vector<std::string>{"D1", "D2"}));
+    ASSERT_EQ(pipeline->inFlight(), 2);
+    ASSERT_EQ(pipeline->pending(), 3);
+}
+
+TEST_F(RegistrationPipeline, Given_FullPipeline_When_ResponsesArrive_Then_PendingRequestsArePublished)
+{
+    // Given
+    pipeline->add({"D1", "D2", "D3", "D4"});
+
+    // When
+    pipeline->responseReceived("D2");
+    pipeline->responseReceived("UNKNOWN");
+
+    // Then
+    ASSERT_EQ(published, (std::vector<std::string>{"D1", "D2", "D3"}));
+    ASSERT_EQ(pipeline->inFlight(), 2);
+
+    pipeline->responseReceived("D1");
+    pipeline->responseReceived("D3");
+    pipeline->responseReceived("D4");
+
+    ASSERT_EQ(published, (std::vector<std::string>{"D1", "D2", "D3", "D4"}));
+    ASSERT_EQ(pipeline->inFlight(), 0);
+    ASSERT_EQ(pipeline->pending(), 0);
+    ASSERT_EQ(subscriptions, 1);
+}
+
+TEST_F(RegistrationPipeline, Given_RequestInFlight_When_DeviceIsRemoved_Then_ItsSlotIsReleased)
+{
+    // Given
+    pipeline->add({"D1", "D2", "D3", "D4"});
+
+    // When
+    removed.insert("D3");
+    pipeline->remove("D1");
+
+    // Then
+    ASSERT_EQ(published, (std::vector<std::string>{"D1", "D2", "D4"}));
+    ASSERT_EQ(pipeline->inFlight(), 2);
+    ASSERT_EQ(pipeline->pending(), 0);
+}
+
+TEST_F(RegistrationPipeline, Given_RequestWithoutResponse_When_DeadlinePasses_Then_SlotIsFreedAndRequestIsRepublished)
+{
+    // Given
+    pipeline->add({"D1", "D2", "D3"});
+    const auto now = wolkabout::RegistrationPipeline::Clock::now();
+
+    // When
+    pipeline->expire(now);
+    ASSERT_EQ(published.size(), 2);
+
+    pipeline->expire(now + std::chrono::milliseconds{1001});
+
+    // Then
+    ASSERT_EQ(published.size(), 4);
+    ASSERT_EQ(published[2], "D3");
+    ASSERT_TRUE(published[3] == "D1" || published[3] == "D2");
+    ASSERT_EQ(pipeline->inFlight(), 2);
+    ASSERT_EQ(pipeline->pending(), 1);
+}
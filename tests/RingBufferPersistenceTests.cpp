@@ -0,0 +1,143 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/model/Alarm.h"
+#include "core/model/SensorReading.h"
+#include "persistence/RingBufferPersistence.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+const char* RING_BUFFER_FILE = "ringBufferPersistenceTest.bin";
+
+class RingBufferPersistence : public ::testing::Test
+{
+public:
+    void SetUp() override { std::remove(RING_BUFFER_FILE); }
+
+    void TearDown() override { std::remove(RING_BUFFER_FILE); }
+};
+}    // namespace
+
+TEST_F(RingBufferPersistence, Given_PersistedReadings_When_ReadingsAreRemoved_Then_OnlyRemainingReadingsAreReturned)
+{
+    // Given
+    wolkabout::RingBufferPersistence persistence{RING_BUFFER_FILE, 4096};
+
+    for (int i = 0; i < 5; ++i)
+    {
+        persistence.putSensorReading("KEY+REF", std::make_shared<wolkabout::SensorReading>(std::to_string(i), "REF"));
+    }
+
+    // When
+    persistence.removeSensorReadings("KEY+REF", 3);
+
+    // Then
+    const auto readings = persistence.getSensorReadings("KEY+REF", 50);
+    ASSERT_EQ(readings.size(), 2);
+    ASSERT_EQ(readings[0]->getValue(), "3");
+    ASSERT_EQ(readings[1]->getValue(), "4");
+}
+
+TEST_F(RingBufferPersistence, Given_PersistedReadingsAndAlarms_When_PersistenceIsReopened_Then_RecordsAreRecovered)
+{
+    // Given
+    {
+        wolkabout::RingBufferPersistence persistence{RING_BUFFER_FILE, 4096};
+
+        persistence.putSensorReading("KEY+REF1", std::make_shared<wolkabout::SensorReading>("1", "REF1", 100));
+        persistence.putSensorReading(
+          "KEY+REF2", std::make_shared<wolkabout::SensorReading>(std::vector<std::string>{"1", "2"}, "REF2", 200));
+        persistence.putSensorReading("KEY+REF1", std::make_shared<wolkabout::SensorReading>("2", "REF1", 300));
+        persistence.putAlarm("KEY+ALARM", std::make_shared<wolkabout::Alarm>(true, "ALARM", 400));
+
+        persistence.removeSensorReadings("KEY+REF1", 1);
+    }
+
+    // When
+    wolkabout::RingBufferPersistence persistence{RING_BUFFER_FILE, 4096};
+
+    // Then
+    ASSERT_EQ(persistence.getSensorReadingsKeys(), (std::vector<std::string>{"KEY+REF1", "KEY+REF2"}));
+
+    const auto readings = persistence.getSensorReadings("KEY+REF1", 50);
+    ASSERT_EQ(readings.size(), 1);
+    ASSERT_EQ(readings[0]->getValue(), "2");
+    ASSERT_EQ(readings[0]->getRtc(), 300);
+
+    const auto multiValueReadings = persistence.getSensorReadings("KEY+REF2", 50);
+    ASSERT_EQ(multiValueReadings.size(), 1);
+    ASSERT_EQ(multiValueReadings[0]->getValues(), (std::vector<std::string>{"1", "2"}));
+
+    const auto alarms = persistence.getAlarms("KEY+ALARM", 50);
+    ASSERT_EQ(alarms.size(), 1);
+    ASSERT_TRUE(alarms[0]->getActive());
+}
+
+TEST_F(RingBufferPersistence, Given_FullRingBuffer_When_ReadingIsPersisted_Then_OldestReadingsAreDropped)
+{
+    // Given
+    wolkabout::RingBufferPersistence persistence{RING_BUFFER_FILE, 1024};
+
+    // When
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_TRUE(persistence.putSensorReading(
+          "KEY+REF", std::make_shared<wolkabout::SensorReading>(std::to_string(i), "REF")));
+    }
+
+    // Then
+    const auto readings = persistence.getSensorReadings("KEY+REF", 100);
+    ASSERT_FALSE(readings.empty());
+    ASSERT_LT(readings.size(), 100);
+    ASSERT_EQ(readings.back()->getValue(), "99");
+    ASSERT_EQ(readings.front()->getValue(), std::to_string(100 - readings.size()));
+
+    persistence.removeSensorReadings("KEY+REF", readings.size());
+    ASSERT_TRUE(persistence.isEmpty());
+}
+
+TEST_F(RingBufferPersistence, Given_PowerLossDurability_When_WrappedBufferIsReopened_Then_RemainingReadingsAreRecovered)
+{
+    // Given
+    {
+        wolkabout::RingBufferPersistence persistence{RING_BUFFER_FILE, 1024,
+                                                     wolkabout::RingBufferPersistence::Durability::POWER_LOSS};
+
+        for (int i = 0; i < 40; ++i)
+        {
+            ASSERT_TRUE(persistence.putSensorReading(
+              "KEY+REF", std::make_shared<wolkabout::SensorReading>(std::to_string(i), "REF")));
+        }
+
+        persistence.removeSensorReadings("KEY+REF", 1);
+    }
+
+    // When
+    wolkabout::RingBufferPersistence persistence{RING_BUFFER_FILE, 1024};
+
+    // Then
+    const auto readings = persistence.getSensorReadings("KEY+REF", 100);
+    ASSERT_FALSE(readings.empty());
+    ASSERT_EQ(readings.back()->getValue(), "39");
+    ASSERT_EQ(readings.front()->getValue(), std::to_string(40 - readings.size()));
+}
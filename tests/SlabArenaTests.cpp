@@ -0,0 +1,100 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/SlabArena.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Reading
+{
+    Reading(std::string readingValue, unsigned long long int readingRtc)
+    : value{std::move(readingValue)}, rtc{readingRtc}
+    {
+    }
+
+    std::string value;
+    unsigned long long int rtc;
+};
+}    // namespace
+
+TEST(SlabArena, Given_ObjectsAllocatedInSequence_When_ArenaIsDestroyed_Then_ObjectsLieNextToEachOtherAndOutliveIt)
+{
+    // Given
+    std::vector<std::shared_ptr<Reading>> readings;
+
+    {
+        wolkabout::SlabArena arena{8};
+
+        // When
+        for (unsigned long long int i = 0; i < 8; ++i)
+        {
+            readings.push_back(std::allocate_shared<Reading>(wolkabout::SlabAllocator<Reading>{arena},
+                                                             std::to_string(i), i));
+        }
+    }
+
+    // Then
+    const auto stride = reinterpret_cast<std::uintptr_t>(readings[1].get()) -
+                        reinterpret_cast<std::uintptr_t>(readings[0].get());
+    for (std::size_t i = 0; i < readings.size(); ++i)
+    {
+        ASSERT_EQ(reinterpret_cast<std::uintptr_t>(readings[i].get()),
+                  reinterpret_cast<std::uintptr_t>(readings[0].get()) + i * stride);
+        ASSERT_EQ(readings[i]->value, std::to_string(i));
+        ASSERT_EQ(readings[i]->rtc, i);
+    }
+}
+
+TEST(SlabArena, Given_SlabPartiallyReleased_When_MoreObjectsAreAllocated_Then_FreedSlotsAreNotReused)
+{
+    // Given
+    wolkabout::SlabArena arena{4};
+    wolkabout::SlabAllocator<Reading> allocator{arena};
+
+    auto first = std::allocate_shared<Reading>(allocator, "1", 1);
+    auto second = std::allocate_shared<Reading>(allocator, "2", 2);
+    first.reset();
+
+    // When
+    auto third = std::allocate_shared<Reading>(allocator, "3", 3);
+
+    // Then
+    ASSERT_GT(third.get(), second.get());
+    ASSERT_EQ(second->value, "2");
+    ASSERT_EQ(third->value, "3");
+}
+
+TEST(SlabArena, Given_ArenaWithSlotSize_When_LargerObjectIsAllocated_Then_ItIsAllocatedOnHeap)
+{
+    // Given
+    wolkabout::SlabArena arena;
+    const auto reading = std::allocate_shared<Reading>(wolkabout::SlabAllocator<Reading>{arena}, "1", 1);
+
+    // When
+    void* buffer = arena.allocate(4096);
+    static_cast<char*>(buffer)[4095] = 'x';
+
+    // Then
+    ASSERT_EQ(reading->value, "1");
+    wolkabout::SlabArena::deallocate(buffer);
+}
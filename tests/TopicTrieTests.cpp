@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/TopicTrie.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+TEST(TopicTrie, Given_FiltersWithWildcards_When_TopicIsMatched_Then_MostSpecificFilterIsReturned)
+{
+    // Given
+    wolkabout::TopicTrie<std::string> trie;
+    trie.insert("p2d/actuator_set/d/+/r/+", "actuator set");
+    trie.insert("p2d/actuator_set/d/KEY/r/SWITCH", "switch");
+    trie.insert("p2d/configuration_set/#", "configuration set");
+    trie.insert("p2d/#", "any");
+
+    // When
+    const auto actuatorSet = trie.match("p2d/actuator_set/d/OTHER_KEY/r/SLIDER");
+    const auto switchSet = trie.match("p2d/actuator_set/d/KEY/r/SWITCH");
+    const auto configurationSet = trie.match("p2d/configuration_set/d/KEY");
+    const auto tooDeep = trie.match("p2d/actuator_set/d/KEY/r/SWITCH/extra");
+    const auto other = trie.match("d2p/sensor_reading/d/KEY/r/T");
+
+    // Then
+    ASSERT_NE(actuatorSet, nullptr);
+    ASSERT_EQ(*actuatorSet, "actuator set");
+
+    ASSERT_NE(switchSet, nullptr);
+    ASSERT_EQ(*switchSet, "switch");
+
+    ASSERT_NE(configurationSet, nullptr);
+    ASSERT_EQ(*configurationSet, "configuration set");
+
+    ASSERT_NE(tooDeep, nullptr);
+    ASSERT_EQ(*tooDeep, "any");
+
+    ASSERT_EQ(other, nullptr);
+}
+
+TEST(TopicTrie, Given_MultiLevelWildcard_When_ParentTopicIsMatched_Then_FilterMatches)
+{
+    // Given
+    wolkabout::TopicTrie<int> trie;
+    trie.insert("a/#", 1);
+    trie.insert("b/+", 2);
+
+    // Then
+    ASSERT_NE(trie.match("a"), nullptr);
+    ASSERT_NE(trie.match("a/b/c"), nullptr);
+    ASSERT_NE(trie.match("b/"), nullptr);
+    ASSERT_EQ(trie.match("b"), nullptr);
+    ASSERT_EQ(trie.match("b/c/d"), nullptr);
+}
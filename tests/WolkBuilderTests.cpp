@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "AsyncActuatorStatusProvider.h"
+#include "AsyncConfigurationProvider.h"
+#include "AsyncDeviceStatusProvider.h"
+#include "ConfigurationHandlerPerDevice.h"
+#include "ConfigurationProviderPerDevice.h"
+#include "Wolk.h"
+#include "WolkBuilder.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+class AsyncActuatorStatusProvider : public wolkabout::AsyncActuatorStatusProvider
+{
+public:
+    void getActuatorStatus(const std::string&, const std::string&,
+                           std::function<void(wolkabout::ActuatorStatus)> onStatus) override
+    {
+        onStatus(wolkabout::ActuatorStatus("", wolkabout::ActuatorStatus::State::READY));
+    }
+};
+
+class AsyncDeviceStatusProvider : public wolkabout::AsyncDeviceStatusProvider
+{
+public:
+    void getDeviceStatus(const std::string&, std::function<void(wolkabout::DeviceStatus::Status)> onStatus) override
+    {
+        onStatus(wolkabout::DeviceStatus::Status::CONNECTED);
+    }
+};
+
+class AsyncConfigurationProvider : public wolkabout::AsyncConfigurationProvider
+{
+public:
+    void getConfiguration(const std::string&,
+                          std::function<void(std::vector<wolkabout::ConfigurationItem>)> onConfiguration) override
+    {
+        onConfiguration({});
+    }
+};
+
+class ConfigurationProvider : public wolkabout::ConfigurationProviderPerDevice
+{
+public:
+    std::vector<wolkabout::ConfigurationItem> getConfiguration(const std::string&) override { return {}; }
+};
+
+class ConfigurationHandler : public wolkabout::ConfigurationHandlerPerDevice
+{
+public:
+    void handleConfiguration(const std::string&, const std::vector<wolkabout::ConfigurationItem>&) override {}
+};
+
+wolkabout::WolkBuilder asyncStatusBuilder()
+{
+    auto builder = wolkabout::Wolk::newBuilder();
+    builder.actuationHandler([](const std::string&, const std::string&, const std::string&) {})
+      .actuatorStatusProvider(std::make_shared<AsyncActuatorStatusProvider>())
+      .deviceStatusProvider(std::make_shared<AsyncDeviceStatusProvider>());
+    return builder;
+}
+
+void configurationHandlerLambda(const std::string&, const std::vector<wolkabout::ConfigurationItem>&) {}
+
+std::vector<wolkabout::ConfigurationItem> configurationProviderLambda(const std::string&)
+{
+    return {};
+}
+}    // namespace
+
+TEST(WolkBuilder, Given_AsyncStatusProviders_When_BuildIsCalled_Then_WolkIsBuilt)
+{
+    ASSERT_NO_THROW(asyncStatusBuilder().build());
+}
+
+TEST(WolkBuilder, Given_AsyncConfigurationProvider_When_PairedWithEitherHandler_Then_WolkIsBuilt)
+{
+    ASSERT_NO_THROW(asyncStatusBuilder()
+                      .configurationHandler(configurationHandlerLambda)
+                      .configurationProvider(std::make_shared<AsyncConfigurationProvider>())
+                      .build());
+
+    ASSERT_NO_THROW(asyncStatusBuilder()
+                      .configurationHandler(std::make_shared<ConfigurationHandler>())
+                      .configurationProvider(std::make_shared<AsyncConfigurationProvider>())
+                      .build());
+}
+
+TEST(WolkBuilder, Given_AsyncConfigurationProvider_When_NoHandlerIsSet_Then_BuildThrows)
+{
+    ASSERT_THROW(asyncStatusBuilder().configurationProvider(std::make_shared<AsyncConfigurationProvider>()).build(),
+                 std::logic_error);
+}
+
+TEST(WolkBuilder, Given_AsyncProvider_When_ReplacedBySyncProvider_Then_SyncPairingRulesApply)
+{
+    ASSERT_NO_THROW(asyncStatusBuilder()
+                      .configurationHandler(configurationHandlerLambda)
+                      .configurationProvider(std::make_shared<AsyncConfigurationProvider>())
+                      .configurationProvider(configurationProviderLambda)
+                      .build());
+
+    ASSERT_THROW(asyncStatusBuilder()
+                   .configurationHandler(configurationHandlerLambda)
+                   .configurationProvider(std::make_shared<AsyncConfigurationProvider>())
+                   .configurationProvider(std::make_shared<ConfigurationProvider>())
+                   .build(),
+                 std::logic_error);
+}
+
+TEST(WolkBuilder, Given_StatusProvidersMissing_When_BuildIsCalled_Then_BuildThrows)
+{
+    ASSERT_THROW(wolkabout::Wolk::newBuilder()
+                   .actuationHandler([](const std::string&, const std::string&, const std::string&) {})
+                   .deviceStatusProvider(std::make_shared<AsyncDeviceStatusProvider>())
+                   .build(),
+                 std::logic_error);
+
+    ASSERT_THROW(wolkabout::Wolk::newBuilder()
+                   .actuationHandler([](const std::string&, const std::string&, const std::string&) {})
+                   .actuatorStatusProvider(std::make_shared<AsyncActuatorStatusProvider>())
+                   .build(),
+                 std::logic_error);
+}
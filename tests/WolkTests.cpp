@@ -0,0 +1,183 @@
+/*
+ * Copyright 2018 WolkAbout Technology s.r.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "AsyncActuatorStatusProvider.h"
+#include "WolkBuilder.h"
+#include "core/model/DeviceTemplate.h"
+#include "model/Device.h"
+
+#define private public
+#define protected public
+#include "Wolk.h"
+#undef private
+#undef protected
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+const std::string ACTUATOR_REFERENCE = "SW";
+
+wolkabout::Device makeDevice(const std::string& deviceKey)
+{
+    wolkabout::ActuatorTemplate actuator{"Switch", ACTUATOR_REFERENCE, wolkabout::DataType::STRING, ""};
+    wolkabout::DeviceTemplate deviceTemplate{{}, {}, {}, {actuator}, "DFU"};
+    return wolkabout::Device{"NAME_" + deviceKey, deviceKey, deviceTemplate};
+}
+
+// records handler and provider calls per device, as they are made
+class CallLog
+{
+public:
+    void add(const std::string& deviceKey, const std::string& call)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_calls[deviceKey].push_back(call);
+        ++m_count;
+        m_condition.notify_all();
+    }
+
+    bool waitFor(std::size_t count)
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        return m_condition.wait_for(lock, std::chrono::seconds{10}, [&] { return m_count >= count; });
+    }
+
+    std::vector<std::string> calls(const std::string& deviceKey)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return m_calls[deviceKey];
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::map<std::string, std::vector<std::string>> m_calls;
+    std::size_t m_count = 0;
+};
+
+// keeps status callbacks, so that test decides when they are completed
+class DeferredActuatorStatusProvider : public wolkabout::AsyncActuatorStatusProvider
+{
+public:
+    void getActuatorStatus(const std::string&, const std::string&,
+                           std::function<void(wolkabout::ActuatorStatus)> onStatus) override
+    {
+        m_requested.set_value(onStatus);
+    }
+
+    std::function<void(wolkabout::ActuatorStatus)> waitForRequest()
+    {
+        auto requested = m_requested.get_future();
+        return requested.wait_for(std::chrono::seconds{10}) == std::future_status::ready ? requested.get() : nullptr;
+    }
+
+private:
+    std::promise<std::function<void(wolkabout::ActuatorStatus)>> m_requested;
+};
+}    // namespace
+
+TEST(Wolk, Given_HandlerWorkers_When_CommandsForManyDevicesAreHandled_Then_CallsOfEachDeviceStayInOrder)
+{
+    // Given
+    const std::size_t devices = 8;
+    const std::size_t commandsPerDevice = 50;
+
+    CallLog log;
+    auto wolk = wolkabout::Wolk::newBuilder()
+                  .actuationHandler([&](const std::string& deviceKey, const std::string&, const std::string& value) {
+                      log.add(deviceKey, "actuation " + value);
+                  })
+                  .actuatorStatusProvider([&](const std::string& deviceKey, const std::string& reference) {
+                      log.add(deviceKey, "actuator status " + reference);
+                      return wolkabout::ActuatorStatus("", wolkabout::ActuatorStatus::State::READY);
+                  })
+                  .deviceStatusProvider([&](const std::string& deviceKey) {
+                      log.add(deviceKey, "device status");
+                      return wolkabout::DeviceStatus::Status::CONNECTED;
+                  })
+                  .withHandlerWorkers(4)
+                  .build();
+
+    for (std::size_t i = 0; i < devices; ++i)
+    {
+        wolk->addDevice(makeDevice("DEVICE_KEY" + std::to_string(i)));
+    }
+
+    // When
+    for (std::size_t command = 0; command < commandsPerDevice; ++command)
+    {
+        for (std::size_t i = 0; i < devices; ++i)
+        {
+            const auto deviceKey = "DEVICE_KEY" + std::to_string(i);
+            wolk->handleActuatorSetCommand(deviceKey, ACTUATOR_REFERENCE, std::to_string(command), nullptr);
+            wolk->handleDeviceStatusRequest(deviceKey);
+        }
+    }
+
+    // Then
+    ASSERT_TRUE(log.waitFor(devices * commandsPerDevice * 3));
+
+    std::vector<std::string> expected;
+    for (std::size_t command = 0; command < commandsPerDevice; ++command)
+    {
+        expected.push_back("actuation " + std::to_string(command));
+        expected.push_back("actuator status " + ACTUATOR_REFERENCE);
+        expected.push_back("device status");
+    }
+
+    for (std::size_t i = 0; i < devices; ++i)
+    {
+        ASSERT_EQ(log.calls("DEVICE_KEY" + std::to_string(i)), expected);
+    }
+}
+
+TEST(Wolk, Given_PendingAsyncActuatorStatus_When_WolkIsDestroyed_Then_LateStatusIsDropped)
+{
+    // Given
+    auto provider = std::make_shared<DeferredActuatorStatusProvider>();
+    auto wolk = wolkabout::Wolk::newBuilder()
+                  .actuationHandler([](const std::string&, const std::string&, const std::string&) {})
+                  .actuatorStatusProvider(provider)
+                  .deviceStatusProvider([](const std::string&) { return wolkabout::DeviceStatus::Status::CONNECTED; })
+                  .withHandlerWorkers(2)
+                  .build();
+
+    wolk->addDevice(makeDevice("DEVICE_KEY"));
+    wolk->handleActuatorGetCommand("DEVICE_KEY", ACTUATOR_REFERENCE);
+
+    const auto onStatus = provider->waitForRequest();
+    ASSERT_NE(onStatus, nullptr);
+    ASSERT_TRUE(wolk->m_providerCompletions.isOpen());
+
+    // When
+    wolk.reset();
+
+    // Then
+    // callback outlives Wolk, and must neither touch its services nor queue to its stopped executor
+    ASSERT_NO_THROW(onStatus(wolkabout::ActuatorStatus("ON", wolkabout::ActuatorStatus::State::READY)));
+}